@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/portability.h>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+FATAL_DIAGNOSTIC_PUSH
+FATAL_GCC_DIAGNOSTIC_IGNORED_SHADOW_IF_BROKEN
+
+namespace fatal {
+
+/////////////////////
+// monotonic_arena //
+/////////////////////
+
+/**
+ * A memory arena that hands out memory by bumping a pointer inside blocks
+ * obtained from the global heap.
+ *
+ * Individual allocations are never freed. Instead, everything allocated
+ * from the arena is released at once by `reset()` or by the destructor.
+ * This makes it a good fit for per-request data, where a burst of small
+ * allocations shares the same lifetime.
+ *
+ * Allocations larger than the block size get a block of their own.
+ *
+ * Example:
+ *
+ *  monotonic_arena arena;
+ *
+ *  for (auto const &request: requests) {
+ *    rope<8, arena_allocator<char>> response{arena_allocator<char>(arena)};
+ *    build_response(response, request);
+ *    send(response);
+ *
+ *    // `response` is gone, its memory can be reused
+ *    arena.reset();
+ *  }
+ */
+struct monotonic_arena {
+  using size_type = std::size_t;
+
+  /**
+   * The default size, in bytes, of the blocks allocated by the arena.
+   */
+  using default_block_size = std::integral_constant<size_type, 4096>;
+
+  explicit monotonic_arena(size_type block_size = default_block_size::value):
+    block_size_(block_size)
+  {
+    assert(block_size_ > 0);
+  }
+
+  monotonic_arena(monotonic_arena const &) = delete;
+  monotonic_arena(monotonic_arena &&) = delete;
+
+  ~monotonic_arena() { release(head_); }
+
+  /**
+   * Returns `size` bytes of memory aligned to `alignment`, which must be a
+   * power of two no greater than `alignof(std::max_align_t)`.
+   *
+   * Throws `std::bad_alloc` if a new block is needed and can't be allocated.
+   */
+  void *allocate(size_type size, size_type alignment) {
+    assert(alignment && !(alignment & (alignment - 1)));
+    assert(alignment <= alignof(std::max_align_t));
+
+    auto const padding = static_cast<size_type>(
+      (alignment - reinterpret_cast<std::uintptr_t>(cursor_)) & (alignment - 1)
+    );
+
+    if (!cursor_ || static_cast<size_type>(end_ - cursor_) < size + padding) {
+      grow(size);
+      return bump(size);
+    }
+
+    cursor_ += padding;
+    return bump(size);
+  }
+
+  /**
+   * Releases all memory allocated from this arena.
+   *
+   * A single block is kept around so the next round of allocations
+   * doesn't need to go back to the heap.
+   */
+  void reset() {
+    if (!head_) {
+      return;
+    }
+
+    auto const next = head_->next;
+    head_->next = nullptr;
+    release(next);
+
+    cursor_ = head_->data();
+    end_ = cursor_ + head_->size;
+  }
+
+  /**
+   * Returns the number of blocks currently held by this arena.
+   */
+  size_type blocks() const {
+    size_type result = 0;
+
+    for (auto i = head_; i; i = i->next) {
+      ++result;
+    }
+
+    return result;
+  }
+
+  /**
+   * Returns the block size given at construction.
+   */
+  size_type block_size() const { return block_size_; }
+
+private:
+  struct alignas(std::max_align_t) block {
+    char *data() { return reinterpret_cast<char *>(this + 1); }
+
+    block *next;
+    size_type size;
+  };
+
+  // makes a new block, with room for at least `size` bytes, the current one //
+  void grow(size_type size) {
+    auto const capacity = size > block_size_ ? size : block_size_;
+
+    auto b = static_cast<block *>(::operator new(sizeof(block) + capacity));
+    b->size = capacity;
+
+    // the current block is always the head
+    b->next = head_;
+    head_ = b;
+
+    cursor_ = b->data();
+    end_ = cursor_ + capacity;
+  }
+
+  char *bump(size_type size) {
+    auto const result = cursor_;
+    cursor_ += size;
+    assert(cursor_ <= end_);
+    return result;
+  }
+
+  static void release(block *b) {
+    while (b) {
+      auto const next = b->next;
+      ::operator delete(b);
+      b = next;
+    }
+  }
+
+  size_type const block_size_;
+  block *head_ = nullptr;
+  char *cursor_ = nullptr;
+  char *end_ = nullptr;
+};
+
+/////////////////////
+// arena_allocator //
+/////////////////////
+
+/**
+ * An STL-style allocator that gets its memory from a `monotonic_arena`.
+ *
+ * Deallocation is a no-op: memory is only reclaimed when the arena
+ * is reset or destroyed, so containers using this allocator must not
+ * outlive the arena's next reset.
+ *
+ * Two allocators compare equal when they use the same arena.
+ */
+template <typename T>
+struct arena_allocator {
+  using value_type = T;
+  using size_type = std::size_t;
+
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  explicit arena_allocator(monotonic_arena &arena):
+    arena_(std::addressof(arena))
+  {}
+
+  template <typename U>
+  arena_allocator(arena_allocator<U> const &rhs):
+    arena_(rhs.arena_)
+  {}
+
+  T *allocate(size_type n) {
+    return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *, size_type) {}
+
+  monotonic_arena &arena() const { return *arena_; }
+
+  template <typename U>
+  bool operator ==(arena_allocator<U> const &rhs) const {
+    return arena_ == rhs.arena_;
+  }
+
+  template <typename U>
+  bool operator !=(arena_allocator<U> const &rhs) const {
+    return arena_ != rhs.arena_;
+  }
+
+private:
+  template <typename> friend struct arena_allocator;
+
+  monotonic_arena *arena_;
+};
+
+} // namespace fatal {
+
+FATAL_DIAGNOSTIC_POP
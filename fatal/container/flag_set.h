@@ -9,17 +9,22 @@
 #pragma once
 
 #include <fatal/math/numerics.h>
+#include <fatal/type/array.h>
 #include <fatal/type/bitwise.h>
 #include <fatal/type/conditional.h>
 #include <fatal/type/find.h>
 #include <fatal/type/foreach.h>
+#include <fatal/type/get_type.h>
 #include <fatal/type/list.h>
 #include <fatal/type/logical.h>
 #include <fatal/type/traits.h>
+#include <fatal/type/trie.h>
 
+#include <iterator>
 #include <type_traits>
 
 #include <cassert>
+#include <cstddef>
 
 namespace fatal {
 
@@ -108,6 +113,45 @@ private:
     }
   };
 
+  // the flag matching the longest prefix of a name //
+  struct parse_visitor {
+    template <typename UFlag>
+    void operator ()(
+      tag<UFlag>,
+      std::size_t consumed,
+      flags_type &mask,
+      std::size_t &size
+    ) const {
+      mask = mask_for<false, UFlag>::value;
+      size = consumed;
+    }
+  };
+
+  template <typename Filter>
+  struct serialize_visitor {
+    template <typename UFlag, std::size_t Index, typename String>
+    void operator ()(
+      indexed<UFlag, Index>,
+      flags_type flags,
+      String &out,
+      char delimiter,
+      bool &first
+    ) const {
+      using name = typename Filter::template apply<UFlag>;
+
+      if (!(flags & (flags_type(1) << Index))) {
+        return;
+      }
+
+      if (!first) {
+        out.push_back(delimiter);
+      }
+
+      out.append(z_data<name>(), size<name>::value);
+      first = false;
+    }
+  };
+
 public:
   /**
    * Default constructor that start with all flags unset.
@@ -762,6 +806,121 @@ public:
     return flags_ == mask_for<false, UFlags...>::value;
   }
 
+  ///////////
+  // parse //
+  ///////////
+
+  /**
+   * Parses the names of flags separated by `delimiter`, like
+   * `"read|write|append"`, from the random access range `[begin, end)`,
+   * setting each named flag in addition to what's already set.
+   *
+   * The name of each flag is the compile-time string given by `Filter`,
+   * which defaults to the flag's `name` member (see `FATAL_S`). The input is
+   * walked once, each name being matched through `trie_find_longest_prefix`
+   * without allocating. Empty names, like the one in `"read||write"`, are
+   * skipped. Names must not contain the delimiter.
+   *
+   * Returns the offset of the first unknown name, in which case this set is
+   * left unchanged. Returns the size of the input otherwise.
+   *
+   * Example:
+   *
+   *  struct read { FATAL_S(name, "read"); };
+   *  struct write { FATAL_S(name, "write"); };
+   *  struct append { FATAL_S(name, "append"); };
+   *
+   *  flag_set<read, write, append> s;
+   *  std::string config("read|append");
+   *
+   *  // returns `11` and sets `read` and `append`
+   *  s.parse(config.begin(), config.end());
+   *
+   *  std::string bad("write|exec|read");
+   *
+   *  // returns `6`, the offset of `"exec"`, leaving `s` unchanged
+   *  s.parse(bad.begin(), bad.end());
+   */
+  template <typename Filter = get_type::name, typename Iterator>
+  std::size_t parse(Iterator begin, Iterator end, char delimiter = '|') {
+    auto const size = static_cast<std::size_t>(std::distance(begin, end));
+    flags_type parsed(0);
+
+    for (std::size_t offset = 0; offset < size; ++offset) {
+      if (begin[offset] == delimiter) {
+        continue;
+      }
+
+      flags_type mask(0);
+      std::size_t consumed = 0;
+
+      if (
+        !trie_find_longest_prefix<tag_list, Filter>(
+          begin + offset, end, parse_visitor(), mask, consumed
+        )
+        || (
+          offset + consumed < size && begin[offset + consumed] != delimiter
+        )
+        || !consumed
+      ) {
+        return offset;
+      }
+
+      parsed |= mask;
+      offset += consumed;
+    }
+
+    flags_ |= parsed;
+    assert((flags_ & range_mask::value) == flags_);
+    return size;
+  }
+
+  /**
+   * Equivalent to `parse(std::begin(s), std::end(s), delimiter)`.
+   *
+   * Example:
+   *
+   *  flag_set<read, write, append> s;
+   *
+   *  // returns `10` and sets `read` and `write`
+   *  s.parse(std::string("read|write"));
+   */
+  template <typename Filter = get_type::name, typename String>
+  std::size_t parse(String const &s, char delimiter = '|') {
+    return parse<Filter>(std::begin(s), std::end(s), delimiter);
+  }
+
+  ///////////////
+  // serialize //
+  ///////////////
+
+  /**
+   * Appends the names of the flags that are set to `out`, in the order the
+   * flags are listed in this `flag_set`, separated by `delimiter`. This is
+   * the inverse of `parse()`.
+   *
+   * Names are given by `Filter`, as in `parse()`. `out` can be any string
+   * offering `push_back(char)` and `append(char const *, std::size_t)`.
+   *
+   * Returns `out`.
+   *
+   * Example:
+   *
+   *  auto s = flag_set<read, write, append>().set<append, read>();
+   *  std::string out;
+   *
+   *  // `out` becomes `"read|append"`
+   *  s.serialize(out);
+   */
+  template <typename Filter = get_type::name, typename String>
+  String &serialize(String &out, char delimiter = '|') const {
+    bool first = true;
+    foreach<tag_list>(
+      serialize_visitor<Filter>(), flags_, out, delimiter, first
+    );
+    return out;
+  }
+
   ////////////////
   // operator = //
   ////////////////
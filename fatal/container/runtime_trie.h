@@ -0,0 +1,374 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/functional/no_op.h>
+#include <fatal/portability.h>
+
+#include <fatal/type/impl/trie.h>
+
+#include <algorithm>
+#include <deque>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+#include <cstring>
+
+namespace fatal {
+
+/**
+ * A prefix tree of strings only known at runtime, like keys read from a
+ * configuration file, offering the same lookup interface as `trie_find`.
+ *
+ * The trie has the same shape as the one built by `trie_find` at compile
+ * time: each node holds the compressed edge leading to it, whether a key
+ * ends at it, and the contiguous range of its children, sorted by their
+ * first character. The nodes are laid out breadth first, followed by the
+ * first character of each node and by the edges themselves, all in a single
+ * cache line aligned allocation.
+ *
+ * Keys are identified by their position in the range given at construction.
+ * When the same key is given more than once, its first position is used.
+ *
+ * Example:
+ *
+ *  std::vector<std::string> keys{"GET", "POST", "PUT"};
+ *  runtime_trie trie(keys.begin(), keys.end());
+ *
+ *  std::string s("PUT");
+ *
+ *  // returns `true` after calling `visitor(2)`
+ *  trie.find(s.begin(), s.end(), visitor);
+ */
+class runtime_trie {
+  using node_type = i_t::o;
+
+  // alignment of the allocation holding the trie //
+  using alignment = std::integral_constant<std::size_t, 64>;
+
+public:
+  using size_type = std::size_t;
+
+  template <typename Iterator>
+  runtime_trie(Iterator begin, Iterator end) {
+    build(std::vector<std::string>(begin, end));
+  }
+
+  runtime_trie(std::initializer_list<std::string> keys) {
+    build(std::vector<std::string>(keys));
+  }
+
+  runtime_trie(runtime_trie const &rhs):
+    nodes_(rhs.nodes_),
+    size_(rhs.size_),
+    bytes_(rhs.bytes_)
+  {
+    if (!rhs.node_) {
+      return;
+    }
+
+    buffer_.reset(new char[bytes_ + alignment::value - 1]);
+    auto const data = align(buffer_.get());
+    std::memcpy(data, rhs.data(), bytes_);
+    layout(data);
+
+    // edges point into the allocation they were built in //
+    for (size_type i = 0; i < nodes_; ++i) {
+      node_[i].edge = edges_ + (node_[i].edge - rhs.edges_);
+    }
+  }
+
+  runtime_trie(runtime_trie &&rhs) noexcept:
+    nodes_(rhs.nodes_),
+    size_(rhs.size_),
+    bytes_(rhs.bytes_),
+    buffer_(std::move(rhs.buffer_)),
+    node_(rhs.node_),
+    key_(rhs.key_),
+    head_(rhs.head_),
+    edges_(rhs.edges_)
+  {
+    rhs.nodes_ = 0;
+    rhs.size_ = 0;
+    rhs.bytes_ = 0;
+    rhs.node_ = nullptr;
+  }
+
+  runtime_trie &operator =(runtime_trie const &rhs) {
+    if (this != std::addressof(rhs)) {
+      *this = runtime_trie(rhs);
+    }
+
+    return *this;
+  }
+
+  runtime_trie &operator =(runtime_trie &&rhs) noexcept {
+    if (this != std::addressof(rhs)) {
+      nodes_ = rhs.nodes_;
+      size_ = rhs.size_;
+      bytes_ = rhs.bytes_;
+      buffer_ = std::move(rhs.buffer_);
+      node_ = rhs.node_;
+      key_ = rhs.key_;
+      head_ = rhs.head_;
+      edges_ = rhs.edges_;
+
+      rhs.nodes_ = 0;
+      rhs.size_ = 0;
+      rhs.bytes_ = 0;
+      rhs.node_ = nullptr;
+    }
+
+    return *this;
+  }
+
+  /**
+   * Looks up the string `[begin, end)`. When found, calls
+   * `visitor(index, args...)`, where `index` is the position of the key
+   * in the range given at construction, and returns `true`. Returns `false`
+   * otherwise.
+   */
+  template <
+    typename Begin,
+    typename End,
+    typename Visitor,
+    typename... VArgs
+  >
+  bool find(Begin begin, End end, Visitor &&visitor, VArgs &&...args) const {
+    if (!node_) {
+      return false;
+    }
+
+    auto size = static_cast<size_type>(std::distance(begin, end));
+
+    for (auto node = node_;;) {
+      if (size < node->length) {
+        return false;
+      }
+
+      for (auto i = node->edge, e = i + node->length; i != e; ++i, ++begin) {
+        if (*i != *begin) {
+          return false;
+        }
+      }
+
+      size -= node->length;
+
+      if (!size) {
+        if (!node->terminal) {
+          return false;
+        }
+
+        visitor(key_[node - node_], static_cast<VArgs &&>(args)...);
+        return true;
+      }
+
+      // children are few enough that a linear scan beats a binary search //
+      auto const first = head_ + node->first;
+      auto const last = first + node->count;
+      auto const character = static_cast<unsigned char>(*begin);
+      auto const child = std::find(first, last, character);
+
+      if (child == last) {
+        return false;
+      }
+
+      node = node_ + (child - head_);
+      ++begin;
+      --size;
+    }
+  }
+
+  template <typename Begin, typename End>
+  bool find(Begin begin, End end) const {
+    return find(std::move(begin), std::move(end), fn::no_op());
+  }
+
+  // number of distinct keys //
+  size_type size() const { return size_; }
+  bool empty() const { return !size_; }
+
+private:
+  static char *align(char *data) {
+    auto const address = reinterpret_cast<std::uintptr_t>(data);
+    return data + (alignment::value - address % alignment::value)
+      % alignment::value;
+  }
+
+  template <typename T>
+  static size_type pad(size_type offset) {
+    return (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+  }
+
+  char const *data() const {
+    return reinterpret_cast<char const *>(node_);
+  }
+
+  // offsets of each section in the allocation //
+  size_type key_offset() const {
+    return pad<size_type>(nodes_ * sizeof(node_type));
+  }
+
+  size_type head_offset() const {
+    return key_offset() + nodes_ * sizeof(size_type);
+  }
+
+  size_type edges_offset() const {
+    return head_offset() + nodes_;
+  }
+
+  void layout(char *data) {
+    node_ = reinterpret_cast<node_type *>(data);
+    key_ = reinterpret_cast<size_type *>(data + key_offset());
+    head_ = reinterpret_cast<unsigned char *>(data + head_offset());
+    edges_ = data + edges_offset();
+  }
+
+  // a range of sorted keys sharing a common prefix of `depth` characters,
+  // to be placed at `slot` //
+  struct range {
+    size_type begin;
+    size_type end;
+    size_type depth;
+    size_type slot;
+  };
+
+  void build(std::vector<std::string> keys) {
+    // sorted distinct keys, remembering their first position //
+    std::vector<size_type> order(keys.size());
+    std::iota(order.begin(), order.end(), size_type(0));
+    std::stable_sort(
+      order.begin(),
+      order.end(),
+      [&keys](size_type lhs, size_type rhs) { return keys[lhs] < keys[rhs]; }
+    );
+    order.erase(
+      std::unique(
+        order.begin(),
+        order.end(),
+        [&keys](size_type lhs, size_type rhs) {
+          return keys[lhs] == keys[rhs];
+        }
+      ),
+      order.end()
+    );
+
+    size_ = order.size();
+
+    // the keys are stored back to back, and edges point into them //
+    std::vector<size_type> offset(order.size());
+    size_type length = 0;
+    for (size_type i = 0; i < order.size(); ++i) {
+      offset[i] = length;
+      length += keys[order[i]].size();
+    }
+
+    // every branching node adds at most one node that isn't a key //
+    std::vector<node_type> node;
+    std::vector<size_type> edge;
+    std::vector<size_type> key;
+    std::vector<unsigned char> head;
+    node.reserve(2 * order.size() + 1);
+    edge.reserve(2 * order.size() + 1);
+    key.reserve(2 * order.size() + 1);
+    head.reserve(2 * order.size() + 1);
+
+    node.push_back(node_type{nullptr, 0, 0, 0, false});
+    edge.push_back(0);
+    key.push_back(0);
+    head.push_back(0);
+
+    std::deque<range> queue;
+    if (!order.empty()) {
+      queue.push_back(range{0, order.size(), 0, 0});
+    }
+
+    while (!queue.empty()) {
+      auto const current = queue.front();
+      queue.pop_front();
+
+      auto const &lo = keys[order[current.begin]];
+      auto const &hi = keys[order[current.end - 1]];
+
+      // the keys are sorted, so the first and last share the common prefix
+      // of the whole range //
+      auto const common = static_cast<size_type>(
+        std::mismatch(
+          lo.begin() + current.depth,
+          lo.begin() + std::min(lo.size(), hi.size()),
+          hi.begin() + current.depth
+        ).first - lo.begin()
+      );
+
+      auto &entry = node[current.slot];
+      edge[current.slot] = offset[current.begin] + current.depth;
+      entry.length = common - current.depth;
+      entry.terminal = lo.size() == common;
+      key[current.slot] = order[current.begin];
+
+      // groups the remaining keys by their next character //
+      auto i = current.begin + entry.terminal;
+      entry.first = node.size();
+      entry.count = 0;
+
+      while (i != current.end) {
+        auto const character = keys[order[i]][common];
+        auto j = i + 1;
+        while (j != current.end && keys[order[j]][common] == character) {
+          ++j;
+        }
+
+        queue.push_back(range{i, j, common + 1, node.size()});
+        node.push_back(node_type{nullptr, 0, 0, 0, false});
+        edge.push_back(0);
+        key.push_back(0);
+        head.push_back(static_cast<unsigned char>(character));
+        ++entry.count;
+
+        i = j;
+      }
+    }
+
+    nodes_ = node.size();
+    bytes_ = edges_offset() + length;
+    buffer_.reset(new char[bytes_ + alignment::value - 1]);
+    layout(align(buffer_.get()));
+
+    for (size_type i = 0; i < order.size(); ++i) {
+      auto const &s = keys[order[i]];
+      std::copy(s.begin(), s.end(), edges_ + offset[i]);
+    }
+
+    for (size_type i = 0; i < nodes_; ++i) {
+      node[i].edge = edges_ + edge[i];
+    }
+
+    std::copy(node.begin(), node.end(), node_);
+    std::copy(key.begin(), key.end(), key_);
+    std::copy(head.begin(), head.end(), head_);
+  }
+
+  size_type nodes_ = 0;
+  size_type size_ = 0;
+  size_type bytes_ = 0;
+  std::unique_ptr<char[]> buffer_;
+
+  node_type *node_ = nullptr;
+  size_type *key_ = nullptr;
+  unsigned char *head_ = nullptr;
+  char *edges_ = nullptr;
+};
+
+} // namespace fatal {
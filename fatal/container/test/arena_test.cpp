@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/container/arena.h>
+
+#include <fatal/test/driver.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace fatal {
+
+bool is_aligned(void const *p, std::size_t alignment) {
+  return !(reinterpret_cast<std::uintptr_t>(p) % alignment);
+}
+
+FATAL_TEST(monotonic_arena, empty) {
+  monotonic_arena arena;
+  FATAL_EXPECT_EQ(0, arena.blocks());
+  FATAL_EXPECT_EQ(
+    monotonic_arena::default_block_size::value,
+    arena.block_size()
+  );
+
+  arena.reset();
+  FATAL_EXPECT_EQ(0, arena.blocks());
+}
+
+FATAL_TEST(monotonic_arena, allocate) {
+  monotonic_arena arena(64);
+
+  auto const a = static_cast<char *>(arena.allocate(10, 1));
+  FATAL_EXPECT_EQ(1, arena.blocks());
+
+  auto const b = static_cast<char *>(arena.allocate(10, 1));
+  FATAL_EXPECT_EQ(1, arena.blocks());
+  FATAL_EXPECT_TRUE(a + 10 == b);
+
+  auto const c = arena.allocate(4, 8);
+  FATAL_EXPECT_EQ(1, arena.blocks());
+  FATAL_EXPECT_TRUE(is_aligned(c, 8));
+
+  arena.allocate(64, 1);
+  FATAL_EXPECT_EQ(2, arena.blocks());
+}
+
+FATAL_TEST(monotonic_arena, alignment) {
+  monotonic_arena arena(128);
+
+  for (std::size_t i = 0; i < 100; ++i) {
+    arena.allocate(i % 7, 1);
+
+    for (std::size_t alignment = 1;
+      alignment <= alignof(std::max_align_t);
+      alignment *= 2
+    ) {
+      FATAL_EXPECT_TRUE(is_aligned(arena.allocate(1, alignment), alignment));
+    }
+  }
+}
+
+FATAL_TEST(monotonic_arena, large_allocation) {
+  monotonic_arena arena(16);
+
+  auto const p = static_cast<char *>(arena.allocate(1000, 1));
+  FATAL_EXPECT_EQ(1, arena.blocks());
+
+  // the whole allocation is usable
+  std::fill(p, p + 1000, 'x');
+  FATAL_EXPECT_EQ('x', p[999]);
+}
+
+FATAL_TEST(monotonic_arena, reset) {
+  monotonic_arena arena(32);
+
+  for (std::size_t i = 0; i < 10; ++i) {
+    arena.allocate(30, 1);
+  }
+
+  FATAL_EXPECT_EQ(10, arena.blocks());
+
+  arena.reset();
+  FATAL_EXPECT_EQ(1, arena.blocks());
+
+  // the kept block is reused
+  arena.allocate(30, 1);
+  FATAL_EXPECT_EQ(1, arena.blocks());
+}
+
+FATAL_TEST(arena_allocator, equality) {
+  monotonic_arena a;
+  monotonic_arena b;
+
+  arena_allocator<char> x(a);
+  arena_allocator<int> y(a);
+  arena_allocator<char> z(b);
+
+  FATAL_EXPECT_TRUE(x == y);
+  FATAL_EXPECT_FALSE(x != y);
+  FATAL_EXPECT_FALSE(x == z);
+  FATAL_EXPECT_TRUE(x != z);
+  FATAL_EXPECT_TRUE(std::addressof(y.arena()) == std::addressof(a));
+}
+
+FATAL_TEST(arena_allocator, containers) {
+  monotonic_arena arena(256);
+
+  using string = std::basic_string<
+    char, std::char_traits<char>, arena_allocator<char>
+  >;
+
+  std::vector<string, arena_allocator<string>> v{
+    arena_allocator<string>(arena)
+  };
+
+  for (std::size_t i = 0; i < 100; ++i) {
+    v.emplace_back(
+      "a string that doesn't fit the small string buffer",
+      arena_allocator<char>(arena)
+    );
+  }
+
+  FATAL_EXPECT_EQ(100, v.size());
+  FATAL_EXPECT_EQ(
+    "a string that doesn't fit the small string buffer",
+    std::string(v.back().data(), v.back().size())
+  );
+  FATAL_EXPECT_LT(1, arena.blocks());
+
+  v.clear();
+  v.shrink_to_fit();
+  arena.reset();
+  FATAL_EXPECT_EQ(1, arena.blocks());
+}
+
+} // namespace fatal {
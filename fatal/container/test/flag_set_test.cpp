@@ -11,6 +11,7 @@
 
 #include <fatal/test/driver.h>
 
+#include <string>
 #include <type_traits>
 
 namespace fatal {
@@ -1348,4 +1349,98 @@ FATAL_TEST(flag_set, clear) {
 # undef TEST_CLEAR
 }
 
+///////////////////////
+// parse / serialize //
+///////////////////////
+
+struct read_flag { FATAL_S(name, "read"); FATAL_S(alias, "r"); };
+struct write_flag { FATAL_S(name, "write"); FATAL_S(alias, "w"); };
+struct write_all_flag { FATAL_S(name, "writeall"); FATAL_S(alias, "W"); };
+struct append_flag { FATAL_S(name, "append"); FATAL_S(alias, "a"); };
+
+FATAL_GET_TYPE(get_alias, alias);
+
+using fio = flag_set<read_flag, write_flag, write_all_flag, append_flag>;
+
+FATAL_TEST(flag_set, parse) {
+  auto parse = [](std::string const &s, std::size_t expected, char d = '|') {
+    fio flags;
+    FATAL_EXPECT_EQ(expected, flags.parse(s, d));
+    return flags.get();
+  };
+
+  FATAL_EXPECT_EQ(0b0000, parse("", 0));
+  FATAL_EXPECT_EQ(0b0001, parse("read", 4));
+  FATAL_EXPECT_EQ(0b1011, parse("read|write|append", 17));
+  FATAL_EXPECT_EQ(0b1011, parse("append|write|read", 17));
+  FATAL_EXPECT_EQ(0b0100, parse("writeall", 8));
+  FATAL_EXPECT_EQ(0b0110, parse("writeall|write", 14));
+  FATAL_EXPECT_EQ(0b0110, parse("write|writeall", 14));
+  FATAL_EXPECT_EQ(0b0001, parse("read|read", 9));
+  FATAL_EXPECT_EQ(0b1001, parse("read||append|", 13));
+  FATAL_EXPECT_EQ(0b0000, parse("|", 1));
+  FATAL_EXPECT_EQ(0b1001, parse("read,append", 11, ','));
+
+  // unknown names leave the set unchanged //
+  FATAL_EXPECT_EQ(0b0000, parse("exec", 0));
+  FATAL_EXPECT_EQ(0b0000, parse("read|exec|write", 5));
+  FATAL_EXPECT_EQ(0b0000, parse("read|writ", 5));
+  FATAL_EXPECT_EQ(0b0000, parse("read|writeal|append", 5));
+  FATAL_EXPECT_EQ(0b0000, parse("read|writealls", 5));
+  FATAL_EXPECT_EQ(0b0000, parse("read|append|readx", 12));
+  FATAL_EXPECT_EQ(0b0000, parse("read|append", 0, ','));
+
+  auto flags = fio().set<append_flag>();
+  std::string const bad("read|exec");
+  FATAL_EXPECT_EQ(5, flags.parse(bad.begin(), bad.end()));
+  FATAL_EXPECT_EQ(0b1000, flags.get());
+
+  // flags are set in addition to what's already set //
+  std::string const good("read");
+  FATAL_EXPECT_EQ(4, flags.parse(good.data(), good.data() + good.size()));
+  FATAL_EXPECT_EQ(0b1001, flags.get());
+
+  FATAL_EXPECT_EQ(4, flags.parse<get_alias>(std::string("w|W|x")));
+  FATAL_EXPECT_EQ(0b1001, flags.get());
+  FATAL_EXPECT_EQ(5, flags.parse<get_alias>(std::string("w|W|r")));
+  FATAL_EXPECT_EQ(0b1111, flags.get());
+}
+
+FATAL_TEST(flag_set, serialize) {
+  auto serialize = [](fio const &flags, char d = '|') {
+    std::string out;
+    FATAL_EXPECT_EQ(&out, &flags.serialize(out, d));
+    return out;
+  };
+
+  FATAL_EXPECT_EQ("", serialize(fio()));
+  FATAL_EXPECT_EQ("read", serialize(fio().set<read_flag>()));
+  FATAL_EXPECT_EQ(
+    "read|write|append",
+    serialize(fio().set<append_flag, write_flag, read_flag>())
+  );
+  FATAL_EXPECT_EQ(
+    "write,writeall",
+    serialize(fio().set<write_all_flag, write_flag>(), ',')
+  );
+
+  std::string out("flags: ");
+  fio().set<read_flag, append_flag>().serialize<get_alias>(out);
+  FATAL_EXPECT_EQ("flags: r|a", out);
+
+  // round trip //
+  for (unsigned i = 0; i < 16; ++i) {
+    fio flags;
+    flags.set_if<read_flag>(i & 1)
+      .set_if<write_flag>(i & 2)
+      .set_if<write_all_flag>(i & 4)
+      .set_if<append_flag>(i & 8);
+
+    auto const s = serialize(flags);
+    fio parsed;
+    FATAL_EXPECT_EQ(s.size(), parsed.parse(s));
+    FATAL_EXPECT_EQ(i, parsed.get());
+  }
+}
+
 } // namespace fatal {
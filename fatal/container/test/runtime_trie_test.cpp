@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/container/runtime_trie.h>
+
+#include <fatal/type/array.h>
+#include <fatal/type/list.h>
+#include <fatal/type/sequence.h>
+
+#include <fatal/test/driver.h>
+#include <fatal/test/words.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fatal {
+
+struct runtime_trie_visitor {
+  void operator ()(std::size_t index, std::size_t &out) const {
+    FATAL_EXPECT_EQ(~std::size_t(0), out);
+    out = index;
+  }
+};
+
+// the position of `needle` in `keys`, or `~0` if not there //
+std::size_t naive_find(
+  std::vector<std::string> const &keys,
+  std::string const &needle
+) {
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    if (keys[i] == needle) {
+      return i;
+    }
+  }
+
+  return ~std::size_t(0);
+}
+
+void check_runtime_trie(
+  runtime_trie const &trie,
+  std::vector<std::string> const &keys,
+  std::vector<std::string> const &needles
+) {
+  for (auto const &needle: needles) {
+    auto const expected = naive_find(keys, needle);
+
+    for (auto pointer: {false, true}) {
+      std::size_t actual = ~std::size_t(0);
+      bool const found = pointer
+        ? trie.find(
+          needle.data(),
+          needle.data() + needle.size(),
+          runtime_trie_visitor(),
+          actual
+        )
+        : trie.find(
+          needle.begin(), needle.end(), runtime_trie_visitor(), actual
+        );
+
+      FATAL_EXPECT_EQ(expected != ~std::size_t(0), found);
+      FATAL_EXPECT_EQ(expected, actual);
+    }
+
+    FATAL_EXPECT_EQ(
+      expected != ~std::size_t(0),
+      trie.find(needle.begin(), needle.end())
+    );
+  }
+}
+
+FATAL_TEST(runtime_trie, empty) {
+  runtime_trie const trie{};
+  FATAL_EXPECT_TRUE(trie.empty());
+  FATAL_EXPECT_EQ(0, trie.size());
+  check_runtime_trie(trie, {}, {"", "x", "hat"});
+}
+
+FATAL_TEST(runtime_trie, find) {
+  std::vector<std::string> const needles{
+    "", "h", "ha", "hat", "hi", "hit", "hint", "ho", "hot", "x", "hx",
+    "hin", "hints", "hatx", "field", "field1", "field10", "field2",
+    "field100", "fiel", "\xff", "\xff\xfe", "\x01", "H"
+  };
+
+  std::vector<std::string> const hs{
+    "h", "ha", "hat", "hi", "hint", "hit", "ho", "hot"
+  };
+  runtime_trie const trie(hs.begin(), hs.end());
+  FATAL_EXPECT_EQ(hs.size(), trie.size());
+  check_runtime_trie(trie, hs, needles);
+
+  std::vector<std::string> const shuffled{
+    "hot", "h", "hint", "ha", "ho", "hit", "hat", "hi"
+  };
+  check_runtime_trie(
+    runtime_trie(shuffled.begin(), shuffled.end()), shuffled, needles
+  );
+
+  std::vector<std::string> const fields{"field", "field10", "field2"};
+  check_runtime_trie(
+    runtime_trie(fields.begin(), fields.end()), fields, needles
+  );
+
+  std::vector<std::string> const single{"field1"};
+  check_runtime_trie(
+    runtime_trie(single.begin(), single.end()), single, needles
+  );
+
+  std::vector<std::string> const with_empty{"", "hat", "x"};
+  check_runtime_trie(
+    runtime_trie(with_empty.begin(), with_empty.end()), with_empty, needles
+  );
+
+  std::vector<std::string> const high{"\xff", "\x01", "H", "\xff\xfe"};
+  check_runtime_trie(
+    runtime_trie(high.begin(), high.end()), high, needles
+  );
+}
+
+FATAL_TEST(runtime_trie, duplicates) {
+  std::vector<std::string> const keys{"hat", "hi", "hat", "h", "hi"};
+  runtime_trie const trie(keys.begin(), keys.end());
+  FATAL_EXPECT_EQ(3, trie.size());
+  check_runtime_trie(trie, keys, {"", "h", "ha", "hat", "hi", "hit"});
+}
+
+FATAL_TEST(runtime_trie, words) {
+  using array = z_array<random_250_words<list, sequence>, char const *>;
+  std::vector<std::string> const keys(
+    array::data, array::data + array::size::value
+  );
+
+  std::vector<std::string> needles;
+  for (auto const &key: keys) {
+    needles.push_back(key);
+    needles.push_back(key + "s");
+    needles.push_back(key.substr(0, key.size() - 1));
+    needles.push_back(key.substr(1));
+  }
+
+  runtime_trie const trie(array::data, array::data + array::size::value);
+  FATAL_EXPECT_EQ(keys.size(), trie.size());
+  check_runtime_trie(trie, keys, needles);
+}
+
+FATAL_TEST(runtime_trie, copy_move) {
+  std::vector<std::string> const keys{"GET", "POST", "PUT", "PATCH"};
+  std::vector<std::string> const needles{
+    "GET", "POST", "PUT", "PATCH", "P", "PO", "DELETE", ""
+  };
+
+  runtime_trie original(keys.begin(), keys.end());
+
+  runtime_trie copy(original);
+  check_runtime_trie(copy, keys, needles);
+
+  runtime_trie moved(std::move(copy));
+  check_runtime_trie(moved, keys, needles);
+
+  runtime_trie assigned{"x"};
+  assigned = original;
+  check_runtime_trie(assigned, keys, needles);
+
+  original = runtime_trie{"x"};
+  check_runtime_trie(original, {"x"}, needles);
+  check_runtime_trie(assigned, keys, needles);
+
+  runtime_trie from_empty{};
+  runtime_trie const empty_copy(from_empty);
+  FATAL_EXPECT_TRUE(empty_copy.empty());
+  FATAL_EXPECT_FALSE(empty_copy.find(needles[0].begin(), needles[0].end()));
+}
+
+} // namespace fatal {
@@ -10,11 +10,15 @@
 
 #include <fatal/math/numerics.h>
 
+#include <algorithm>
 #include <iterator>
+#include <memory>
 #include <limits>
 #include <type_traits>
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 namespace fatal {
 namespace detail  {
@@ -149,4 +153,120 @@ private:
   result_type hash_;
 };
 
+/**
+ * A hasher for sequences of bytes that mixes 8 bytes at a time.
+ *
+ * Bytes given across calls are joined into words as if they had been given
+ * in a single call, so the resulting hash only depends on the sequence of
+ * bytes, not on how it was split. This makes it a good fit for hashing
+ * the pieces of a rope.
+ *
+ * Words are read in the platform's native byte order, therefore hashes
+ * aren't portable across platforms of different endianness.
+ *
+ * Example:
+ *
+ *  // same as `*word_hasher<>()("hello, world", 12)`
+ *  auto const hash = *word_hasher<>()("hello", 5)(", ", 2)("world", 5);
+ */
+template <typename T = std::size_t>
+class word_hasher {
+  static_assert(std::is_unsigned<T>::value, "result_type must be unsigned");
+
+  using word_type = std::uint64_t;
+  using word_size = std::integral_constant<std::size_t, sizeof(word_type)>;
+
+  // from MurmurHash2, by Austin Appleby
+  using multiplier = std::integral_constant<word_type, 0xc6a4a7935bd1e995>;
+  using shift = std::integral_constant<unsigned, 47>;
+
+public:
+  using result_type = T;
+
+  explicit word_hasher(word_type seed = 0): state_(seed) {}
+
+  word_hasher &operator ()(char const *begin, char const *const end) {
+    assert(begin <= end);
+    size_ += unsigned_cast(std::distance(begin, end));
+
+    if (pending_) {
+      auto const count = std::min(
+        word_size::value - pending_,
+        unsigned_cast(std::distance(begin, end))
+      );
+      std::memcpy(buffer_ + pending_, begin, count);
+      std::advance(begin, signed_cast(count));
+      pending_ += count;
+
+      if (pending_ < word_size::value) {
+        return *this;
+      }
+
+      state_ = mix(state_, load(buffer_));
+      pending_ = 0;
+    }
+
+    for (; unsigned_cast(std::distance(begin, end)) >= word_size::value;
+      std::advance(begin, word_size::value)
+    ) {
+      state_ = mix(state_, load(begin));
+    }
+
+    pending_ = unsigned_cast(std::distance(begin, end));
+    std::memcpy(buffer_, begin, pending_);
+
+    return *this;
+  }
+
+  word_hasher &operator ()(char const *const data, std::size_t const size) {
+    return (*this)(data, std::next(data, signed_cast(size)));
+  }
+
+  word_hasher &operator ()(char const data) {
+    return (*this)(std::addressof(data), 1);
+  }
+
+  result_type operator *() const {
+    auto state = state_;
+
+    if (pending_) {
+      char tail[word_size::value] = {};
+      std::memcpy(tail, buffer_, pending_);
+      state = mix(state, load(tail));
+    }
+
+    state ^= size_;
+    state ^= state >> shift::value;
+    state *= multiplier::value;
+    state ^= state >> shift::value;
+
+    return static_cast<result_type>(state);
+  }
+
+  explicit operator result_type() const { return **this; }
+
+private:
+  static word_type load(char const *data) {
+    word_type word;
+    std::memcpy(std::addressof(word), data, sizeof(word));
+    return word;
+  }
+
+  static word_type mix(word_type state, word_type word) {
+    word *= multiplier::value;
+    word ^= word >> shift::value;
+    word *= multiplier::value;
+
+    state ^= word;
+    state *= multiplier::value;
+
+    return state;
+  }
+
+  word_type state_;
+  word_type size_ = 0;
+  std::size_t pending_ = 0;
+  char buffer_[word_size::value];
+};
+
 } // namespace fatail {
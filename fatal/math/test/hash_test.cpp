@@ -11,7 +11,11 @@
 
 #include <fatal/test/driver.h>
 
+#include <fatal/test/random_data.h>
+
+#include <algorithm>
 #include <iterator>
+#include <string>
 
 #include <cstring>
 
@@ -38,4 +42,68 @@ FATAL_TEST(bytes_hasher, sanity_check_2) {
   FATAL_EXPECT_EQ(r, u);
 }
 
+FATAL_TEST(word_hasher, sanity_check) {
+  auto const hello = "hello";
+  auto const end = std::next(hello, std::strlen(hello));
+
+  auto const h1 = *word_hasher<>()('h')('e')('l')('l')('o');
+  auto const h2 = *word_hasher<>()(hello, end);
+  auto const h3 = *word_hasher<>()(hello, std::strlen(hello));
+
+  FATAL_EXPECT_EQ(h1, h2);
+  FATAL_EXPECT_EQ(h1, h3);
+  FATAL_EXPECT_EQ(h2, h3);
+}
+
+FATAL_TEST(word_hasher, sanity_check_2) {
+  auto const r = *word_hasher<>()("hello", 5)(", ", 2)("world", 5)('!')
+    (" with", 5)(' ')("some", 4)(" extra", 6)(" ", 1)('s')("trings", 6);
+  auto const u = *word_hasher<>()("hello, world! with some extra strings", 37);
+
+  FATAL_EXPECT_EQ(r, u);
+}
+
+FATAL_TEST(word_hasher, split) {
+  random_data rdg;
+
+  for (std::size_t size = 0; size < 100; ++size) {
+    auto const s = rdg.string(size);
+    auto const expected = *word_hasher<>()(s.data(), s.size());
+
+    for (std::size_t round = 0; round < 10; ++round) {
+      word_hasher<> hasher;
+
+      for (std::size_t offset = 0; offset < s.size(); ) {
+        auto const count = std::min(rdg() % 12, s.size() - offset);
+        hasher(s.data() + offset, count);
+        offset += count;
+      }
+
+      FATAL_EXPECT_EQ(expected, *hasher);
+    }
+  }
+}
+
+FATAL_TEST(word_hasher, distinct) {
+  std::string const strings[] = {
+    "", std::string(1, '\0'), std::string(2, '\0'), "a", "b", "ab", "ba",
+    "12345678", "12345679", "123456789", "1234567890123456"
+  };
+
+  for (auto const &lhs: strings) {
+    for (auto const &rhs: strings) {
+      FATAL_EXPECT_EQ(
+        lhs == rhs,
+        *word_hasher<>()(lhs.data(), lhs.size())
+          == *word_hasher<>()(rhs.data(), rhs.size())
+      );
+    }
+  }
+
+  FATAL_EXPECT_NE(
+    *word_hasher<>(1)("hello", 5),
+    *word_hasher<>(2)("hello", 5)
+  );
+}
+
 } // namespace fatal {
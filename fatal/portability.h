@@ -80,3 +80,19 @@
 #else
 # define FATAL_ATTR_VISIBILITY_HIDDEN
 #endif
+
+////////////////////
+// FATAL_PREFETCH //
+////////////////////
+
+/**
+ * Hints the processor to bring the memory at the given address into the
+ * cache, in anticipation of a read. Has no effect when the compiler offers
+ * no such builtin.
+ */
+
+#if __clang__ || __GNUC__
+# define FATAL_PREFETCH(Address) __builtin_prefetch(Address)
+#else
+# define FATAL_PREFETCH(Address) static_cast<void>(Address)
+#endif
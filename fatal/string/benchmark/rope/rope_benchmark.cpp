@@ -0,0 +1,577 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/string/rope.h>
+
+#include <fatal/benchmark/benchmark.h>
+#include <fatal/benchmark/driver.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// counts calls to the global `operator new`, so benchmarks can report how
+// many heap allocations each iteration costs
+static std::atomic<std::size_t> heap_allocations{0};
+
+void *operator new(std::size_t size) {
+  ++heap_allocations;
+
+  if (auto const p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace fatal {
+
+// Each benchmark iteration searches a whole message, so the reported
+// frequency reads directly as messages per second.
+
+// an HTTP-like message of about 1KB, held by `rope` in pieces of 1 to 64
+// characters, the way a parser would reference network buffers //
+struct message {
+  message() {
+    for (std::size_t i = 0; i < 24; ++i) {
+      text.append("X-Header-");
+      text.append(std::to_string(i));
+      text.append(": some-value-for-the-header\r\n");
+    }
+
+    text.append("\r\nbody");
+
+    for (std::size_t offset = 0, i = 0; offset < text.size(); ++i) {
+      auto const size = std::min(i * 7 % 64 + 1, text.size() - offset);
+      r.append(text.data() + offset, size);
+      offset += size;
+    }
+  }
+
+  std::string text;
+  rope<> r;
+};
+
+message const &get_message() {
+  static message const instance;
+  return instance;
+}
+
+// what `rope::find(char)` used to do //
+struct std_find_policy {
+  static std::size_t find(rope<> const &r, char c) {
+    for (std::size_t i = 0, offset = 0; i < r.pieces(); ++i) {
+      auto const piece = r.piece(i);
+      auto const j = std::find(piece.begin(), piece.end(), c);
+
+      if (j != piece.end()) {
+        return offset + static_cast<std::size_t>(j - piece.begin());
+      }
+
+      offset += piece.size();
+    }
+
+    return r.size();
+  }
+};
+
+struct rope_find_policy {
+  static std::size_t find(rope<> const &r, char c) {
+    return r.find(c).absolute();
+  }
+
+  static std::size_t find(rope<> const &r, string_view s) {
+    return r.find(s).absolute();
+  }
+};
+
+// flattens the rope before searching //
+struct flatten_policy {
+  static std::size_t find(rope<> const &r, string_view s) {
+    auto const flat = r.to_string();
+    auto const i = flat.find(s.data(), 0, s.size());
+    return i == std::string::npos ? r.size() : i;
+  }
+};
+
+template <typename Policy, typename Needle, typename Controller>
+void find_benchmark(Controller &benchmark, std::size_t n, Needle needle) {
+  message const *m = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    m = std::addressof(get_message());
+  }
+
+  while (n--) {
+    count += Policy::find(m->r, needle);
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(find_char, std_find, n) {
+  find_benchmark<std_find_policy>(benchmark, n, 'b');
+}
+
+FATAL_BENCHMARK(find_char, memchr, n) {
+  find_benchmark<rope_find_policy>(benchmark, n, 'b');
+}
+
+FATAL_BENCHMARK(find_string, flatten, n) {
+  find_benchmark<flatten_policy>(benchmark, n, string_view("\r\n\r\n"));
+}
+
+FATAL_BENCHMARK(find_string, rope, n) {
+  find_benchmark<rope_find_policy>(benchmark, n, string_view("\r\n\r\n"));
+}
+
+// what `rope::hasher` used to do //
+std::size_t bytes_hash(rope<> const &r) {
+  bytes_hasher<std::size_t> hasher;
+
+  for (rope<>::piece_index i = 0; i < r.pieces(); ++i) {
+    auto const piece = r.piece(i);
+    hasher(piece.begin(), piece.end());
+  }
+
+  return *hasher;
+}
+
+FATAL_BENCHMARK(hash, bytes_hasher, n) {
+  rope<> const *r = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    r = std::addressof(get_message().r);
+  }
+
+  while (n--) {
+    count += bytes_hash(*r);
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(hash, word_hasher, n) {
+  rope<> const *r = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    r = std::addressof(get_message().r);
+  }
+
+  while (n--) {
+    count += r->hash();
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(hash, memoized, n) {
+  rope<> r;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    r.concat(get_message().r);
+    r.memoize_hash();
+  }
+
+  while (n--) {
+    count += rope<>::hasher()(r);
+  }
+
+  prevent_optimization(count);
+}
+
+// builds a response of 32 pieces: header names referenced from literals,
+// owned header values too long for the small string buffer, and a few
+// single characters //
+template <typename Rope>
+void build_response(Rope &r) {
+  for (std::size_t i = 0; i < 8; ++i) {
+    r.append("X-Header: ");
+    r.append(
+      typename Rope::string_type(
+        40, static_cast<char>('a' + i), r.get_allocator()
+      )
+    );
+    r.push_back('\r');
+    r.push_back('\n');
+  }
+}
+
+// prints the average number of heap allocations per rope built //
+struct allocation_report {
+  ~allocation_report() {
+    for (auto const &i: entries) {
+      std::cout << i.first << ": " << (i.second.first / i.second.second)
+        << " heap allocations per rope" << std::endl;
+    }
+  }
+
+  void add(std::string name, std::size_t allocations, std::size_t ropes) {
+    auto &entry = entries[std::move(name)];
+    entry.first += static_cast<double>(allocations);
+    entry.second += static_cast<double>(ropes);
+  }
+
+  std::map<std::string, std::pair<double, double>> entries;
+};
+
+allocation_report &get_allocation_report() {
+  static allocation_report instance;
+  return instance;
+}
+
+FATAL_BENCHMARK(build, heap, n) {
+  auto const ropes = n;
+  std::size_t count = 0;
+  auto const before = heap_allocations.load();
+
+  while (n--) {
+    rope<> r;
+    build_response(r);
+    count += r.size();
+  }
+
+  auto const allocations = heap_allocations.load() - before;
+
+  FATAL_BENCHMARK_SUSPEND {
+    get_allocation_report().add("build/heap", allocations, ropes);
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(build, arena, n) {
+  auto const ropes = n;
+  std::size_t count = 0;
+  monotonic_arena arena;
+  auto const before = heap_allocations.load();
+
+  while (n--) {
+    rope<8, arena_allocator<char>> r{arena_allocator<char>(arena)};
+    build_response(r);
+    count += r.size();
+    arena.reset();
+  }
+
+  auto const allocations = heap_allocations.load() - before;
+
+  FATAL_BENCHMARK_SUSPEND {
+    get_allocation_report().add("build/arena", allocations, ropes);
+  }
+
+  prevent_optimization(count);
+}
+
+// Each fan-out iteration hands a 16KB payload, held in 4 owned pieces, to 8
+// consumers that may outlive it. Without shared pieces, each consumer needs
+// its own copy of the contents.
+
+using fan_out_consumers = std::integral_constant<std::size_t, 8>;
+
+rope<> make_payload() {
+  rope<> r;
+
+  for (std::size_t i = 0; i < 4; ++i) {
+    r.append(std::string(4096, static_cast<char>('a' + i)));
+  }
+
+  return r;
+}
+
+FATAL_BENCHMARK(fan_out, deep_copy, n) {
+  std::size_t count = 0;
+  rope<> payload;
+
+  FATAL_BENCHMARK_SUSPEND {
+    payload.concat(make_payload());
+  }
+
+  while (n--) {
+    std::vector<rope<>> consumers;
+    consumers.reserve(fan_out_consumers::value);
+
+    for (auto i = fan_out_consumers::value; i--; ) {
+      consumers.emplace_back();
+      for (rope<>::piece_index j = 0; j < payload.pieces(); ++j) {
+        auto const piece = payload.piece(j);
+        consumers.back().append(std::string(piece.data(), piece.size()));
+      }
+    }
+
+    count += consumers.back().size();
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(fan_out, shared, n) {
+  std::size_t count = 0;
+  rope<> payload;
+
+  FATAL_BENCHMARK_SUSPEND {
+    payload.concat(make_payload());
+    payload.share();
+  }
+
+  while (n--) {
+    std::vector<rope<>> consumers;
+    consumers.reserve(fan_out_consumers::value);
+
+    for (auto i = fan_out_consumers::value; i--; ) {
+      consumers.emplace_back(payload.mimic());
+    }
+
+    count += consumers.back().size();
+  }
+
+  prevent_optimization(count);
+}
+
+// Each coalescing iteration builds, flattens or searches a 2.7KB record of 256
+// `key=value;` fields, appended the way a serializer would: keys and values
+// referenced from existing strings, separators as single characters. The
+// record is kept as appended, coalesced while appending, or compacted
+// afterwards.
+
+using coalescing_threshold = std::integral_constant<std::size_t, 64>;
+
+struct record {
+  record() {
+    for (std::size_t i = 0; i < 256; ++i) {
+      keys.push_back("key" + std::to_string(i));
+      values.push_back(std::string(i % 4 + 1, static_cast<char>('a' + i % 26)));
+    }
+
+    build(plain);
+
+    coalesced.set_coalescing_threshold(coalescing_threshold::value);
+    build(coalesced);
+
+    build(compacted);
+    compacted.compact(coalescing_threshold::value);
+
+    std::cout << "record pieces: plain = " << plain.pieces()
+      << ", coalesced = " << coalesced.pieces()
+      << ", compacted = " << compacted.pieces() << std::endl;
+  }
+
+  void build(rope<> &r) const {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      r.append(keys[i]);
+      r.push_back('=');
+      r.append(values[i]);
+      r.push_back(';');
+    }
+  }
+
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  rope<> plain;
+  rope<> coalesced;
+  rope<> compacted;
+};
+
+record const &get_record() {
+  static record const instance;
+  return instance;
+}
+
+template <typename Controller>
+void build_record_benchmark(
+  Controller &benchmark,
+  std::size_t n,
+  std::size_t threshold
+) {
+  record const *d = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    d = std::addressof(get_record());
+  }
+
+  while (n--) {
+    rope<> r;
+    r.set_coalescing_threshold(threshold);
+    d->build(r);
+    count += r.pieces();
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(build_record, plain, n) {
+  build_record_benchmark(benchmark, n, 0);
+}
+
+FATAL_BENCHMARK(build_record, coalesced, n) {
+  build_record_benchmark(benchmark, n, coalescing_threshold::value);
+}
+
+template <typename Controller>
+void to_string_benchmark(
+  Controller &benchmark,
+  std::size_t n,
+  rope<> record::*member
+) {
+  rope<> const *r = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    r = std::addressof(get_record().*member);
+  }
+
+  while (n--) {
+    count += r->to_string().size();
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(to_string, plain, n) {
+  to_string_benchmark(benchmark, n, &record::plain);
+}
+
+FATAL_BENCHMARK(to_string, coalesced, n) {
+  to_string_benchmark(benchmark, n, &record::coalesced);
+}
+
+FATAL_BENCHMARK(to_string, compacted, n) {
+  to_string_benchmark(benchmark, n, &record::compacted);
+}
+
+// searches for the last field //
+template <typename Controller>
+void find_field_benchmark(
+  Controller &benchmark,
+  std::size_t n,
+  rope<> record::*member
+) {
+  rope<> const *r = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    r = std::addressof(get_record().*member);
+  }
+
+  while (n--) {
+    count += r->find("key255=").absolute();
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(find_field, plain, n) {
+  find_field_benchmark(benchmark, n, &record::plain);
+}
+
+FATAL_BENCHMARK(find_field, coalesced, n) {
+  find_field_benchmark(benchmark, n, &record::coalesced);
+}
+
+FATAL_BENCHMARK(find_field, compacted, n) {
+  find_field_benchmark(benchmark, n, &record::compacted);
+}
+
+// Each file response iteration sends a 1MB static file, wrapped in headers,
+// to /dev/null. The file is either read into a string for each response, or
+// mapped once and shared by all responses.
+
+struct static_file {
+  static_file() {
+    char name[] = "/tmp/rope_benchmark.XXXXXX";
+    auto const fd = ::mkstemp(name);
+    path = name;
+
+    std::string const contents(1 << 20, 'x');
+    if (::write(fd, contents.data(), contents.size()) < 0) {
+      std::abort();
+    }
+    ::close(fd);
+
+    sink = ::open("/dev/null", O_WRONLY);
+  }
+
+  ~static_file() {
+    ::close(sink);
+    ::unlink(path.c_str());
+  }
+
+  std::string read() const {
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    std::string result(1 << 20, '\0');
+    auto const size = ::read(fd, &result[0], result.size());
+    ::close(fd);
+    result.resize(size < 0 ? 0 : static_cast<std::size_t>(size));
+    return result;
+  }
+
+  std::string path;
+  int sink;
+};
+
+static_file const &get_static_file() {
+  static static_file const instance;
+  return instance;
+}
+
+FATAL_BENCHMARK(file_response, read, n) {
+  static_file const *file = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    file = std::addressof(get_static_file());
+  }
+
+  while (n--) {
+    rope<> response("HTTP/1.1 200 OK\r\n\r\n", file->read());
+    response.write_to_fd(file->sink);
+    count += response.size();
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(file_response, mapped, n) {
+  static_file const *file = nullptr;
+  std::unique_ptr<mapped_file> body;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    file = std::addressof(get_static_file());
+    body.reset(new mapped_file(file->path));
+  }
+
+  while (n--) {
+    rope<> response("HTTP/1.1 200 OK\r\n\r\n", *body);
+    response.write_to_fd(file->sink);
+    count += response.size();
+  }
+
+  prevent_optimization(count);
+}
+
+} // namespace fatal {
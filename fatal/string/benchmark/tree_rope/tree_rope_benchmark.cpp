@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/string/rope.h>
+#include <fatal/string/tree_rope.h>
+
+#include <fatal/benchmark/benchmark.h>
+#include <fatal/benchmark/driver.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fatal {
+
+// Each benchmark iteration performs a single edit, or a single full scan,
+// of a document made of `Pieces` pieces of 1 to 32 characters, so the
+// reported frequency reads directly as edits (or scans) per second.
+
+template <std::size_t Pieces>
+struct document {
+  document() {
+    for (std::size_t i = 0; i < Pieces; ++i) {
+      words.push_back(
+        std::string(i * 7 % 32 + 1, static_cast<char>('a' + i % 26))
+      );
+    }
+
+    for (auto const &word: words) {
+      flat.append(word);
+      tree.append(word);
+    }
+  }
+
+  std::vector<std::string> words;
+  rope<> flat;
+  tree_rope tree;
+};
+
+template <std::size_t Pieces>
+document<Pieces> &get_document() {
+  static document<Pieces> instance;
+  return instance;
+}
+
+// a `rope` can't be edited in the middle: this is how it's done today, by
+// rebuilding it around the inserted piece //
+void rebuild_with_insert(
+  rope<> const &source,
+  std::size_t position,
+  string_view piece,
+  rope<> &out
+) {
+  out.reserve(source.pieces() + 2);
+
+  rope<>::piece_index i = 0;
+
+  for (; i < source.pieces(); ++i) {
+    auto const current = source.piece(i);
+
+    if (position < current.size()) {
+      out.append(current.data(), position);
+      out.append(piece);
+      out.append(current + position);
+      break;
+    }
+
+    out.append(current);
+    position -= current.size();
+  }
+
+  while (++i < source.pieces()) {
+    out.append(source.piece(i));
+  }
+}
+
+template <std::size_t Pieces, typename Controller>
+void flat_edit(Controller &benchmark, std::size_t n) {
+  document<Pieces> const *d = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    d = std::addressof(get_document<Pieces>());
+  }
+
+  for (std::size_t i = 0; n--; ++i) {
+    rope<> out;
+    rebuild_with_insert(d->flat, i * 7919 % d->flat.size(), "edit", out);
+    count += out.pieces();
+  }
+
+  prevent_optimization(count);
+}
+
+// inserts a piece, then erases it to keep the document the same size //
+template <std::size_t Pieces, typename Controller>
+void tree_edit(Controller &benchmark, std::size_t n) {
+  tree_rope *d = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    d = std::addressof(get_document<Pieces>().tree);
+  }
+
+  for (std::size_t i = 0; n--; ++i) {
+    auto const position = i * 7919 % d->size();
+    d->insert(position, "edit");
+    count += d->pieces();
+    d->erase(position, 4);
+  }
+
+  prevent_optimization(count);
+}
+
+template <typename Rope>
+std::size_t scan(Rope const &r, std::vector<char> &buffer) {
+  return static_cast<std::size_t>(
+    r.copy(buffer.data(), buffer.data() + buffer.size()) - buffer.data()
+  );
+}
+
+template <std::size_t Pieces, bool Tree, typename Controller>
+void scan_benchmark(Controller &benchmark, std::size_t n) {
+  document<Pieces> const *d = nullptr;
+  std::vector<char> buffer;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    d = std::addressof(get_document<Pieces>());
+    buffer.resize(d->flat.size());
+  }
+
+  while (n--) {
+    count += Tree ? scan(d->tree, buffer) : scan(d->flat, buffer);
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(edit_16, rope, n) { flat_edit<16>(benchmark, n); }
+FATAL_BENCHMARK(edit_16, tree_rope, n) { tree_edit<16>(benchmark, n); }
+
+FATAL_BENCHMARK(edit_64, rope, n) { flat_edit<64>(benchmark, n); }
+FATAL_BENCHMARK(edit_64, tree_rope, n) { tree_edit<64>(benchmark, n); }
+
+FATAL_BENCHMARK(edit_256, rope, n) { flat_edit<256>(benchmark, n); }
+FATAL_BENCHMARK(edit_256, tree_rope, n) { tree_edit<256>(benchmark, n); }
+
+FATAL_BENCHMARK(edit_4096, rope, n) { flat_edit<4096>(benchmark, n); }
+FATAL_BENCHMARK(edit_4096, tree_rope, n) { tree_edit<4096>(benchmark, n); }
+
+FATAL_BENCHMARK(scan_256, rope, n) { scan_benchmark<256, false>(benchmark, n); }
+FATAL_BENCHMARK(scan_256, tree_rope, n) {
+  scan_benchmark<256, true>(benchmark, n);
+}
+
+FATAL_BENCHMARK(scan_4096, rope, n) {
+  scan_benchmark<4096, false>(benchmark, n);
+}
+FATAL_BENCHMARK(scan_4096, tree_rope, n) {
+  scan_benchmark<4096, true>(benchmark, n);
+}
+
+} // namespace fatal {
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/portability.h>
+#include <fatal/string/string_view.h>
+
+#include <atomic>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+FATAL_DIAGNOSTIC_PUSH
+FATAL_GCC_DIAGNOSTIC_IGNORED_SHADOW_IF_BROKEN
+
+namespace fatal {
+
+/////////////////
+// mapped_file //
+/////////////////
+
+/**
+ * A read-only view of the contents of a file, mapped into memory.
+ *
+ * The mapping is shared, through an atomic reference count, by all copies
+ * of a `mapped_file`, and it's unmapped once the last copy is gone. This
+ * makes it cheap to hand the same file over to many consumers, possibly
+ * running on different threads.
+ *
+ * Empty files are represented by an empty view, without any mapping.
+ *
+ * Changes to the file made after it's been mapped may or may not be seen
+ * through the mapping, and truncating the file while it's mapped results
+ * in undefined behavior.
+ *
+ * Mapping files is only supported on POSIX systems.
+ *
+ * Example:
+ *
+ *  mapped_file const body("/var/www/index.html");
+ *
+ *  for (auto const &client: clients) {
+ *    // the body is shared by the ropes, rather than copied
+ *    rope<> response(header, body);
+ *    response.write_to_fd(client);
+ *  }
+ */
+struct mapped_file {
+  using size_type = std::size_t;
+
+#ifndef _WIN32
+  /**
+   * Maps the whole contents of the file at `path`.
+   *
+   * The file is only kept open while it's being mapped.
+   *
+   * Throws `std::system_error` if the file can't be opened or mapped, or if
+   * it isn't a regular file.
+   */
+  explicit mapped_file(char const *path) {
+    descriptor file(path);
+    map(file.fd);
+  }
+
+  explicit mapped_file(std::string const &path):
+    mapped_file(path.c_str())
+  {}
+
+  /**
+   * Maps the whole contents of the file open as the file descriptor `fd`,
+   * which remains owned by the caller and can be closed afterwards.
+   *
+   * Throws `std::system_error` if the file can't be mapped or if it isn't
+   * a regular file.
+   */
+  explicit mapped_file(int fd) {
+    map(fd);
+  }
+#endif // _WIN32
+
+  mapped_file(mapped_file const &rhs) noexcept:
+    mapping_(rhs.mapping_),
+    ref_(rhs.ref_)
+  {
+    acquire();
+  }
+
+  /**
+   * Shares the mapping of `rhs`, viewing only `ref`, which must lie within
+   * the contents of `rhs`.
+   */
+  mapped_file(mapped_file const &rhs, string_view ref) noexcept:
+    mapping_(rhs.mapping_),
+    ref_(ref)
+  {
+    assert(ref_.begin() >= rhs.ref_.begin());
+    assert(ref_.end() <= rhs.ref_.end());
+    acquire();
+  }
+
+  mapped_file(mapped_file &&rhs) noexcept:
+    mapping_(rhs.mapping_),
+    ref_(rhs.ref_)
+  {
+    rhs.mapping_ = nullptr;
+    rhs.ref_ = string_view();
+  }
+
+  mapped_file &operator =(mapped_file rhs) noexcept {
+    std::swap(mapping_, rhs.mapping_);
+    std::swap(ref_, rhs.ref_);
+    return *this;
+  }
+
+  ~mapped_file() { release(); }
+
+  /**
+   * The contents of the file.
+   */
+  string_view ref() const { return ref_; }
+
+  char const *data() const { return ref_.data(); }
+  size_type size() const { return ref_.size(); }
+  bool empty() const { return ref_.empty(); }
+
+  /**
+   * The number of copies sharing the mapping, or zero for empty files.
+   *
+   * For diagnostic purposes only.
+   */
+  size_type use_count() const {
+    return mapping_ ? mapping_->refs.load(std::memory_order_relaxed) : 0;
+  }
+
+private:
+  struct mapping {
+    mapping(void *address_, size_type length_):
+      address(address_),
+      length(length_)
+    {}
+
+    std::atomic<size_type> refs{1};
+    void *const address;
+    size_type const length;
+  };
+
+#ifndef _WIN32
+  // closes the file descriptor on scope exit //
+  struct descriptor {
+    explicit descriptor(char const *path):
+      fd(::open(path, O_RDONLY | O_CLOEXEC))
+    {
+      if (fd < 0) {
+        throw std::system_error(errno, std::system_category(), "open");
+      }
+    }
+
+    descriptor(descriptor const &) = delete;
+
+    ~descriptor() { ::close(fd); }
+
+    int const fd;
+  };
+
+  void map(int fd) {
+    struct stat info;
+
+    if (::fstat(fd, &info)) {
+      throw std::system_error(errno, std::system_category(), "fstat");
+    }
+
+    if (!S_ISREG(info.st_mode)) {
+      throw std::system_error(
+        std::make_error_code(std::errc::invalid_argument),
+        "mapped_file: not a regular file"
+      );
+    }
+
+    auto const length = static_cast<size_type>(info.st_size);
+
+    if (!length) {
+      return;
+    }
+
+    auto const address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (address == MAP_FAILED) {
+      throw std::system_error(errno, std::system_category(), "mmap");
+    }
+
+    try {
+      mapping_ = new mapping(address, length);
+    } catch (...) {
+      ::munmap(address, length);
+      throw;
+    }
+
+    ref_ = string_view(static_cast<char const *>(address), length);
+  }
+#endif // _WIN32
+
+  void acquire() {
+    if (mapping_) {
+      mapping_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void release() {
+    if (!mapping_) {
+      return;
+    }
+
+    if (mapping_->refs.fetch_sub(1, std::memory_order_acq_rel) > 1) {
+      return;
+    }
+
+#ifndef _WIN32
+    ::munmap(mapping_->address, mapping_->length);
+#endif // _WIN32
+
+    delete mapping_;
+  }
+
+  mapping *mapping_ = nullptr;
+  string_view ref_;
+};
+
+} // namespace fatal {
+
+FATAL_DIAGNOSTIC_POP
@@ -8,9 +8,11 @@
  */
 #pragma once
 
+#include <fatal/container/arena.h>
 #include <fatal/container/uninitialized.h>
 #include <fatal/math/hash.h>
 #include <fatal/portability.h>
+#include <fatal/string/mapped_file.h>
 #include <fatal/string/string_view.h>
 #include <fatal/type/get.h>
 #include <fatal/type/list.h>
@@ -18,8 +20,10 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <ostream>
 #include <stdexcept>
@@ -30,6 +34,16 @@
 #include <vector>
 
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#ifndef _WIN32
+# include <system_error>
+
+# include <sys/uio.h>
+# include <unistd.h>
+#endif
 
 FATAL_DIAGNOSTIC_PUSH
 FATAL_GCC_DIAGNOSTIC_IGNORED_SHADOW_IF_BROKEN
@@ -42,14 +56,119 @@ namespace rope_impl {
 // IMPLEMENTATION DETAILS //
 ////////////////////////////
 
+// an immutable string kept alive by an atomic reference count, shared by
+// all the rope pieces referencing a portion of it
+template <typename String>
+struct shared_string {
+  using string_type = String;
+  using size_type = std::size_t;
+
+  explicit shared_string(string_type &&s):
+    buffer_(make(std::move(s))),
+    ref_(buffer_->value)
+  {}
+
+  shared_string(shared_string const &rhs) noexcept:
+    buffer_(rhs.buffer_),
+    ref_(rhs.ref_)
+  {
+    acquire();
+  }
+
+  // shares the buffer of `rhs`, referencing `ref`, which must lie within it
+  shared_string(shared_string const &rhs, string_view ref) noexcept:
+    buffer_(rhs.buffer_),
+    ref_(ref)
+  {
+    assert(ref_.begin() >= rhs.buffer_->value.data());
+    assert(
+      ref_.end() <= rhs.buffer_->value.data() + rhs.buffer_->value.size()
+    );
+    acquire();
+  }
+
+  shared_string(shared_string &&rhs) noexcept:
+    buffer_(rhs.buffer_),
+    ref_(rhs.ref_)
+  {
+    rhs.buffer_ = nullptr;
+  }
+
+  shared_string &operator =(shared_string const &) = delete;
+  shared_string &operator =(shared_string &&) = delete;
+
+  ~shared_string() { release(); }
+
+  string_view ref() const { return ref_; }
+
+  // the number of pieces sharing the buffer, for diagnostic purposes only
+  size_type use_count() const {
+    assert(buffer_);
+    return buffer_->refs.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct buffer {
+    explicit buffer(string_type &&s): value(std::move(s)) {}
+
+    std::atomic<size_type> refs{1};
+    string_type const value;
+  };
+
+  using allocator_traits = typename std::allocator_traits<
+    typename string_type::allocator_type
+  >::template rebind_traits<buffer>;
+  using allocator_type = typename allocator_traits::allocator_type;
+
+  static buffer *make(string_type &&s) {
+    allocator_type allocator(s.get_allocator());
+    auto const result = allocator_traits::allocate(allocator, 1);
+
+    try {
+      allocator_traits::construct(allocator, result, std::move(s));
+    } catch (...) {
+      allocator_traits::deallocate(allocator, result, 1);
+      throw;
+    }
+
+    return result;
+  }
+
+  void acquire() {
+    assert(buffer_);
+    buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void release() {
+    if (!buffer_) {
+      return;
+    }
+
+    if (buffer_->refs.fetch_sub(1, std::memory_order_acq_rel) > 1) {
+      return;
+    }
+
+    allocator_type allocator(buffer_->value.get_allocator());
+    allocator_traits::destroy(allocator, buffer_);
+    allocator_traits::deallocate(allocator, buffer_, 1);
+  }
+
+  buffer *buffer_;
+  string_view ref_;
+};
+
 // optimized for rope
-template <typename TData>
+template <typename TData, typename String = std::string>
 class variant {
-  enum class id_type: unsigned char { string, reference, character };
+  enum class id_type: unsigned char {
+    string, reference, character, shared, mapping
+  };
 
 public:
   using size_type = std::size_t;
   using payload_type = TData;
+  using string_type = String;
+  using shared_type = shared_string<string_type>;
 
   template <id_type V>
   using id_constant = std::integral_constant<id_type, V>;
@@ -57,9 +176,11 @@ public:
   template <typename T>
   using id = fatal::pair_get<
     fatal::list<
-      fatal::pair<std::string, id_constant<id_type::string>>,
+      fatal::pair<string_type, id_constant<id_type::string>>,
       fatal::pair<string_view, id_constant<id_type::reference>>,
-      fatal::pair<char, id_constant<id_type::character>>
+      fatal::pair<char, id_constant<id_type::character>>,
+      fatal::pair<shared_type, id_constant<id_type::shared>>,
+      fatal::pair<mapped_file, id_constant<id_type::mapping>>
     >,
     T
   >;
@@ -67,27 +188,24 @@ public:
   variant(variant const &rhs) = delete;
 
   variant(variant &&rhs)
-    noexcept(noexcept(std::string(std::declval<std::string &&>()))):
+    noexcept(noexcept(string_type(std::declval<string_type &&>()))):
     payload_(std::move(rhs.payload_)),
     which_(rhs.which_)
   {
-    switch (which_) {
-      case id_type::string:
-        new (std::addressof(value_.s)) std::string(std::move(rhs.value_.s));
-        break;
-
-      case id_type::reference:
-        value_.ref = rhs.value_.ref;
-        break;
+    steal(std::move(rhs));
+  }
 
-      case id_type::character:
-        value_.c = rhs.value_.c;
-        break;
-    }
+  // moves the piece out of `rhs`, giving it a new payload
+  template <typename... Args>
+  variant(variant &&rhs, Args &&...args):
+    payload_(std::forward<Args>(args)...),
+    which_(rhs.which_)
+  {
+    steal(std::move(rhs));
   }
 
   template <typename... Args>
-  explicit variant(std::string &&s, Args &&...args):
+  explicit variant(string_type &&s, Args &&...args):
     payload_(std::forward<Args>(args)...),
     value_(std::move(s)),
     which_(id_type::string)
@@ -107,11 +225,32 @@ public:
     which_(id_type::character)
   {}
 
+  template <typename... Args>
+  explicit variant(shared_type &&s, Args &&...args):
+    payload_(std::forward<Args>(args)...),
+    value_(std::move(s)),
+    which_(id_type::shared)
+  {}
+
+  template <typename... Args>
+  explicit variant(mapped_file &&m, Args &&...args):
+    payload_(std::forward<Args>(args)...),
+    value_(std::move(m)),
+    which_(id_type::mapping)
+  {}
+
   ~variant() {
     switch (which_) {
       case id_type::string:
-        using string_t = std::string;
-        value_.s.~string_t();
+        value_.s.~string_type();
+        break;
+
+      case id_type::shared:
+        value_.sh.~shared_type();
+        break;
+
+      case id_type::mapping:
+        value_.m.~mapped_file();
         break;
 
       default:
@@ -119,6 +258,18 @@ public:
     }
   }
 
+  // moves an owned string into a buffer that can be shared among pieces
+  void share() {
+    if (which_ != id_type::string) {
+      return;
+    }
+
+    shared_type shared(std::move(value_.s));
+    value_.s.~string_type();
+    new (std::addressof(value_.sh)) shared_type(std::move(shared));
+    which_ = id_type::shared;
+  }
+
   template <typename T> bool is() const { return which_ == id<T>::value; }
 
   template <typename T>
@@ -132,6 +283,12 @@ public:
     return which_ == id<T>::value ? try_get(tag<T>()) : nullptr;
   }
 
+  // the owned string, so that it can be appended to, or `nullptr` when
+  // this piece isn't an owned string
+  string_type *owned() {
+    return which_ == id_type::string ? std::addressof(value_.s) : nullptr;
+  }
+
   string_view ref() const {
     switch (which_) {
       case id_type::string:
@@ -142,6 +299,12 @@ public:
 
       case id_type::character:
         return string_view(value_.c);
+
+      case id_type::shared:
+        return value_.sh.ref();
+
+      case id_type::mapping:
+        return value_.m.ref();
     }
 
     assert(which_ == id_type::reference);
@@ -158,6 +321,12 @@ public:
 
       case id_type::character:
         return std::addressof(value_.c);
+
+      case id_type::shared:
+        return value_.sh.ref().data();
+
+      case id_type::mapping:
+        return value_.m.data();
     }
 
     assert(which_ == id_type::reference);
@@ -174,6 +343,12 @@ public:
 
       case id_type::character:
         return 1;
+
+      case id_type::shared:
+        return value_.sh.ref().size();
+
+      case id_type::mapping:
+        return value_.m.size();
     }
 
     assert(which_ == id_type::reference);
@@ -190,6 +365,12 @@ public:
 
       case id_type::character:
         return false;
+
+      case id_type::shared:
+        return value_.sh.ref().empty();
+
+      case id_type::mapping:
+        return value_.m.empty();
     }
 
     assert(which_ == id_type::reference);
@@ -206,19 +387,47 @@ private:
     union_t(union_t const &) = delete;
     union_t(union_t &&) = delete;
 
-    explicit union_t(std::string &&s_): s(std::move(s_)) {}
+    explicit union_t(string_type &&s_): s(std::move(s_)) {}
     explicit union_t(string_view s_): ref(s_) {}
     explicit union_t(char c_): c(c_) {}
+    explicit union_t(shared_type &&sh_): sh(std::move(sh_)) {}
+    explicit union_t(mapped_file &&m_): m(std::move(m_)) {}
 
     ~union_t() {}
 
-    std::string s;
+    string_type s;
     string_view ref;
     char c;
+    shared_type sh;
+    mapped_file m;
   };
 
-  std::string const &get(tag<std::string>) const { return value_.s; }
-  std::string const *try_get(tag<std::string>) const {
+  void steal(variant &&rhs) {
+    switch (which_) {
+      case id_type::string:
+        new (std::addressof(value_.s)) string_type(std::move(rhs.value_.s));
+        break;
+
+      case id_type::reference:
+        value_.ref = rhs.value_.ref;
+        break;
+
+      case id_type::character:
+        value_.c = rhs.value_.c;
+        break;
+
+      case id_type::shared:
+        new (std::addressof(value_.sh)) shared_type(std::move(rhs.value_.sh));
+        break;
+
+      case id_type::mapping:
+        new (std::addressof(value_.m)) mapped_file(std::move(rhs.value_.m));
+        break;
+    }
+  }
+
+  string_type const &get(tag<string_type>) const { return value_.s; }
+  string_type const *try_get(tag<string_type>) const {
     return std::addressof(value_.s);
   }
 
@@ -230,13 +439,27 @@ private:
   char const &get(tag<char>) const { return value_.c; }
   char const *try_get(tag<char>) const { return std::addressof(value_.c); }
 
+  shared_type const &get(tag<shared_type>) const { return value_.sh; }
+  shared_type const *try_get(tag<shared_type>) const {
+    return std::addressof(value_.sh);
+  }
+
+  mapped_file const &get(tag<mapped_file>) const { return value_.m; }
+  mapped_file const *try_get(tag<mapped_file>) const {
+    return std::addressof(value_.m);
+  }
+
   payload_type payload_;
   union_t value_;
   id_type which_;
 };
 
 // optimized for rope
-template <typename T, std::size_t SmallBufferSize = 8>
+template <
+  typename T,
+  std::size_t SmallBufferSize = 8,
+  typename Allocator = std::allocator<T>
+>
 struct vector {
   using value_type = T;
   using const_reference = value_type const &;
@@ -244,8 +467,10 @@ struct vector {
   using const_pointer = value_type const *;
   using size_type = std::size_t;
   using small_buffer_size = std::integral_constant<size_type, SmallBufferSize>;
+  using allocator_type = Allocator;
 
   vector() = default;
+  explicit vector(allocator_type const &allocator): buffer_(allocator) {}
   vector(vector const &) = delete;
   vector(vector &&rhs):
     size_(std::move(rhs.size_)),
@@ -254,6 +479,10 @@ struct vector {
     for (auto i = std::min(size_, rhs.small_.size()); i--; ) {
       small_[i].steal(std::move(rhs.small_[i]));
     }
+
+    // `steal` already destroyed the elements in `rhs` //
+    rhs.buffer_.clear();
+    rhs.size_ = 0;
   }
 
   ~vector() { clear(); }
@@ -272,6 +501,17 @@ struct vector {
     ++size_;
   }
 
+  void pop_back() {
+    assert(size_);
+    --size_;
+
+    if (size_ < small_.size()) {
+      small_[size_].destroy();
+    } else {
+      buffer_.pop_back();
+    }
+  }
+
   void clear() {
     buffer_.clear();
 
@@ -290,10 +530,19 @@ struct vector {
 
   size_type capacity() const { return small_.size() + buffer_.capacity(); }
 
+  allocator_type get_allocator() const { return buffer_.get_allocator(); }
+
   size_type size() const { return size_; }
 
   bool empty() const { return !size_; }
 
+  value_type &back() {
+    assert(size_);
+    return size_ <= small_.size()
+      ? *small_[size_ - 1]
+      : buffer_.back();
+  }
+
   const_reference operator [](size_type i) const {
     assert(i < size_);
     return i < small_.size()
@@ -301,6 +550,15 @@ struct vector {
       : buffer_[i - small_.size()];
   }
 
+  void share(size_type i) {
+    assert(i < size_);
+    if (i < small_.size()) {
+      small_[i]->share();
+    } else {
+      buffer_[i - small_.size()].share();
+    }
+  }
+
   rvalue_reference move(size_type i) {
     assert(i < size_);
     if (i < small_.size()) {
@@ -314,9 +572,18 @@ private:
   size_type size_ = 0;
   std::array<uninitialized<value_type, false>, small_buffer_size::value> small_;
   // TODO: use something other than std::vector ??
-  std::vector<value_type> buffer_;
+  std::vector<value_type, allocator_type> buffer_;
 };
 
+// tells whether the arguments to a constructor start with `allocator_arg`
+template <typename...>
+struct leads_with_allocator_arg: std::false_type {};
+
+template <typename T, typename... Args>
+struct leads_with_allocator_arg<T, Args...>:
+  std::is_same<typename std::decay<T>::type, std::allocator_arg_t>
+{};
+
 } // namespace rope_impl {
 } // namespace detail {
 
@@ -338,7 +605,7 @@ private:
  * not owned, but rather referenced, by the rope. This means that such
  * pieces must outlive the rope instance for the latter to remain valid.
  *
- * There are three types of pieces that can be stored in a rope:
+ * There are five types of pieces that can be stored in a rope:
  *
  * 1. string_view: a reference to a portion of an existing string.
  *    Results from appending a string literal, an lvalue of type
@@ -357,6 +624,14 @@ private:
  *    append passing a single character as a parameter. The
  *    contents of this piece are owned by the rope.
  *
+ * 4. shared string: an immutable string with an atomic reference count,
+ *    shared by all the ropes referencing it. Results from calling
+ *    `share()` on a rope that owns string pieces. See `share()`.
+ *
+ * 5. mapped_file: the contents of a file mapped into memory, shared by
+ *    all the ropes referencing it. Results from appending a value of
+ *    type `mapped_file`.
+ *
  * Example 1:
  *
  *  rope<> r;
@@ -422,10 +697,25 @@ private:
  *  // prints "hello, world! this is a test."
  *  std::cout << r << std::endl;
  *
+ * The `Allocator` is used for the storage of owned string pieces and for
+ * the pieces that don't fit in the small buffer. A stateful allocator,
+ * like `arena_allocator`, is given to the rope at construction.
+ *
+ * Example 4:
+ *
+ *  monotonic_arena arena;
+ *  rope<8, arena_allocator<char>> r{arena_allocator<char>(arena)};
+ *
+ *  // the contents of the temporary are copied into the arena
+ *  r.append(std::string("a string too long for the small string buffer"));
+ *
  * @author: Marcelo Juchem
  */
 
-template <std::size_t SmallBufferSize = 8>
+template <
+  std::size_t SmallBufferSize = 8,
+  typename Allocator = std::allocator<char>
+>
 struct rope {
   // TODO: switch `char` piece with array+size, taking up the same space as the
   // other pieces
@@ -455,13 +745,51 @@ struct rope {
    */
   using difference_type = typename std::make_signed<size_type>::type;
 
+  /**
+   * The allocator used by this rope.
+   */
+  using allocator_type = Allocator;
+
+  /**
+   * The type of the string pieces owned by this rope. This is
+   * `std::string` when using the default allocator.
+   */
+  using string_type = std::basic_string<
+    char,
+    std::char_traits<char>,
+    typename std::allocator_traits<allocator_type>::template rebind_alloc<char>
+  >;
+
 private:
-  using piece_type = detail::rope_impl::variant<size_type>;
+  using piece_type = detail::rope_impl::variant<size_type, string_type>;
+  using shared_type = typename piece_type::shared_type;
   using container_type = detail::rope_impl::vector<
-    piece_type, SmallBufferSize
+    piece_type,
+    SmallBufferSize,
+    typename std::allocator_traits<
+      allocator_type
+    >::template rebind_alloc<piece_type>
   >;
   using small_buffer_size = typename container_type::small_buffer_size;
 
+  // the value of `hashed_size_` when there's no memoized hash //
+  using no_hash = std::integral_constant<
+    size_type,
+    std::numeric_limits<size_type>::max()
+  >;
+
+#ifndef _WIN32
+  // how many pieces `write_to_fd()` hands to each `writev` call //
+  using iovec_batch_size = std::integral_constant<
+    std::size_t,
+# if defined(IOV_MAX) && IOV_MAX < 256
+    IOV_MAX
+# else
+    256
+# endif
+  >;
+#endif // _WIN32
+
 public:
   /**
    * Default constructor. Constructs an empty rope.
@@ -492,6 +820,35 @@ public:
    */
   rope(rope &&) = default;
 
+  /**
+   * Constructs an empty rope that uses the given allocator.
+   */
+  explicit rope(allocator_type const &allocator):
+    pieces_(allocator)
+  {}
+
+  /**
+   * Constructs a rope that uses the given allocator out of the given pieces.
+   *
+   * Example:
+   *
+   *  monotonic_arena arena;
+   *  rope<8, arena_allocator<char>> hello(
+   *    std::allocator_arg, arena_allocator<char>(arena),
+   *    "hello, ", std::string("world"), '!'
+   *  );
+   */
+  template <typename... Args>
+  rope(
+    std::allocator_arg_t,
+    allocator_type const &allocator,
+    Args &&...args
+  ):
+    pieces_(allocator)
+  {
+    multi_append(std::forward<Args>(args)...);
+  }
+
   /**
    * Constructs a rope ouf of the given pieces.
    *
@@ -505,11 +862,25 @@ public:
    *
    * @author: Marcelo Juchem
    */
-  template <typename... Args, typename = safe_overload<rope, Args...>>
+  template <
+    typename... Args,
+    typename = safe_overload<rope, Args...>,
+    typename = safe_overload<allocator_type, Args...>,
+    typename = typename std::enable_if<
+      !detail::rope_impl::leads_with_allocator_arg<Args...>::value
+    >::type
+  >
   explicit rope(Args &&...args) {
     multi_append(std::forward<Args>(args)...);
   }
 
+  /**
+   * Returns a copy of the allocator used by this rope.
+   */
+  allocator_type get_allocator() const {
+    return allocator_type(pieces_.get_allocator());
+  }
+
   /**
    * The type used to represent the number of pieces stored in this rope.
    *
@@ -644,13 +1015,13 @@ public:
    *
    * @author: Marcelo Juchem
    */
-  struct const_iterator:
-    public std::iterator<
-      std::bidirectional_iterator_tag,
-      value_type,
-      difference_type
-    >
-  {
+  struct const_iterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = rope::value_type;
+    using difference_type = rope::difference_type;
+    using pointer = value_type *;
+    using reference = value_type &;
+
     explicit const_iterator(
       rope const *r,
       piece_type const *piece,
@@ -893,7 +1264,10 @@ public:
    * Returns another rope that references the contents
    * of this rope.
    *
-   * The returned rope doesn't own any of the pieces.
+   * The returned rope doesn't own any of the pieces, except for the shared
+   * ones (see `share()`) and single characters, which are copied. Shared
+   * pieces are kept alive by the returned rope, so it remains valid after
+   * this rope is gone as long as all of its pieces are shared.
    *
    * This is what the copy constructor of the rope would look like.
    *
@@ -907,19 +1281,125 @@ public:
    * TODO: BIKE-SHED
    */
   rope mimic() const {
-    rope result;
+    rope result(get_allocator());
 
     auto const pieces = pieces_.size();
 
     result.reserve(pieces, true);
 
     for (piece_index i = 0; i < pieces; ++i) {
-      result.append(pieces_[i].ref());
+      auto const &piece = pieces_[i];
+      result.append_piece(piece, piece.ref());
+    }
+
+    return result;
+  }
+
+  ///////////
+  // share //
+  ///////////
+
+  /**
+   * Moves each string piece owned by this rope into an immutable buffer
+   * with an atomic reference count, which can then be shared with other
+   * ropes without copying its contents.
+   *
+   * Ropes obtained from this one through `mimic()`, `substr()` or
+   * `concat()` keep the shared buffers alive, rather than merely
+   * referencing them. This makes it cheap to hand the same contents
+   * over to many consumers, possibly running on different threads.
+   *
+   * The contents of the strings are not copied. Pieces referenced, rather
+   * than owned, by this rope are left as they are.
+   *
+   * Example:
+   *
+   *  rope<> r("header: ", std::string(large_payload));
+   *  r.share();
+   *
+   *  for (auto &consumer: consumers) {
+   *    // `large_payload` is shared, not copied, and the string
+   *    // literal "header: " is referenced
+   *    consumer.send(r.mimic());
+   *  }
+   */
+  void share() {
+    for (piece_index i = 0, pieces = pieces_.size(); i < pieces; ++i) {
+      pieces_.share(i);
+    }
+  }
+
+  ////////////
+  // substr //
+  ////////////
+
+  /**
+   * Returns a rope representing `count` characters of this rope,
+   * starting at `offset`, or up to the end of this rope, whichever
+   * comes first.
+   *
+   * The pieces of the returned rope follow the same rules as `mimic()`:
+   * shared pieces are shared, single characters are copied and everything
+   * else is referenced. No string contents are ever copied.
+   *
+   * Throws `std::out_of_range` if `offset` is past the end of this rope.
+   *
+   * Example:
+   *
+   *  rope<> r("hello, ", std::string("world"));
+   *  r.share();
+   *
+   *  // shares the buffer holding "world"
+   *  auto world = r.substr(7, 5);
+   */
+  rope substr(size_type offset, size_type count) const {
+    if (offset > size_) {
+      throw std::out_of_range("substr(): offset out of bounds");
+    }
+
+    rope result(get_allocator());
+
+    if (count > size_ - offset) {
+      count = size_ - offset;
+    }
+
+    if (!count) {
+      return result;
+    }
+
+    auto const begin = pinpoint(offset);
+    auto index = begin.index();
+
+    for (auto ref = begin.ref(); ; ref = pieces_[++index].ref()) {
+      assert(index < pieces_.size());
+
+      if (count <= ref.size()) {
+        ref.limit(count);
+        result.append_piece(pieces_[index], ref);
+        break;
+      }
+
+      result.append_piece(pieces_[index], ref);
+      count -= ref.size();
     }
 
     return result;
   }
 
+  /**
+   * Returns a rope representing the characters of this rope from
+   * `offset` up to its end.
+   *
+   * This is the same as calling `substr(offset, size() - offset)`.
+   */
+  rope substr(size_type offset) const {
+    if (offset > size_) {
+      throw std::out_of_range("substr(): offset out of bounds");
+    }
+
+    return substr(offset, size_ - offset);
+  }
+
   ///////////////
   // push_back //
   ///////////////
@@ -932,6 +1412,10 @@ public:
    * @author: Marcelo Juchem
    */
   void push_back(char c) {
+    if (coalesce(string_view(std::addressof(c), 1))) {
+      return;
+    }
+
     pieces_.emplace_back(c, size_);
     ++size_;
   }
@@ -953,10 +1437,10 @@ public:
    *
    * @author: Marcelo Juchem
    */
-  void append(std::string &&s) {
+  void append(string_type &&s) {
     auto const size = s.size();
 
-    if (!size) {
+    if (!size || coalesce(string_view(s))) {
       return;
     }
 
@@ -964,6 +1448,32 @@ public:
     size_ += size;
   }
 
+  /**
+   * Appends the given string to the end of this rope.
+   *
+   * This overload handles temporary strings whose allocator differs from
+   * this rope's, as is the case for a `std::string` given to a rope using
+   * a custom allocator. The contents are copied into a string allocated
+   * with this rope's allocator, which then becomes owned by this rope.
+   */
+  template <
+    typename Traits,
+    typename StringAllocator,
+    typename = typename std::enable_if<
+      !std::is_same<
+        std::basic_string<char, Traits, StringAllocator>,
+        string_type
+      >::value
+    >::type
+  >
+  void append(std::basic_string<char, Traits, StringAllocator> &&s) {
+    if (s.empty()) {
+      return;
+    }
+
+    append(string_type(s.data(), s.size(), get_allocator()));
+  }
+
   /**
    * Appends a reference to the string represented by the
    * given `string_view` to the end of this rope.
@@ -973,7 +1483,7 @@ public:
   void append(string_view s) {
     auto const size = s.size();
 
-    if (!size) {
+    if (!size || coalesce(s)) {
       return;
     }
 
@@ -981,6 +1491,35 @@ public:
     size_ += size;
   }
 
+  /**
+   * Appends the contents of the given memory mapped file to the end of
+   * this rope.
+   *
+   * The mapping is shared by this rope, which keeps it alive, so the
+   * contents of the file are neither copied nor do they need to outlive
+   * this rope. Ropes obtained from this one through `mimic()`, `substr()`
+   * or `concat()` share the mapping as well.
+   *
+   * Along with `write_to_fd()`, this allows sending large files, wrapped
+   * in headers, without copying them to user space buffers.
+   *
+   * Example:
+   *
+   *  mapped_file const body("/var/www/index.html");
+   *  rope<> response("HTTP/1.1 200 OK\r\n\r\n", body);
+   *  response.write_to_fd(socket);
+   */
+  void append(mapped_file file) {
+    auto const size = file.size();
+
+    if (!size || coalesce(file.ref())) {
+      return;
+    }
+
+    pieces_.emplace_back(std::move(file), size_);
+    size_ += size;
+  }
+
   /**
    * Appends the given character to the end of this rope.
    *
@@ -1005,7 +1544,7 @@ public:
     auto s = string_view(std::forward<Args>(args)...);
     auto const size = s.size();
 
-    if (!size) {
+    if (!size || coalesce(s)) {
       return;
     }
 
@@ -1038,7 +1577,8 @@ public:
    * Concatenates the pieces of the given rope to the end of this rope.
    *
    * The pieces of `rhs` are only referenced by this rope, even those
-   * owned by `rhs`.
+   * owned by `rhs`, except for shared pieces (see `share()`), which are
+   * shared, and single characters, which are copied.
    *
    * @author: Marcelo Juchem
    */
@@ -1047,9 +1587,9 @@ public:
 
     reserve(pieces, true);
 
-    // TODO: copy pieces which are single characters
     for (piece_index i = 0; i < pieces; ++i) {
-      append(rhs.pieces_[i].ref());
+      auto const &piece = rhs.pieces_[i];
+      append_piece(piece, piece.ref());
     }
   }
 
@@ -1074,7 +1614,8 @@ public:
     reserve(pieces, true);
 
     for (piece_index i = 0; i < pieces; ++i) {
-      pieces_.emplace_back(rhs.pieces_.move(i));
+      auto const offset = size_ + rhs.pieces_[i].payload();
+      pieces_.emplace_back(rhs.pieces_.move(i), offset);
     }
 
     size_ += rhs.size_;
@@ -1188,12 +1729,12 @@ public:
    */
   template <
     typename Traits = std::char_traits<char>,
-    typename Allocator = std::allocator<char>
+    typename StringAllocator = std::allocator<char>
   >
-  std::basic_string<char, Traits, Allocator> to_string(
-    Allocator const &allocator = Allocator()
+  std::basic_string<char, Traits, StringAllocator> to_string(
+    StringAllocator const &allocator = StringAllocator()
   ) const {
-    std::string s(allocator);
+    std::basic_string<char, Traits, StringAllocator> s(allocator);
     append_to(s);
     return s;
   }
@@ -1219,9 +1760,208 @@ public:
     return out;
   }
 
+#ifndef _WIN32
+  ///////////
+  // iovec //
+  ///////////
+
+  /**
+   * Fills the output range `[begin, end)` with one `iovec` per piece of
+   * this rope, pointing at the characters in place rather than copying
+   * them. Character pieces and owned strings point into this rope.
+   *
+   * The `iovec`s remain valid until this rope is modified, moved or
+   * destroyed, or until a referenced string goes away.
+   *
+   * Returns the pointer `e`, which is one element past the last one
+   * written, such that the written range lies within `[begin, e)`.
+   *
+   * Example:
+   *
+   *  rope<> r("hello", ',', std::string(" world"));
+   *  std::array<struct iovec, 3> v;
+   *
+   *  // yields `v.data() + 3`
+   *  auto e = r.to_iovec(v.data(), v.data() + v.size());
+   */
+  struct iovec *to_iovec(struct iovec *begin, struct iovec *end) const {
+    return to_iovec(begin, end, cbegin());
+  }
+
+  /**
+   * Fills the output range `[begin, end)` with one `iovec` per piece of
+   * this rope, starting at `offset`.
+   *
+   * Returns the pointer `e`, which is one element past the last one
+   * written, such that the written range lies within `[begin, e)`.
+   */
+  struct iovec *to_iovec(
+    struct iovec *begin,
+    struct iovec *end,
+    size_type offset
+  ) const {
+    return to_iovec(begin, end, pinpoint(offset));
+  }
+
+  /**
+   * Fills the output range `[begin, end)` with one `iovec` per piece of
+   * this rope, starting at `offset`. The first `iovec` covers only the
+   * part of its piece that lies at or after `offset`.
+   *
+   * Returns the pointer `e`, which is one element past the last one
+   * written, such that the written range lies within `[begin, e)`.
+   */
+  struct iovec *to_iovec(
+    struct iovec *begin,
+    struct iovec *end,
+    const_iterator offset
+  ) const {
+    if (!offset.piece()) {
+      return begin;
+    }
+
+    auto const pieces = pieces_.size();
+    auto i = offset.index();
+    auto piece = offset.ref();
+
+    for (; begin != end; ++begin) {
+      assert(!piece.empty());
+      begin->iov_base = const_cast<char *>(piece.data());
+      begin->iov_len = piece.size();
+
+      if (++i == pieces) {
+        return ++begin;
+      }
+
+      piece = pieces_[i].ref();
+    }
+
+    return begin;
+  }
+
+  /**
+   * Writes the contents of this rope to the file descriptor `fd` with
+   * `writev`, without copying them into a contiguous buffer first.
+   *
+   * Partial writes are resumed and interrupted calls are retried, so
+   * everything is written by the time this function returns. `fd` is
+   * expected to be in blocking mode.
+   *
+   * Throws `std::system_error` if `writev` fails.
+   */
+  void write_to_fd(int fd) const {
+    std::array<struct iovec, iovec_batch_size::value> batch;
+
+    for (auto offset = cbegin(); offset.piece(); ) {
+      auto const end = to_iovec(
+        batch.data(), batch.data() + batch.size(), offset
+      );
+
+      auto const written = ::writev(
+        fd, batch.data(), static_cast<int>(end - batch.data())
+      );
+
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+
+        throw std::system_error(errno, std::system_category(), "writev");
+      }
+
+      offset += static_cast<size_type>(written);
+    }
+  }
+#endif // _WIN32
+
+  ////////////////
+  // coalescing //
+  ////////////////
+
+  /**
+   * Sets the threshold for coalescing small pieces, which is disabled
+   * (zero) by default.
+   *
+   * While coalescing is enabled, each piece appended to this rope is
+   * copied into the last piece when they have, together, no more than
+   * `threshold` characters. This keeps the number of pieces low when
+   * appending many single characters or short strings, which speeds
+   * up iterating over this rope, as well as `copy()` and `find()`, at
+   * the cost of copying at most `threshold` characters per piece.
+   *
+   * The last piece is then owned by this rope, even when the original
+   * pieces were only referenced.
+   *
+   * Only future appends are affected. Refer to `compact()` to coalesce
+   * the pieces already in this rope.
+   *
+   * Example:
+   *
+   *  rope<> r;
+   *  r.set_coalescing_threshold(64);
+   *
+   *  // a single piece holding "key=value;"
+   *  r.multi_append("key", '=', "value", ';');
+   */
+  void set_coalescing_threshold(size_type threshold) {
+    coalescing_threshold_ = threshold;
+  }
+
+  /**
+   * Returns the threshold for coalescing small pieces, or zero when
+   * coalescing is disabled. See `set_coalescing_threshold()`.
+   */
+  size_type coalescing_threshold() const { return coalescing_threshold_; }
+
+  /////////////
+  // compact //
+  /////////////
+
+  /**
+   * Merges each run of adjacent pieces that, together, have no more than
+   * `threshold` characters, into a single piece owned by this rope.
+   *
+   * Pieces larger than `threshold` are kept as they are.
+   *
+   * This is what this rope would look like had it been built with a
+   * coalescing threshold of `threshold` (see `set_coalescing_threshold()`).
+   */
+  void compact(size_type threshold) {
+    if (!threshold) {
+      return;
+    }
+
+    auto const pieces = pieces_.size();
+
+    container_type compacted(std::move(pieces_));
+    size_ = 0;
+
+    auto const configured = coalescing_threshold_;
+    coalescing_threshold_ = threshold;
+
+    for (piece_index i = 0; i < pieces; ++i) {
+      auto &&piece = compacted.move(i);
+
+      if (!coalesce(piece.ref())) {
+        auto const size = piece.size();
+        pieces_.emplace_back(std::move(piece), size_);
+        size_ += size;
+      }
+    }
+
+    coalescing_threshold_ = configured;
+  }
+
+  /**
+   * Merges runs of small pieces into single pieces, using this rope's
+   * coalescing threshold. This is the same as calling
+   * `compact(coalescing_threshold())`.
+   */
+  void compact() { compact(coalescing_threshold_); }
+
+  /////////////
+  // reserve //
   /////////////
-  // reserve //
-  /////////////
 
   /**
    * Pre-allocates space for the given number of `pieces`.
@@ -1283,6 +2023,7 @@ public:
   void clear() {
     pieces_.clear();
     size_ = 0;
+    hashed_size_ = no_hash::value;
   }
 
   /////////////
@@ -1443,19 +2184,7 @@ public:
    * @author: Marcelo Juchem
    */
   const_iterator find(char c) const {
-    for (piece_index i = 0, pieces = pieces_.size(); i < pieces; ++i) {
-      auto &piece = pieces_[i];
-      auto const ref = piece.ref();
-
-      auto const j = std::find(ref.begin(), ref.end(), c);
-
-      if (j != ref.end()) {
-        auto const off = static_cast<size_type>(std::distance(ref.begin(), j));
-        return const_iterator(this, std::addressof(piece), i, off);
-      }
-    }
-
-    return cend();
+    return find(c, cbegin());
   }
 
   /**
@@ -1474,30 +2203,68 @@ public:
    * or `end()` if not found. Beginst searching at `offset` instead
    * of searching from the beginning of the rope.
    *
+   * Each piece is scanned with `std::memchr`.
+   *
    * @author: Marcelo Juchem
    */
   const_iterator find(char c, const_iterator offset) const {
-    if (offset == cend()) {
+    return scan_forward(offset, char_scanner{c});
+  }
+
+  /**
+   * Returns an iterator to the first occurence of the string `s`
+   * or `end()` if not found. Occurences may span several pieces,
+   * and are matched without flattening the rope.
+   *
+   * An empty `s` is found at the beginning of the rope.
+   *
+   * Example:
+   *
+   *  rope<> r("Content-", "Length: 10\r", "\n\r\n");
+   *
+   *  // yields `18`
+   *  auto result = r.find("\r\n\r\n").absolute();
+   */
+  const_iterator find(string_view s) const {
+    return find(s, cbegin());
+  }
+
+  /**
+   * Returns an iterator to the first occurence of the string `s`
+   * at or after `offset`, or `end()` if not found.
+   */
+  const_iterator find(string_view s, size_type offset) const {
+    return find(s, pinpoint(offset));
+  }
+
+  /**
+   * Returns an iterator to the first occurence of the string `s`
+   * at or after `offset`, or `end()` if not found.
+   *
+   * Candidates are located by scanning for the first character of `s` with
+   * `std::memchr`, then compared piece by piece with `std::memcmp`.
+   */
+  const_iterator find(string_view s, const_iterator offset) const {
+    if (!offset.piece()) {
+      return cend();
+    }
+
+    if (s.empty()) {
       return offset;
     }
 
-    auto const pieces = pieces_.size();
-    auto piece_offset = offset.offset();
+    char_scanner const scanner{s.front()};
 
-    for (auto i = offset.index(); i < pieces; ++i, piece_offset = 0) {
-      auto const &piece = pieces_[i];
-      auto const ref = piece.ref();
-      auto const j = std::find(
-        std::next(ref.begin(), static_cast<difference_type>(piece_offset)),
-        ref.end(),
-        c
-      );
+    for (auto i = scan_forward(offset, scanner); i.piece(); ) {
+      if (size_ - i.absolute() < s.size()) {
+        break;
+      }
 
-      if (j != ref.end()) {
-        assert(i < pieces);
-        auto const off = static_cast<size_type>(std::distance(ref.begin(), j));
-        return const_iterator(this, std::addressof(pieces_[i]), i, off);
+      if (matches(i, s)) {
+        return i;
       }
+
+      i = scan_forward(++i, scanner);
     }
 
     return cend();
@@ -1507,22 +2274,259 @@ public:
   // rfind //
   ///////////
 
+  /**
+   * Returns an iterator to the last occurence of the
+   * character `c` or `end()` if not found.
+   *
+   * Example:
+   *
+   *  rope<> r("a/b", "/c");
+   *
+   *  // yields `3`
+   *  auto result = r.rfind('/').absolute();
+   */
+  const_iterator rfind(char c) const {
+    return rfind(c, cend());
+  }
+
+  /**
+   * Returns an iterator to the last occurence of the character `c`
+   * at or before `offset`, or `end()` if not found.
+   */
+  const_iterator rfind(char c, size_type offset) const {
+    return rfind(c, pinpoint(offset));
+  }
+
+  /**
+   * Returns an iterator to the last occurence of the character `c`
+   * at or before `offset`, or `end()` if not found. Searches the whole
+   * rope when `offset` is `end()`.
+   *
+   * Each piece is scanned with `memrchr` where available.
+   */
+  const_iterator rfind(char c, const_iterator offset) const {
+    return scan_backward(offset, reverse_char_scanner{c});
+  }
+
+  /**
+   * Returns an iterator to the last occurence of the
+   * string `s` or `end()` if not found.
+   *
+   * An empty `s` is found at the end of the rope.
+   */
+  const_iterator rfind(string_view s) const {
+    return rfind(s, cend());
+  }
+
+  /**
+   * Returns an iterator to the last occurence of the string `s`
+   * starting at or before `offset`, or `end()` if not found.
+   */
+  const_iterator rfind(string_view s, size_type offset) const {
+    return rfind(s, pinpoint(offset));
+  }
+
+  /**
+   * Returns an iterator to the last occurence of the string `s`
+   * starting at or before `offset`, or `end()` if not found. Searches
+   * the whole rope when `offset` is `end()`.
+   */
+  const_iterator rfind(string_view s, const_iterator offset) const {
+    if (s.size() > size_) {
+      return cend();
+    }
+
+    auto const last = std::min(offset.absolute(), size_ - s.size());
+
+    if (s.empty()) {
+      return pinpoint(last);
+    }
+
+    reverse_char_scanner const scanner{s.front()};
+
+    for (auto i = scan_backward(pinpoint(last), scanner); i.piece(); ) {
+      if (matches(i, s)) {
+        return i;
+      }
+
+      if (!i.index() && !i.offset()) {
+        break;
+      }
+
+      i = scan_backward(--i, scanner);
+    }
+
+    return cend();
+  }
+
   ///////////////////
   // find_first_of //
   ///////////////////
 
+  /**
+   * Returns an iterator to the first character that is also in
+   * `chars`, or `end()` if not found.
+   *
+   * Example:
+   *
+   *  rope<> r("key", "=value;");
+   *
+   *  // yields `3`
+   *  auto result = r.find_first_of("=;").absolute();
+   */
+  const_iterator find_first_of(string_view chars) const {
+    return find_first_of(chars, cbegin());
+  }
+
+  /**
+   * Returns an iterator to the first character at or after `offset` that
+   * is also in `chars`, or `end()` if not found.
+   */
+  const_iterator find_first_of(string_view chars, size_type offset) const {
+    return find_first_of(chars, pinpoint(offset));
+  }
+
+  /**
+   * Returns an iterator to the first character at or after `offset` that
+   * is also in `chars`, or `end()` if not found.
+   */
+  const_iterator find_first_of(
+    string_view chars,
+    const_iterator offset
+  ) const {
+    if (chars.size() == 1) {
+      return find(chars.front(), offset);
+    }
+
+    return scan_forward(offset, set_scanner<true>(chars));
+  }
+
   ///////////////////////
   // find_first_not_of //
   ///////////////////////
 
+  /**
+   * Returns an iterator to the first character that is not in
+   * `chars`, or `end()` if not found.
+   *
+   * Example:
+   *
+   *  rope<> r("  ", " value");
+   *
+   *  // yields `3`
+   *  auto result = r.find_first_not_of(" ").absolute();
+   */
+  const_iterator find_first_not_of(string_view chars) const {
+    return find_first_not_of(chars, cbegin());
+  }
+
+  /**
+   * Returns an iterator to the first character at or after `offset` that
+   * is not in `chars`, or `end()` if not found.
+   */
+  const_iterator find_first_not_of(
+    string_view chars,
+    size_type offset
+  ) const {
+    return find_first_not_of(chars, pinpoint(offset));
+  }
+
+  /**
+   * Returns an iterator to the first character at or after `offset` that
+   * is not in `chars`, or `end()` if not found.
+   */
+  const_iterator find_first_not_of(
+    string_view chars,
+    const_iterator offset
+  ) const {
+    return scan_forward(offset, set_scanner<false>(chars));
+  }
+
   //////////////////
   // find_last_of //
   //////////////////
 
+  /**
+   * Returns an iterator to the last character that is also in
+   * `chars`, or `end()` if not found.
+   *
+   * Example:
+   *
+   *  rope<> r("a/b\\", "c");
+   *
+   *  // yields `3`
+   *  auto result = r.find_last_of("/\\").absolute();
+   */
+  const_iterator find_last_of(string_view chars) const {
+    return find_last_of(chars, cend());
+  }
+
+  /**
+   * Returns an iterator to the last character at or before `offset` that
+   * is also in `chars`, or `end()` if not found.
+   */
+  const_iterator find_last_of(string_view chars, size_type offset) const {
+    return find_last_of(chars, pinpoint(offset));
+  }
+
+  /**
+   * Returns an iterator to the last character at or before `offset` that
+   * is also in `chars`, or `end()` if not found. Searches the whole rope
+   * when `offset` is `end()`.
+   */
+  const_iterator find_last_of(
+    string_view chars,
+    const_iterator offset
+  ) const {
+    if (chars.size() == 1) {
+      return rfind(chars.front(), offset);
+    }
+
+    return scan_backward(offset, reverse_set_scanner<true>(chars));
+  }
+
   //////////////////////
   // find_last_not_of //
   //////////////////////
 
+  /**
+   * Returns an iterator to the last character that is not in
+   * `chars`, or `end()` if not found.
+   *
+   * Example:
+   *
+   *  rope<> r("value", "\r\n");
+   *
+   *  // yields `4`
+   *  auto result = r.find_last_not_of("\r\n").absolute();
+   */
+  const_iterator find_last_not_of(string_view chars) const {
+    return find_last_not_of(chars, cend());
+  }
+
+  /**
+   * Returns an iterator to the last character at or before `offset` that
+   * is not in `chars`, or `end()` if not found.
+   */
+  const_iterator find_last_not_of(
+    string_view chars,
+    size_type offset
+  ) const {
+    return find_last_not_of(chars, pinpoint(offset));
+  }
+
+  /**
+   * Returns an iterator to the last character at or before `offset` that
+   * is not in `chars`, or `end()` if not found. Searches the whole rope
+   * when `offset` is `end()`.
+   */
+  const_iterator find_last_not_of(
+    string_view chars,
+    const_iterator offset
+  ) const {
+    return scan_backward(offset, reverse_set_scanner<false>(chars));
+  }
+
   /////////////////
   // operator == //
   /////////////////
@@ -1635,20 +2639,52 @@ public:
     return compare(std::forward<T>(rhs)) > 0;
   }
 
+  //////////
+  // hash //
+  //////////
+
+  /**
+   * Returns a hash of the string represented by this rope.
+   *
+   * The hash only depends on the contents of the rope, not on how they're
+   * split into pieces.
+   *
+   * Returns the memoized hash, if any (see `memoize_hash()`). Otherwise,
+   * the hash is computed from scratch.
+   */
+  size_type hash() const {
+    if (hashed_size_ == size_) {
+      return hash_;
+    }
+
+    word_hasher<size_type> inner_hasher;
+
+    for (piece_index i = 0, pieces = pieces_.size(); i < pieces; ++i) {
+      auto const piece = pieces_[i].ref();
+      inner_hasher(piece.data(), piece.size());
+    }
+
+    return *inner_hasher;
+  }
+
+  /**
+   * Computes the hash of this rope and keeps it, so that further calls
+   * to `hash()` or `hasher` return it right away. This is useful for ropes
+   * that are hashed repeatedly, like keys of caches.
+   *
+   * The memoized hash is dropped once this rope is changed.
+   */
+  void memoize_hash() {
+    hash_ = hash();
+    hashed_size_ = size_;
+  }
+
   struct hasher {
     using argument = rope;
     using result_type = std::size_t;
 
     result_type operator ()(rope const &r) const {
-      bytes_hasher<result_type> inner_hasher;
-
-      for (piece_index i = 0, pieces = r.pieces(); i < pieces; ++i) {
-        auto piece = r.piece(i);
-
-        inner_hasher(piece.begin(), piece.end());
-      }
-
-      return *inner_hasher;
+      return r.hash();
     }
   };
 
@@ -1657,6 +2693,54 @@ private:
   // IMPLEMENTATION DETAILS //
   ////////////////////////////
 
+  // appends `ref`, a portion of `piece`, sharing it when `piece` is shared
+  // or a mapped file //
+  void append_piece(piece_type const &piece, string_view ref) {
+    assert(!ref.empty());
+
+    if (auto const shared = piece.template try_get<shared_type>()) {
+      pieces_.emplace_back(shared_type(*shared, ref), size_);
+      size_ += ref.size();
+    } else if (auto const file = piece.template try_get<mapped_file>()) {
+      pieces_.emplace_back(mapped_file(*file, ref), size_);
+      size_ += ref.size();
+    } else if (piece.template is<char>()) {
+      push_back(*ref.data());
+    } else {
+      append(ref);
+    }
+  }
+
+  // copies `s` into the last piece if, together, they fit the coalescing
+  // threshold, returning whether it did so //
+  bool coalesce(string_view s) {
+    if (s.size() >= coalescing_threshold_ || pieces_.empty()) {
+      return false;
+    }
+
+    auto &back = pieces_.back();
+
+    if (back.size() + s.size() > coalescing_threshold_) {
+      return false;
+    }
+
+    if (auto const tail = back.owned()) {
+      tail->append(s.data(), s.size());
+    } else {
+      string_type merged(get_allocator());
+      merged.reserve(back.size() + s.size());
+      merged.append(back.data(), back.size());
+      merged.append(s.data(), s.size());
+
+      auto const offset = back.payload();
+      pieces_.pop_back();
+      pieces_.emplace_back(std::move(merged), offset);
+    }
+
+    size_ += s.size();
+    return true;
+  }
+
   const_iterator make_iterator(piece_index index, size_type offset) const {
     return const_iterator(this, std::addressof(pieces_[index]), index, offset);
   }
@@ -1701,6 +2785,177 @@ private:
     return const_iterator(this, nullptr, pieces, i - size_);
   }
 
+  // scanners for `scan_forward()` and `scan_backward()`: each one returns
+  // the first (or last) matching character in `[begin, end)`, or `nullptr`
+  // if none matches //
+
+  struct char_scanner {
+    char const *operator ()(char const *begin, char const *end) const {
+      return static_cast<char const *>(
+        std::memchr(begin, c, static_cast<std::size_t>(end - begin))
+      );
+    }
+
+    char c;
+  };
+
+  struct reverse_char_scanner {
+    char const *operator ()(char const *begin, char const *end) const {
+#if defined(__GLIBC__) && defined(_GNU_SOURCE)
+      return static_cast<char const *>(
+        memrchr(begin, c, static_cast<std::size_t>(end - begin))
+      );
+#else
+      while (end != begin) {
+        if (*--end == c) {
+          return end;
+        }
+      }
+
+      return nullptr;
+#endif
+    }
+
+    char c;
+  };
+
+  // matches characters that are (or aren't, when `Member` is `false`) in a
+  // set given at construction //
+  template <bool Member>
+  struct char_set {
+    explicit char_set(string_view chars) {
+      for (auto c: chars) {
+        set_[static_cast<unsigned char>(c)] = true;
+      }
+    }
+
+    bool operator ()(char c) const {
+      return set_[static_cast<unsigned char>(c)] == Member;
+    }
+
+  private:
+    bool set_[256] = {};
+  };
+
+  template <bool Member>
+  struct set_scanner: char_set<Member> {
+    using char_set<Member>::char_set;
+
+    char const *operator ()(char const *begin, char const *end) const {
+      for (; begin != end; ++begin) {
+        if ((*this)(*begin)) {
+          return begin;
+        }
+      }
+
+      return nullptr;
+    }
+
+    using char_set<Member>::operator ();
+  };
+
+  template <bool Member>
+  struct reverse_set_scanner: char_set<Member> {
+    using char_set<Member>::char_set;
+
+    char const *operator ()(char const *begin, char const *end) const {
+      while (end != begin) {
+        if ((*this)(*--end)) {
+          return end;
+        }
+      }
+
+      return nullptr;
+    }
+
+    using char_set<Member>::operator ();
+  };
+
+  // finds the first character matched by `scan` at or after `offset` //
+  template <typename Scanner>
+  const_iterator scan_forward(
+    const_iterator offset,
+    Scanner const &scan
+  ) const {
+    if (!offset.piece()) {
+      return cend();
+    }
+
+    auto piece_offset = offset.offset();
+
+    for (
+      auto i = offset.index(), pieces = pieces_.size();
+      i < pieces;
+      ++i, piece_offset = 0
+    ) {
+      auto const ref = pieces_[i].ref();
+
+      if (auto const j = scan(ref.data() + piece_offset, ref.end())) {
+        return make_iterator(i, static_cast<size_type>(j - ref.data()));
+      }
+    }
+
+    return cend();
+  }
+
+  // finds the last character matched by `scan` at or before `offset`, or
+  // in the whole rope when `offset` is past the end //
+  template <typename Scanner>
+  const_iterator scan_backward(
+    const_iterator offset,
+    Scanner const &scan
+  ) const {
+    if (pieces_.empty()) {
+      return cend();
+    }
+
+    auto i = offset.piece() ? offset.index() : pieces_.size() - 1;
+    auto ref = pieces_[i].ref();
+
+    if (offset.piece()) {
+      ref = string_view(ref.data(), offset.offset() + 1);
+    }
+
+    for (;;) {
+      if (auto const j = scan(ref.data(), ref.end())) {
+        return make_iterator(i, static_cast<size_type>(j - ref.data()));
+      }
+
+      if (!i) {
+        return cend();
+      }
+
+      ref = pieces_[--i].ref();
+    }
+  }
+
+  // tells whether `s` occurs at `i`, which must have at least `s.size()`
+  // characters after it //
+  bool matches(const_iterator i, string_view s) const {
+    assert(i.piece());
+    assert(size_ - i.absolute() >= s.size());
+
+    auto index = i.index();
+    auto ref = i.ref();
+
+    for (;;) {
+      auto const length = std::min(ref.size(), s.size());
+
+      if (std::memcmp(ref.data(), s.data(), length)) {
+        return false;
+      }
+
+      s += length;
+
+      if (s.empty()) {
+        return true;
+      }
+
+      assert(index + 1 < pieces_.size());
+      ref = pieces_[++index].ref();
+    }
+  }
+
   template <typename T, typename... Args>
   void multi_append_impl(T &&s, Args &&...args) {
     append(std::forward<T>(s));
@@ -1711,6 +2966,13 @@ private:
 
   container_type pieces_;
   size_type size_ = 0;
+
+  // ropes are only ever changed by appending to them, or by clearing them,
+  // so the memoized hash is valid for as long as the size stays the same //
+  size_type hashed_size_ = no_hash::value;
+  size_type hash_ = 0;
+
+  size_type coalescing_threshold_ = 0;
 };
 
 /////////////////
@@ -1720,9 +2982,10 @@ private:
 template <
   typename T,
   std::size_t SmallBufferSize,
-  typename = safe_overload<rope<SmallBufferSize>, T>
+  typename Allocator,
+  typename = safe_overload<rope<SmallBufferSize, Allocator>, T>
 >
-bool operator ==(T const &lhs, rope<SmallBufferSize> const &rhs) {
+bool operator ==(T const &lhs, rope<SmallBufferSize, Allocator> const &rhs) {
   return rhs.operator==(lhs);
 }
 
@@ -1733,9 +2996,10 @@ bool operator ==(T const &lhs, rope<SmallBufferSize> const &rhs) {
 template <
   typename T,
   std::size_t SmallBufferSize,
-  typename = safe_overload<rope<SmallBufferSize>, T>
+  typename Allocator,
+  typename = safe_overload<rope<SmallBufferSize, Allocator>, T>
 >
-bool operator <(T const &lhs, rope<SmallBufferSize> const &rhs) {
+bool operator <(T const &lhs, rope<SmallBufferSize, Allocator> const &rhs) {
   return rhs > lhs;
 }
 
@@ -1746,9 +3010,10 @@ bool operator <(T const &lhs, rope<SmallBufferSize> const &rhs) {
 template <
   typename T,
   std::size_t SmallBufferSize,
-  typename = safe_overload<rope<SmallBufferSize>, T>
+  typename Allocator,
+  typename = safe_overload<rope<SmallBufferSize, Allocator>, T>
 >
-bool operator >(T const &lhs, rope<SmallBufferSize> const &rhs) {
+bool operator >(T const &lhs, rope<SmallBufferSize, Allocator> const &rhs) {
   return rhs < lhs;
 }
 
@@ -1756,17 +3021,18 @@ bool operator >(T const &lhs, rope<SmallBufferSize> const &rhs) {
 // operator != //
 /////////////////
 
-template <typename T, std::size_t SmallBufferSize>
-bool operator !=(rope<SmallBufferSize> const &lhs, T const &rhs) {
+template <typename T, std::size_t SmallBufferSize, typename Allocator>
+bool operator !=(rope<SmallBufferSize, Allocator> const &lhs, T const &rhs) {
   return !(lhs == rhs);
 }
 
 template <
   typename T,
   std::size_t SmallBufferSize,
-  typename = safe_overload<rope<SmallBufferSize>, T>
+  typename Allocator,
+  typename = safe_overload<rope<SmallBufferSize, Allocator>, T>
 >
-bool operator !=(T const &lhs, rope<SmallBufferSize> const &rhs) {
+bool operator !=(T const &lhs, rope<SmallBufferSize, Allocator> const &rhs) {
   return !(rhs == lhs);
 }
 
@@ -1774,17 +3040,18 @@ bool operator !=(T const &lhs, rope<SmallBufferSize> const &rhs) {
 // operator <= //
 /////////////////
 
-template <typename T, std::size_t SmallBufferSize>
-bool operator <=(rope<SmallBufferSize> const &lhs, T const &rhs) {
+template <typename T, std::size_t SmallBufferSize, typename Allocator>
+bool operator <=(rope<SmallBufferSize, Allocator> const &lhs, T const &rhs) {
   return !(lhs > rhs);
 }
 
 template <
   typename T,
   std::size_t SmallBufferSize,
-  typename = safe_overload<rope<SmallBufferSize>, T>
+  typename Allocator,
+  typename = safe_overload<rope<SmallBufferSize, Allocator>, T>
 >
-bool operator <=(T const &lhs, rope<SmallBufferSize> const &rhs) {
+bool operator <=(T const &lhs, rope<SmallBufferSize, Allocator> const &rhs) {
   return !(rhs < lhs);
 }
 
@@ -1792,17 +3059,18 @@ bool operator <=(T const &lhs, rope<SmallBufferSize> const &rhs) {
 // operator >= //
 /////////////////
 
-template <typename T, std::size_t SmallBufferSize>
-bool operator >=(rope<SmallBufferSize> const &lhs, T const &rhs) {
+template <typename T, std::size_t SmallBufferSize, typename Allocator>
+bool operator >=(rope<SmallBufferSize, Allocator> const &lhs, T const &rhs) {
   return !(lhs < rhs);
 }
 
 template <
   typename T,
   std::size_t SmallBufferSize,
-  typename = safe_overload<rope<SmallBufferSize>, T>
+  typename Allocator,
+  typename = safe_overload<rope<SmallBufferSize, Allocator>, T>
 >
-bool operator >=(T const &lhs, rope<SmallBufferSize> const &rhs) {
+bool operator >=(T const &lhs, rope<SmallBufferSize, Allocator> const &rhs) {
   return !(rhs > lhs);
 }
 
@@ -1810,12 +3078,17 @@ bool operator >=(T const &lhs, rope<SmallBufferSize> const &rhs) {
 // operator <<(std::basic_ostream) //
 /////////////////////////////////////
 
-template <typename C, typename T, std::size_t SmallBufferSize>
+template <
+  typename C,
+  typename T,
+  std::size_t SmallBufferSize,
+  typename Allocator
+>
 std::ostream &operator <<(
   std::basic_ostream<C, T> &out,
-  rope<SmallBufferSize> const &r
+  rope<SmallBufferSize, Allocator> const &r
 ) {
-  using piece_index = typename rope<SmallBufferSize>::piece_index;
+  using piece_index = typename rope<SmallBufferSize, Allocator>::piece_index;
 
   for (piece_index i = 0, pieces = r.pieces(); i < pieces; ++i) {
     auto piece = r.piece(i);
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/string/mapped_file.h>
+
+#include <fatal/test/driver.h>
+
+#include <fatal/test/random_data.h>
+#include <fatal/test/temporary_file.h>
+
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fatal {
+
+FATAL_TEST(mapped_file, path) {
+  random_data rdg;
+  auto const contents = rdg.string(100000);
+  temporary_file file(contents);
+
+  mapped_file m(file.path());
+  FATAL_EXPECT_EQ(contents.size(), m.size());
+  FATAL_EXPECT_FALSE(m.empty());
+  FATAL_EXPECT_EQ(contents, std::string(m.data(), m.size()));
+  FATAL_EXPECT_EQ(1, m.use_count());
+
+  mapped_file c(file.path().c_str());
+  FATAL_EXPECT_EQ(contents, std::string(c.data(), c.size()));
+}
+
+FATAL_TEST(mapped_file, fd) {
+  temporary_file file("hello, world");
+
+  auto const fd = ::open(file.path().c_str(), O_RDONLY);
+  FATAL_ASSERT_LE(0, fd);
+  mapped_file m(fd);
+  ::close(fd);
+
+  // the mapping outlives the file descriptor
+  FATAL_EXPECT_EQ("hello, world", m.ref());
+}
+
+FATAL_TEST(mapped_file, empty) {
+  temporary_file file("");
+
+  mapped_file m(file.path());
+  FATAL_EXPECT_TRUE(m.empty());
+  FATAL_EXPECT_EQ(0, m.size());
+  FATAL_EXPECT_EQ(0, m.use_count());
+
+  mapped_file c(m);
+  FATAL_EXPECT_TRUE(c.empty());
+}
+
+FATAL_TEST(mapped_file, errors) {
+  FATAL_EXPECT_THROW(std::system_error) {
+    mapped_file m("/this/file/does/not/exist");
+  };
+
+  FATAL_EXPECT_THROW(std::system_error) {
+    mapped_file m("/tmp");
+  };
+
+  FATAL_EXPECT_THROW(std::system_error) {
+    mapped_file m(-1);
+  };
+}
+
+FATAL_TEST(mapped_file, share) {
+  temporary_file file("hello, world");
+
+  mapped_file m(file.path());
+  auto const data = m.data();
+
+  {
+    mapped_file c(m);
+    FATAL_EXPECT_EQ(2, m.use_count());
+    FATAL_EXPECT_TRUE(data == c.data());
+
+    mapped_file world(m, m.ref() + 7);
+    FATAL_EXPECT_EQ(3, m.use_count());
+    FATAL_EXPECT_EQ("world", world.ref());
+
+    mapped_file moved(std::move(c));
+    FATAL_EXPECT_EQ(3, m.use_count());
+    FATAL_EXPECT_TRUE(c.empty());
+    FATAL_EXPECT_EQ(0, c.use_count());
+  }
+
+  FATAL_EXPECT_EQ(1, m.use_count());
+
+  mapped_file other(file.path());
+  other = m;
+  FATAL_EXPECT_EQ(2, m.use_count());
+  FATAL_EXPECT_TRUE(data == other.data());
+
+  // the mapping outlives the first copy
+  m = mapped_file(other, other.ref() + 7);
+  FATAL_EXPECT_EQ(2, other.use_count());
+  FATAL_EXPECT_EQ("world", m.ref());
+  FATAL_EXPECT_EQ("hello, world", other.ref());
+}
+
+} // namespace fatal {
@@ -12,11 +12,25 @@
 #include <fatal/test/driver.h>
 
 #include <fatal/math/numerics.h>
+#include <fatal/test/random_data.h>
+#include <fatal/test/ref_counter.h>
+#include <fatal/test/temporary_file.h>
 #include <fatal/utility/timed_iterations.h>
 
+#include <memory>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+#ifndef _WIN32
+# include <sys/uio.h>
+# include <unistd.h>
+#endif
 
 namespace fatal {
 
@@ -763,6 +777,18 @@ FATAL_TEST(concat, one_piece) {
   FATAL_EXPECT_THROW(std::invalid_argument) { r.concat(std::move(r)); };
 }
 
+FATAL_TEST(concat, rvalue_offsets) {
+  rope<> r("hello", ',');
+  r.concat(rope<>(' ', std::string("world")));
+  FATAL_EXPECT_EQ("hello, world", r);
+
+  std::string const expected("hello, world");
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    FATAL_EXPECT_EQ(expected[i], r.at(i));
+    FATAL_EXPECT_EQ(i, r.find(expected[i], i).absolute());
+  }
+}
+
 FATAL_TEST(concat, two_pieces) {
   rope<> r;
   FATAL_EXPECT_TRUE(r.empty());
@@ -1103,6 +1129,608 @@ FATAL_TEST(string, append_to) {
 # undef TEST_IMPL
 }
 
+#ifndef _WIN32
+///////////
+// iovec //
+///////////
+
+std::string iovec_string(struct iovec const *begin, struct iovec const *end) {
+  std::string result;
+
+  for (; begin != end; ++begin) {
+    result.append(static_cast<char const *>(begin->iov_base), begin->iov_len);
+  }
+
+  return result;
+}
+
+FATAL_TEST(iovec, to_iovec) {
+# define TEST_IMPL(...) \
+  do { \
+    rope<> r(__VA_ARGS__); \
+    std::vector<struct iovec> v(r.pieces() + 1); \
+    auto const end = r.to_iovec(v.data(), v.data() + v.size()); \
+    FATAL_EXPECT_EQ(r.pieces(), unsigned_cast(end - v.data())); \
+    FATAL_EXPECT_EQ(to_string(__VA_ARGS__), iovec_string(v.data(), end)); \
+    \
+    for (auto i = r.pieces(); i--; ) { \
+      FATAL_EXPECT_TRUE(r.piece(i).data() == v[i].iov_base); \
+    } \
+  } while (false)
+
+  TEST_IMPL_SINGLE_STRING(TEST_IMPL);
+
+# undef TEST_IMPL
+}
+
+FATAL_TEST(iovec, to_iovec_offset) {
+# define TEST_IMPL(...) \
+  do { \
+    rope<> r(__VA_ARGS__); \
+    auto const s = to_string(__VA_ARGS__); \
+    std::vector<struct iovec> v(r.pieces()); \
+    \
+    for (auto offset = s.size() + 1; offset--; ) { \
+      auto const end = r.to_iovec(v.data(), v.data() + v.size(), offset); \
+      FATAL_EXPECT_EQ(s.substr(offset), iovec_string(v.data(), end)); \
+      \
+      auto const i = std::next(r.begin(), signed_cast(offset)); \
+      auto const e = r.to_iovec(v.data(), v.data() + v.size(), i); \
+      FATAL_EXPECT_EQ(s.substr(offset), iovec_string(v.data(), e)); \
+    } \
+  } while (false)
+
+  TEST_IMPL_SINGLE_STRING(TEST_IMPL);
+
+# undef TEST_IMPL
+}
+
+FATAL_TEST(iovec, to_iovec_short_output) {
+  rope<> r("hello", ',', std::string(" world"), "!");
+  std::vector<struct iovec> v(2);
+
+  auto end = r.to_iovec(v.data(), v.data() + v.size());
+  FATAL_EXPECT_EQ(v.data() + 2, end);
+  FATAL_EXPECT_EQ("hello,", iovec_string(v.data(), end));
+
+  end = r.to_iovec(v.data(), v.data() + v.size(), 3);
+  FATAL_EXPECT_EQ(v.data() + 2, end);
+  FATAL_EXPECT_EQ("lo,", iovec_string(v.data(), end));
+
+  end = r.to_iovec(v.data(), v.data(), 3);
+  FATAL_EXPECT_EQ(v.data(), end);
+}
+
+// writes `r` to a pipe and returns what's read from the other end //
+template <std::size_t SmallBufferSize>
+std::string write_to_pipe(rope<SmallBufferSize> const &r) {
+  int fds[2];
+  FATAL_ASSERT_EQ(0, ::pipe(fds));
+
+  std::string result;
+  std::thread reader([&] {
+    char buffer[4096];
+
+    for (;;) {
+      auto const size = ::read(fds[0], buffer, sizeof(buffer));
+
+      if (size <= 0) {
+        break;
+      }
+
+      result.append(buffer, static_cast<std::size_t>(size));
+    }
+  });
+
+  r.write_to_fd(fds[1]);
+  ::close(fds[1]);
+  reader.join();
+  ::close(fds[0]);
+
+  return result;
+}
+
+FATAL_TEST(iovec, write_to_fd) {
+# define TEST_IMPL(...) \
+  do { \
+    rope<> r(__VA_ARGS__); \
+    FATAL_EXPECT_EQ(to_string(__VA_ARGS__), write_to_pipe(r)); \
+  } while (false)
+
+  TEST_IMPL_SINGLE_STRING(TEST_IMPL);
+
+# undef TEST_IMPL
+}
+
+FATAL_TEST(iovec, write_to_fd_large) {
+  // more pieces than a single `writev` takes, and more characters than
+  // a pipe buffers, so writes are both batched and partial
+  random_data rdg;
+  std::vector<std::string> strings;
+  rope<> r;
+  std::string expected;
+
+  for (std::size_t i = 0; i < 2000; ++i) {
+    strings.push_back(rdg.string(1 + i % 200));
+  }
+
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    switch (i % 3) {
+      case 0: r.append(strings[i]); break;
+      case 1: r.append(std::string(strings[i])); break;
+      default: r.append(strings[i].front()); break;
+    }
+
+    expected.append(i % 3 == 2 ? strings[i].substr(0, 1) : strings[i]);
+  }
+
+  FATAL_EXPECT_EQ(expected, write_to_pipe(r));
+}
+
+FATAL_TEST(iovec, write_to_fd_error) {
+  rope<> r("hello");
+  FATAL_EXPECT_THROW(std::system_error) {
+    r.write_to_fd(-1);
+  };
+}
+
+/////////////////
+// mapped_file //
+/////////////////
+
+FATAL_TEST(mapped_file, append) {
+  random_data rdg;
+  auto const contents = rdg.string(100000);
+  temporary_file file(contents);
+
+  rope<> r;
+  std::string expected("header\r\n");
+
+  {
+    mapped_file const body(file.path());
+    r.multi_append("header", '\r', '\n', body);
+    FATAL_EXPECT_EQ(2, body.use_count());
+    FATAL_EXPECT_TRUE(body.data() == r.piece(3).data());
+  }
+
+  // the rope keeps the mapping alive
+  expected.append(contents);
+  FATAL_EXPECT_EQ(expected, r);
+  FATAL_EXPECT_EQ(expected, write_to_pipe(r));
+
+  r.append(mapped_file(file.path()));
+  expected.append(contents);
+  FATAL_EXPECT_EQ(expected, r);
+  FATAL_EXPECT_EQ(5, r.pieces());
+
+  // empty files are skipped
+  temporary_file empty("");
+  r.append(mapped_file(empty.path()));
+  FATAL_EXPECT_EQ(5, r.pieces());
+}
+
+FATAL_TEST(mapped_file, share) {
+  temporary_file file("hello, world");
+
+  std::unique_ptr<rope<>> r(new rope<>(mapped_file(file.path()), '!'));
+  auto const data = r->piece(0).data();
+
+  auto m = r->mimic();
+  auto world = r->substr(7);
+
+  rope<> c;
+  c.concat(*r);
+
+  r.reset();
+
+  FATAL_EXPECT_EQ("hello, world!", m);
+  FATAL_EXPECT_TRUE(data == m.piece(0).data());
+  FATAL_EXPECT_EQ("world!", world);
+  FATAL_EXPECT_TRUE(data + 7 == world.piece(0).data());
+  FATAL_EXPECT_EQ("hello, world!", c);
+  FATAL_EXPECT_TRUE(data == c.piece(0).data());
+
+  // moving the pieces keeps the mapping
+  rope<> moved;
+  moved.concat(std::move(m));
+  FATAL_EXPECT_EQ("hello, world!", moved);
+}
+
+FATAL_TEST(mapped_file, coalescing) {
+  temporary_file file("small");
+
+  rope<> r("a ");
+  r.set_coalescing_threshold(16);
+  r.append(mapped_file(file.path()));
+
+  FATAL_EXPECT_EQ("a small", r);
+  FATAL_EXPECT_EQ(1, r.pieces());
+}
+
+#endif // _WIN32
+
+///////////////
+// allocator //
+///////////////
+
+using arena_rope = rope<4, arena_allocator<char>>;
+
+FATAL_TEST(allocator, default) {
+  rope<> r;
+  FATAL_EXPECT_SAME<std::allocator<char>, decltype(r.get_allocator())>();
+  FATAL_EXPECT_SAME<std::string, rope<>::string_type>();
+}
+
+FATAL_TEST(allocator, arena) {
+  monotonic_arena arena;
+  arena_rope r{arena_allocator<char>(arena)};
+  FATAL_EXPECT_TRUE(arena_allocator<char>(arena) == r.get_allocator());
+  FATAL_EXPECT_EQ(0, arena.blocks());
+
+  std::string const long_string(
+    "a string that doesn't fit in the small string buffer"
+  );
+  std::string expected;
+
+  for (std::size_t i = 0; i < 10; ++i) {
+    r.append("hello");
+    r.append(',');
+    r.append(std::string(long_string));
+    r.append(arena_rope::string_type(long_string.data(), r.get_allocator()));
+    expected.append("hello,");
+    expected.append(long_string);
+    expected.append(long_string);
+  }
+
+  FATAL_EXPECT_EQ(40, r.pieces());
+  FATAL_EXPECT_EQ(expected, r);
+  FATAL_EXPECT_LT(0, arena.blocks());
+
+  auto m = r.mimic();
+  FATAL_EXPECT_TRUE(r.get_allocator() == m.get_allocator());
+  FATAL_EXPECT_EQ(expected, m);
+}
+
+FATAL_TEST(allocator, ctor) {
+  monotonic_arena arena;
+  std::string s(" this is");
+
+  arena_rope r(
+    std::allocator_arg, arena_allocator<char>(arena),
+    "hello", ',', std::string(" world!"), s, std::string(" a test.")
+  );
+
+  FATAL_EXPECT_TRUE(arena_allocator<char>(arena) == r.get_allocator());
+  FATAL_EXPECT_EQ("hello, world! this is a test.", r);
+}
+
+///////////
+// share //
+///////////
+
+FATAL_TEST(share, mimic) {
+  std::string const long_string(
+    "a string that doesn't fit in the small string buffer"
+  );
+  std::string const referenced("referenced");
+
+  std::unique_ptr<rope<>> r(
+    new rope<>(std::string(long_string), ',', referenced)
+  );
+  auto const data = r->piece(0).data();
+
+  r->share();
+  FATAL_EXPECT_EQ(long_string + ',' + referenced, *r);
+  FATAL_EXPECT_TRUE(data == r->piece(0).data());
+  FATAL_EXPECT_TRUE(referenced.data() == r->piece(2).data());
+
+  // sharing is idempotent
+  r->share();
+  FATAL_EXPECT_TRUE(data == r->piece(0).data());
+
+  auto m = r->mimic();
+  FATAL_EXPECT_TRUE(data == m.piece(0).data());
+  FATAL_EXPECT_TRUE(referenced.data() == m.piece(2).data());
+  FATAL_EXPECT_FALSE(r->piece(1).data() == m.piece(1).data());
+
+  // the shared buffer outlives the rope that created it
+  r.reset();
+  FATAL_EXPECT_EQ(long_string + ',' + referenced, m);
+  FATAL_EXPECT_TRUE(data == m.piece(0).data());
+}
+
+FATAL_TEST(share, concat) {
+  std::string const long_string(
+    "a string that doesn't fit in the small string buffer"
+  );
+
+  rope<> r;
+
+  {
+    rope<> source("hello", std::string(long_string));
+    source.share();
+    r.concat(source);
+    r.concat(source);
+  }
+
+  FATAL_EXPECT_EQ("hello" + long_string + "hello" + long_string, r);
+  FATAL_EXPECT_TRUE(r.piece(1).data() == r.piece(3).data());
+
+  // shared pieces can be concatenated into the rope sharing them
+  r.concat(r);
+  FATAL_EXPECT_EQ(8, r.pieces());
+  FATAL_EXPECT_TRUE(r.piece(1).data() == r.piece(7).data());
+}
+
+FATAL_TEST(share, threads) {
+  std::string const long_string(
+    "a string that doesn't fit in the small string buffer"
+  );
+
+  rope<> r((std::string(long_string)));
+  r.share();
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&r, copy = r.mimic()]() mutable {
+      for (std::size_t j = 0; j < 1000; ++j) {
+        auto sub = copy.mimic().substr(j % 4);
+        copy.clear();
+        copy.concat(r.substr(0, j % 4));
+        copy.concat(std::move(sub));
+      }
+    });
+  }
+
+  for (auto &thread: threads) {
+    thread.join();
+  }
+
+  FATAL_EXPECT_EQ(long_string, r);
+}
+
+////////////
+// substr //
+////////////
+
+FATAL_TEST(substr, substr) {
+  random_data rdg;
+
+  for (std::size_t round = 0; round < 100; ++round) {
+    std::string s;
+    std::vector<std::string> owned;
+    owned.reserve(6);
+    rope<> r;
+
+    for (auto pieces = rdg() % 6; pieces--; ) {
+      auto piece = rdg.string(1 + rdg() % 20);
+      s.append(piece);
+
+      switch (rdg() % 3) {
+        case 0:
+          r.append(std::string(piece));
+          break;
+
+        case 1:
+          r.push_back(piece.front());
+          s.resize(s.size() - piece.size() + 1);
+          break;
+
+        default:
+          owned.push_back(std::move(piece));
+          r.append(owned.back());
+          break;
+      }
+    }
+
+    if (rdg() % 2) {
+      r.share();
+    }
+
+    for (std::size_t offset = 0; offset <= s.size(); ++offset) {
+      FATAL_EXPECT_EQ(s.substr(offset), r.substr(offset));
+
+      for (std::size_t count = 0; count <= s.size() - offset + 1; ++count) {
+        auto const sub = r.substr(offset, count);
+        FATAL_EXPECT_EQ(s.substr(offset, count), sub);
+        FATAL_EXPECT_EQ(s.substr(offset, count), sub.to_string());
+      }
+    }
+
+    FATAL_EXPECT_THROW(std::out_of_range) { r.substr(s.size() + 1); };
+    FATAL_EXPECT_THROW(std::out_of_range) { r.substr(s.size() + 1, 0); };
+  }
+}
+
+FATAL_TEST(substr, shared) {
+  std::string const long_string(
+    "a string that doesn't fit in the small string buffer"
+  );
+
+  rope<> sub;
+
+  {
+    rope<> r("hello", std::string(long_string), ',');
+    r.share();
+    sub.concat(r.substr(3, long_string.size()));
+    FATAL_EXPECT_TRUE(r.piece(1).data() == sub.piece(1).data());
+  }
+
+  FATAL_EXPECT_EQ("lo" + long_string.substr(0, long_string.size() - 2), sub);
+}
+
+////////////////
+// coalescing //
+////////////////
+
+// checks that `r` represents `s`, with no two adjacent pieces that
+// would fit together in `threshold` characters //
+template <typename Rope>
+void check_coalesced(
+  std::string const &s,
+  Rope const &r,
+  std::size_t threshold
+) {
+  FATAL_EXPECT_EQ(s, r);
+  FATAL_EXPECT_EQ(s, r.to_string());
+
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    FATAL_EXPECT_EQ(s[i], r.at(i));
+    FATAL_EXPECT_EQ(i, r.find(s[i], i).absolute());
+  }
+
+  for (typename Rope::piece_index i = 1; i < r.pieces(); ++i) {
+    FATAL_EXPECT_LT(threshold, r.piece(i - 1).size() + r.piece(i).size());
+  }
+}
+
+FATAL_TEST(coalescing, disabled) {
+  rope<> r;
+  FATAL_EXPECT_EQ(0, r.coalescing_threshold());
+
+  r.multi_append('a', 'b', "c", std::string("d"));
+  FATAL_EXPECT_EQ("abcd", r);
+  FATAL_EXPECT_EQ(4, r.pieces());
+}
+
+FATAL_TEST(coalescing, characters) {
+  rope<> r;
+  r.set_coalescing_threshold(8);
+  FATAL_EXPECT_EQ(8, r.coalescing_threshold());
+
+  std::string expected;
+  for (char c = 'a'; c <= 'z'; ++c) {
+    r.push_back(c);
+    expected.push_back(c);
+  }
+
+  check_coalesced(expected, r, 8);
+  FATAL_EXPECT_EQ(4, r.pieces());
+  FATAL_EXPECT_EQ("abcdefgh", r.piece(0));
+  FATAL_EXPECT_EQ("yz", r.piece(3));
+}
+
+FATAL_TEST(coalescing, pieces) {
+  std::string const large("a string larger than the threshold");
+  std::string const small("small");
+
+  rope<> r;
+  r.set_coalescing_threshold(16);
+
+  r.append(small);
+  FATAL_EXPECT_TRUE(small.data() == r.piece(0).data());
+
+  r.append(',');
+  r.append(std::string(" owned"));
+  r.append(large);
+  r.append(small);
+  r.append(std::string(large));
+  r.append(small);
+  r.append(small);
+  r.append(small);
+  r.append(small);
+
+  check_coalesced(
+    small + ", owned" + large + small + large + small + small + small + small,
+    r,
+    16
+  );
+  FATAL_EXPECT_EQ(6, r.pieces());
+
+  // large pieces are still referenced
+  FATAL_EXPECT_TRUE(large.data() == r.piece(1).data());
+  FATAL_EXPECT_EQ(small + ", owned", r.piece(0));
+  FATAL_EXPECT_EQ(small + small + small, r.piece(4));
+}
+
+FATAL_TEST(coalescing, shared) {
+  rope<> r("hello");
+  r.share();
+  r.set_coalescing_threshold(16);
+
+  auto m = r.mimic();
+  r.append(", world");
+
+  check_coalesced("hello, world", r, 16);
+  FATAL_EXPECT_EQ(1, r.pieces());
+  FATAL_EXPECT_EQ("hello", m);
+}
+
+FATAL_TEST(coalescing, compact) {
+  random_data rdg;
+
+  for (std::size_t round = 0; round < 100; ++round) {
+    std::string expected;
+    std::vector<std::string> owned;
+    owned.reserve(100);
+
+    rope<> r;
+
+    for (auto pieces = rdg() % 100; pieces--; ) {
+      auto piece = rdg.string(1 + rdg() % 20);
+      expected.append(piece);
+
+      switch (rdg() % 3) {
+        case 0:
+          r.append(std::string(piece));
+          break;
+
+        case 1:
+          r.push_back(piece.front());
+          expected.resize(expected.size() - piece.size() + 1);
+          break;
+
+        default:
+          owned.push_back(std::move(piece));
+          r.append(owned.back());
+          break;
+      }
+    }
+
+    auto const threshold = rdg() % 32;
+    r.compact(threshold);
+
+    check_coalesced(expected, r, threshold);
+    FATAL_EXPECT_EQ(0, r.coalescing_threshold());
+  }
+}
+
+FATAL_TEST(coalescing, compact_configured) {
+  rope<> r('a', 'b', 'c', "def", 'g');
+  FATAL_EXPECT_EQ(5, r.pieces());
+
+  r.compact();
+  FATAL_EXPECT_EQ(5, r.pieces());
+
+  r.set_coalescing_threshold(4);
+  r.compact();
+  check_coalesced("abcdefg", r, 4);
+  FATAL_EXPECT_EQ(2, r.pieces());
+}
+
+FATAL_TEST(coalescing, compact_moves_pieces_once) {
+  using refc = ref_counter<>;
+  refc::guard guard;
+
+  {
+    detail::rope_impl::vector<refc, 4> pieces;
+
+    for (auto i = 6; i--; ) {
+      pieces.emplace_back();
+    }
+
+    // what `compact()` does with the pieces before coalescing them //
+    detail::rope_impl::vector<refc, 4> moved(std::move(pieces));
+    FATAL_EXPECT_EQ(0, pieces.size());
+    FATAL_EXPECT_EQ(6, moved.size());
+    FATAL_EXPECT_EQ(6, refc::alive());
+    FATAL_EXPECT_EQ(6, refc::valid());
+  }
+
+  FATAL_EXPECT_EQ(0, refc::alive());
+  FATAL_EXPECT_EQ(0, refc::valid());
+}
+
 //////////////
 // capacity //
 //////////////
@@ -1539,21 +2167,20 @@ FATAL_TEST(clear, many) {
 // find //
 //////////
 
+// calls `fn(s, r, alphabet)` for random strings `s` of up to `max_size`
+// characters from `alphabet`, with `r` holding `s` chopped into random
+// pieces //
 template <typename T>
-void find_char_test(
+void find_test(
   std::chrono::milliseconds time,
   std::size_t minimum_iterations,
+  std::size_t max_size,
+  std::string const &alphabet,
   T &&fn
 ) {
-  std::string const alphabet(
-    "0123456789"
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-    "abcdefghijklmnopqrstuvwxyz"
-  );
-
   random_data rdg;
 
-  for (std::size_t size = 30; size; --size) {
+  for (std::size_t size = max_size; size; --size) {
     std::string s(size, '\0');
     rdg.string(s.begin(), s.end(), alphabet.data(), alphabet.size());
 
@@ -1574,9 +2201,27 @@ void find_char_test(
   }
 }
 
+template <typename T>
+void find_char_test(
+  std::chrono::milliseconds time,
+  std::size_t minimum_iterations,
+  std::size_t max_size,
+  T &&fn
+) {
+  find_test(
+    time,
+    minimum_iterations,
+    max_size,
+    "0123456789"
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz",
+    std::forward<T>(fn)
+  );
+}
+
 FATAL_TEST(find, char) {
   find_char_test(
-    std::chrono::milliseconds(100), 1000,
+    std::chrono::milliseconds(100), 1000, 30,
     [](
       std::string const &s,
       rope<> const &r,
@@ -1599,7 +2244,7 @@ FATAL_TEST(find, char) {
 
 FATAL_TEST(find, char_size_type) {
   find_char_test(
-    std::chrono::milliseconds(100), 1000,
+    std::chrono::milliseconds(100), 1000, 30,
     [](
       std::string const &s,
       rope<> const &r,
@@ -1624,7 +2269,7 @@ FATAL_TEST(find, char_size_type) {
 
 FATAL_TEST(find, char_const_iterator) {
   find_char_test(
-    std::chrono::milliseconds(100), 1000,
+    std::chrono::milliseconds(100), 1000, 30,
     [](
       std::string const &s,
       rope<> const &r,
@@ -1650,57 +2295,258 @@ FATAL_TEST(find, char_const_iterator) {
   );
 }
 
-/* TODO: IMPLEMENT
-FATAL_TEST(find, TODO) {
-  // TODO: IMPLEMENT
-  FATAL_EXPECT_UNREACHABLE();
+// the result of a search in a `std::string`, as the absolute position of
+// the equivalent search in a rope //
+std::size_t rope_position(std::string const &s, std::size_t position) {
+  return position == std::string::npos ? s.size() : position;
+}
+
+// every string of up to 3 characters from `alphabet` //
+std::vector<std::string> all_needles(std::string const &alphabet) {
+  std::vector<std::string> result{std::string()};
+
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    if (result[i].size() < 3) {
+      for (auto c: alphabet) {
+        result.push_back(result[i] + c);
+      }
+    }
+  }
+
+  return result;
+}
+
+// the alphabet for string searches: small, so that needles match often //
+std::string const small_alphabet("abc");
+
+FATAL_TEST(find, string) {
+  auto const needles = all_needles(small_alphabet + 'd');
+
+  find_test(
+    std::chrono::milliseconds(1), 10, 12, small_alphabet,
+    [&](std::string const &s, rope<> const &r, std::string const &) {
+      for (auto const &needle: needles) {
+        FATAL_EXPECT_EQ(
+          rope_position(s, s.find(needle)),
+          r.find(string_view(needle)).absolute()
+        );
+
+        for (auto offset = s.size() + 2; offset--; ) {
+          FATAL_EXPECT_EQ(
+            rope_position(s, s.find(needle, offset)),
+            r.find(string_view(needle), offset).absolute()
+          );
+        }
+
+        for (auto offset = s.size() + 1; offset--; ) {
+          auto const i = std::next(r.begin(), signed_cast(offset));
+          FATAL_EXPECT_EQ(
+            rope_position(s, s.find(needle, offset)),
+            r.find(string_view(needle), i).absolute()
+          );
+        }
+      }
+    }
+  );
+}
+
+FATAL_TEST(find, across_pieces) {
+  rope<> r("Content-", "Length: 10\r", '\n', "\r", "\nbody");
+  FATAL_EXPECT_EQ(18, r.find("\r\n\r\n").absolute());
+  FATAL_EXPECT_EQ(6, r.find("t-Len").absolute());
+  FATAL_EXPECT_EQ(r.end(), r.find("\r\n\r\r"));
+  FATAL_EXPECT_EQ(r.end(), r.find("bodyx"));
+  FATAL_EXPECT_EQ(22, r.find("body").absolute());
+  FATAL_EXPECT_EQ(0, r.find("").absolute());
+
+  rope<> empty;
+  FATAL_EXPECT_EQ(empty.end(), empty.find("x"));
+  FATAL_EXPECT_EQ(empty.end(), empty.find(""));
+  FATAL_EXPECT_EQ(empty.end(), empty.rfind("x"));
+  FATAL_EXPECT_EQ(empty.end(), empty.rfind('x'));
+  FATAL_EXPECT_EQ(empty.end(), empty.find_first_of("xy"));
+  FATAL_EXPECT_EQ(empty.end(), empty.find_last_not_of("xy"));
 }
 
 ///////////
 // rfind //
 ///////////
 
-FATAL_TEST(rfind, TODO) {
-  // TODO: IMPLEMENT
-  FATAL_EXPECT_UNREACHABLE();
+FATAL_TEST(rfind, char) {
+  find_char_test(
+    std::chrono::milliseconds(1), 10, 12,
+    [](std::string const &s, rope<> const &r, std::string const &alphabet) {
+      for (auto c: alphabet) {
+        FATAL_EXPECT_EQ(rope_position(s, s.rfind(c)), r.rfind(c).absolute());
+
+        for (auto offset = s.size() + 2; offset--; ) {
+          FATAL_EXPECT_EQ(
+            rope_position(s, s.rfind(c, offset)),
+            r.rfind(c, offset).absolute()
+          );
+        }
+
+        for (auto offset = s.size() + 1; offset--; ) {
+          auto const i = std::next(r.begin(), signed_cast(offset));
+          FATAL_EXPECT_EQ(
+            rope_position(s, s.rfind(c, offset)),
+            r.rfind(c, i).absolute()
+          );
+        }
+      }
+    }
+  );
+}
+
+FATAL_TEST(rfind, string) {
+  auto const needles = all_needles(small_alphabet + 'd');
+
+  find_test(
+    std::chrono::milliseconds(1), 10, 12, small_alphabet,
+    [&](std::string const &s, rope<> const &r, std::string const &) {
+      for (auto const &needle: needles) {
+        FATAL_EXPECT_EQ(
+          rope_position(s, s.rfind(needle)),
+          r.rfind(string_view(needle)).absolute()
+        );
+
+        for (auto offset = s.size() + 2; offset--; ) {
+          FATAL_EXPECT_EQ(
+            rope_position(s, s.rfind(needle, offset)),
+            r.rfind(string_view(needle), offset).absolute()
+          );
+        }
+
+        for (auto offset = s.size() + 1; offset--; ) {
+          auto const i = std::next(r.begin(), signed_cast(offset));
+          FATAL_EXPECT_EQ(
+            rope_position(s, s.rfind(needle, offset)),
+            r.rfind(string_view(needle), i).absolute()
+          );
+        }
+      }
+    }
+  );
+}
+
+// calls `fn(s, r, chars)` for every subset `chars` of the characters in
+// `s`'s alphabet, plus one that's never in `s` //
+template <typename T>
+void find_set_test(T &&fn) {
+  find_test(
+    std::chrono::milliseconds(1), 10, 12, small_alphabet,
+    [&](std::string const &s, rope<> const &r, std::string const &) {
+      auto const alphabet = small_alphabet + 'd';
+
+      for (std::size_t mask = 0; mask < (1u << alphabet.size()); ++mask) {
+        std::string chars;
+        for (std::size_t i = 0; i < alphabet.size(); ++i) {
+          if (mask & (1u << i)) {
+            chars.push_back(alphabet[i]);
+          }
+        }
+
+        fn(s, r, chars);
+      }
+    }
+  );
 }
 
 ///////////////////
 // find_first_of //
 ///////////////////
 
-FATAL_TEST(find_first_of, TODO) {
-  // TODO: IMPLEMENT
-  FATAL_EXPECT_UNREACHABLE();
+FATAL_TEST(find_first_of, find_first_of) {
+  find_set_test(
+    [](std::string const &s, rope<> const &r, std::string const &chars) {
+      string_view const set(chars);
+
+      FATAL_EXPECT_EQ(
+        rope_position(s, s.find_first_of(chars)),
+        r.find_first_of(set).absolute()
+      );
+
+      for (auto offset = s.size() + 2; offset--; ) {
+        FATAL_EXPECT_EQ(
+          rope_position(s, s.find_first_of(chars, offset)),
+          r.find_first_of(set, offset).absolute()
+        );
+      }
+    }
+  );
 }
 
 ///////////////////////
 // find_first_not_of //
 ///////////////////////
 
-FATAL_TEST(find_first_not_of, TODO) {
-  // TODO: IMPLEMENT
-  FATAL_EXPECT_UNREACHABLE();
+FATAL_TEST(find_first_not_of, find_first_not_of) {
+  find_set_test(
+    [](std::string const &s, rope<> const &r, std::string const &chars) {
+      string_view const set(chars);
+
+      FATAL_EXPECT_EQ(
+        rope_position(s, s.find_first_not_of(chars)),
+        r.find_first_not_of(set).absolute()
+      );
+
+      for (auto offset = s.size() + 2; offset--; ) {
+        FATAL_EXPECT_EQ(
+          rope_position(s, s.find_first_not_of(chars, offset)),
+          r.find_first_not_of(set, offset).absolute()
+        );
+      }
+    }
+  );
 }
 
 //////////////////
 // find_last_of //
 //////////////////
 
-FATAL_TEST(find_last_of, TODO) {
-  // TODO: IMPLEMENT
-  FATAL_EXPECT_UNREACHABLE();
+FATAL_TEST(find_last_of, find_last_of) {
+  find_set_test(
+    [](std::string const &s, rope<> const &r, std::string const &chars) {
+      string_view const set(chars);
+
+      FATAL_EXPECT_EQ(
+        rope_position(s, s.find_last_of(chars)),
+        r.find_last_of(set).absolute()
+      );
+
+      for (auto offset = s.size() + 2; offset--; ) {
+        FATAL_EXPECT_EQ(
+          rope_position(s, s.find_last_of(chars, offset)),
+          r.find_last_of(set, offset).absolute()
+        );
+      }
+    }
+  );
 }
 
 //////////////////////
 // find_last_not_of //
 //////////////////////
 
-FATAL_TEST(find_last_not_of, TODO) {
-  // TODO: IMPLEMENT
-  FATAL_EXPECT_UNREACHABLE();
+FATAL_TEST(find_last_not_of, find_last_not_of) {
+  find_set_test(
+    [](std::string const &s, rope<> const &r, std::string const &chars) {
+      string_view const set(chars);
+
+      FATAL_EXPECT_EQ(
+        rope_position(s, s.find_last_not_of(chars)),
+        r.find_last_not_of(set).absolute()
+      );
+
+      for (auto offset = s.size() + 2; offset--; ) {
+        FATAL_EXPECT_EQ(
+          rope_position(s, s.find_last_not_of(chars, offset)),
+          r.find_last_not_of(set, offset).absolute()
+        );
+      }
+    }
+  );
 }
-*/
 
 ///////////////
 // iterators //
@@ -1952,6 +2798,62 @@ FATAL_TEST(rope, hasher) {
 # undef TEST_IMPL
 }
 
+FATAL_TEST(rope, hash_split) {
+  random_data rdg;
+
+  for (std::size_t size = 0; size < 100; ++size) {
+    auto const s = rdg.string(size);
+    auto const expected = *word_hasher<>()(s.data(), s.size());
+
+    rope<> r;
+    for (std::size_t offset = 0; offset < s.size(); ) {
+      auto const count = std::min(1 + rdg() % 12, s.size() - offset);
+      r.append(s.data() + offset, count);
+      offset += count;
+    }
+
+    FATAL_EXPECT_EQ(expected, r.hash());
+    FATAL_EXPECT_EQ(expected, rope<>::hasher()(r));
+    FATAL_EXPECT_EQ(expected, rope<>(s).hash());
+  }
+}
+
+FATAL_TEST(rope, memoize_hash) {
+  rope<> r("hello", ',');
+  auto const hello = r.hash();
+
+  r.memoize_hash();
+  FATAL_EXPECT_EQ(hello, r.hash());
+  FATAL_EXPECT_EQ(hello, rope<>::hasher()(r));
+
+  r.append(std::string(" world"));
+  auto const world = r.hash();
+  FATAL_EXPECT_EQ(rope<>("hello, world").hash(), world);
+  FATAL_EXPECT_NE(hello, world);
+
+  r.memoize_hash();
+  r.share();
+  FATAL_EXPECT_EQ(world, r.hash());
+
+  r.clear();
+  FATAL_EXPECT_EQ(rope<>().hash(), r.hash());
+
+  r.append("hello,");
+  r.memoize_hash();
+  FATAL_EXPECT_EQ(hello, r.hash());
+
+  // a different string of the same size
+  r.clear();
+  r.append("jello,");
+  FATAL_EXPECT_EQ(rope<>("jello,").hash(), r.hash());
+  FATAL_EXPECT_NE(hello, r.hash());
+
+  // the memoized hash follows the rope when it's moved
+  r.memoize_hash();
+  rope<> moved(std::move(r));
+  FATAL_EXPECT_EQ(rope<>("jello,").hash(), moved.hash());
+}
+
 /////////////
 // ostream //
 /////////////
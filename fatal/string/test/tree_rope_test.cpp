@@ -0,0 +1,371 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/string/tree_rope.h>
+
+#include <fatal/test/driver.h>
+
+#include <fatal/math/numerics.h>
+#include <fatal/test/random_data.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fatal {
+
+// checks every accessor of `r` against the string `s` it should represent
+void check(std::string const &s, tree_rope const &r) {
+  FATAL_EXPECT_EQ(s.size(), r.size());
+  FATAL_EXPECT_EQ(s.empty(), r.empty());
+  FATAL_EXPECT_EQ(s, r.to_string());
+  FATAL_EXPECT_EQ(s, r);
+  FATAL_EXPECT_EQ(0, r.compare(s));
+
+  std::string pieces;
+  for (tree_rope::piece_index i = 0; i < r.pieces(); ++i) {
+    auto const piece = r.piece(i);
+    FATAL_EXPECT_FALSE(piece.empty());
+    pieces.append(piece.begin(), piece.end());
+  }
+  FATAL_EXPECT_EQ(s, pieces);
+
+  std::string forward(r.begin(), r.end());
+  FATAL_EXPECT_EQ(s, forward);
+
+  std::string backward;
+  for (auto i = r.end(); i != r.begin(); ) {
+    backward.push_back(*--i);
+  }
+  FATAL_EXPECT_EQ(std::string(s.rbegin(), s.rend()), backward);
+
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    FATAL_EXPECT_EQ(s[i], r[i]);
+    FATAL_EXPECT_EQ(s[i], r.at(i));
+  }
+}
+
+/////////////////
+// constructor //
+/////////////////
+
+FATAL_TEST(tree_rope, ctor) {
+  tree_rope empty;
+  check("", empty);
+  FATAL_EXPECT_EQ(0, empty.pieces());
+  FATAL_EXPECT_EQ(empty.begin(), empty.end());
+
+  std::string s(" this is");
+  tree_rope r("hello", ',', std::string(" world!"), s, "", std::string());
+  check("hello, world! this is", r);
+  FATAL_EXPECT_EQ(4, r.pieces());
+  FATAL_EXPECT_EQ(s.data(), r.piece(3).data());
+
+  tree_rope moved(std::move(r));
+  check("hello, world! this is", moved);
+  check("", r);
+
+  r = std::move(moved);
+  check("hello, world! this is", r);
+  check("", moved);
+}
+
+///////////////
+// accessors //
+///////////////
+
+FATAL_TEST(tree_rope, accessors) {
+  tree_rope r("ab", 'c', std::string("def"));
+  FATAL_EXPECT_EQ('a', r.front());
+  FATAL_EXPECT_EQ('f', r.back());
+  FATAL_EXPECT_EQ('d', r.at(3));
+  FATAL_EXPECT_THROW(std::out_of_range) {
+    r.at(6);
+  };
+}
+
+////////////
+// insert //
+////////////
+
+FATAL_TEST(tree_rope, insert) {
+  std::string const world(" world");
+  tree_rope r("hello", world);
+
+  r.insert(5, ",");
+  check("hello, world", r);
+  FATAL_EXPECT_EQ(3, r.pieces());
+
+  r.insert(0, std::string("oh "));
+  check("oh hello, world", r);
+
+  r.insert(r.size(), '!');
+  check("oh hello, world!", r);
+
+  // splits a referenced piece in two, both referencing the original string
+  r.insert(12, world);
+  check("oh hello, wo worldrld!", r);
+  FATAL_EXPECT_EQ(7, r.pieces());
+  FATAL_EXPECT_EQ(world.data(), r.piece(3).data());
+  FATAL_EXPECT_EQ(world.data(), r.piece(4).data());
+  FATAL_EXPECT_EQ(world.data() + 3, r.piece(5).data());
+
+  // splits an owned piece in two
+  r.insert(1, std::string("h"));
+  check("ohh hello, wo worldrld!", r);
+  FATAL_EXPECT_EQ(9, r.pieces());
+
+  FATAL_EXPECT_THROW(std::out_of_range) {
+    r.insert(r.size() + 1, 'x');
+  };
+}
+
+///////////
+// erase //
+///////////
+
+FATAL_TEST(tree_rope, erase) {
+  tree_rope r("hello", ", ", std::string("world"));
+
+  r.erase(3, 5);
+  check("helorld", r);
+
+  r.erase(0, 0);
+  check("helorld", r);
+
+  r.erase(4, 100);
+  check("helo", r);
+
+  r.erase(0, 1);
+  check("elo", r);
+
+  r.erase(0, r.size());
+  check("", r);
+
+  FATAL_EXPECT_THROW(std::out_of_range) {
+    r.erase(1, 0);
+  };
+}
+
+/////////////
+// extract //
+/////////////
+
+FATAL_TEST(tree_rope, extract) {
+  tree_rope r("hello", ", ", std::string("world"));
+
+  auto e = r.extract(3, 5);
+  check("helorld", r);
+  check("lo, w", e);
+
+  auto none = r.extract(2, 0);
+  check("helorld", r);
+  check("", none);
+}
+
+////////////
+// splice //
+////////////
+
+FATAL_TEST(tree_rope, splice) {
+  tree_rope r("hello", "world");
+  tree_rope s(", ", std::string("beautiful "));
+
+  r.splice(5, std::move(s));
+  check("hello, beautiful world", r);
+  check("", s);
+
+  r.splice(0, tree_rope("oh "));
+  check("oh hello, beautiful world", r);
+
+  r.splice(r.size(), tree_rope('!'));
+  check("oh hello, beautiful world!", r);
+
+  r.splice(3, tree_rope());
+  check("oh hello, beautiful world!", r);
+
+  FATAL_EXPECT_THROW(std::invalid_argument) {
+    r.splice(0, std::move(r));
+  };
+}
+
+////////////////
+// randomized //
+////////////////
+
+FATAL_TEST(tree_rope, random_edits) {
+  random_data rdg;
+
+  for (std::size_t round = 0; round < 20; ++round) {
+    std::vector<std::string> sources;
+    for (std::size_t i = 0; i < 64; ++i) {
+      sources.push_back(rdg.string(1 + rdg() % 20));
+    }
+
+    std::string expected;
+    tree_rope r;
+
+    for (std::size_t i = 0; i < 200; ++i) {
+      auto const position = rdg() % (expected.size() + 1);
+      auto const &source = sources[rdg() % sources.size()];
+
+      switch (rdg() % 6) {
+        case 0:
+          r.insert(position, source);
+          expected.insert(position, source);
+          break;
+
+        case 1:
+          r.insert(position, std::string(source));
+          expected.insert(position, source);
+          break;
+
+        case 2:
+          r.insert(position, source.front());
+          expected.insert(position, 1, source.front());
+          break;
+
+        case 3: {
+          auto const count = rdg() % 30;
+          r.erase(position, count);
+          expected.erase(position, count);
+          break;
+        }
+
+        case 4: {
+          auto const count = rdg() % 30;
+          auto e = r.extract(position, count);
+          FATAL_EXPECT_EQ(expected.substr(position, count), e);
+          expected.erase(position, count);
+
+          auto const target = rdg() % (expected.size() + 1);
+          expected.insert(target, e.to_string());
+          r.splice(target, std::move(e));
+          break;
+        }
+
+        default: {
+          tree_rope other(source, std::string(source), source.back());
+          r.splice(position, std::move(other));
+          expected.insert(position, source + source + source.back());
+          break;
+        }
+      }
+
+      FATAL_ASSERT_EQ(expected, r.to_string());
+    }
+
+    check(expected, r);
+  }
+}
+
+////////////////////
+// const_iterator //
+////////////////////
+
+FATAL_TEST(tree_rope, const_iterator) {
+  std::string const s("hello, world! this is a test");
+  tree_rope r("hello", ',', std::string(" world!"), " this", " is a test");
+
+  for (std::size_t i = 0; i <= s.size(); ++i) {
+    auto j = r.begin();
+    j += i;
+    FATAL_EXPECT_EQ(i, j.absolute());
+
+    if (i < s.size()) {
+      FATAL_EXPECT_EQ(s[i], *j);
+    } else {
+      FATAL_EXPECT_EQ(r.end(), j);
+    }
+
+    for (std::size_t k = 1; k <= i; ++k) {
+      auto l = j;
+      l -= k;
+      FATAL_EXPECT_EQ(i - k, l.absolute());
+      FATAL_EXPECT_EQ(s[i - k], *l);
+    }
+  }
+}
+
+//////////
+// copy //
+//////////
+
+FATAL_TEST(tree_rope, copy) {
+  tree_rope r("hello", ',', std::string(" world!"));
+  std::string const s(r.to_string());
+
+  for (std::size_t size = 0; size <= s.size() + 1; ++size) {
+    std::vector<char> buffer(size);
+    auto const end = r.copy(buffer.data(), buffer.data() + buffer.size());
+    FATAL_EXPECT_EQ(
+      s.substr(0, size),
+      std::string(buffer.data(), end)
+    );
+  }
+}
+
+/////////////
+// compare //
+/////////////
+
+FATAL_TEST(tree_rope, compare) {
+  std::vector<std::string> const strings{
+    "", "a", "ab", "abc", "abd", "b", "hello, world", "hello, worle"
+  };
+
+  for (auto const &lhs: strings) {
+    tree_rope const l(lhs);
+    tree_rope lc;
+    for (auto c: lhs) {
+      lc.push_back(c);
+    }
+
+    for (auto const &rhs: strings) {
+      tree_rope const r(rhs);
+      tree_rope rc;
+      for (auto c: rhs) {
+        rc.push_back(c);
+      }
+
+      auto const expected = lhs.compare(rhs);
+
+      FATAL_EXPECT_EQ(expected < 0, l.compare(rhs) < 0);
+      FATAL_EXPECT_EQ(expected > 0, l.compare(rhs) > 0);
+      FATAL_EXPECT_EQ(expected < 0, l.compare(rc) < 0);
+      FATAL_EXPECT_EQ(expected > 0, l.compare(rc) > 0);
+      FATAL_EXPECT_EQ(expected < 0, lc.compare(r) < 0);
+      FATAL_EXPECT_EQ(expected > 0, lc.compare(r) > 0);
+
+      FATAL_EXPECT_EQ(expected == 0, l == rc);
+      FATAL_EXPECT_EQ(expected != 0, l != rc);
+      FATAL_EXPECT_EQ(expected < 0, lc < r);
+      FATAL_EXPECT_EQ(expected > 0, lc > r);
+      FATAL_EXPECT_EQ(expected <= 0, l <= rhs);
+      FATAL_EXPECT_EQ(expected >= 0, l >= rhs);
+      FATAL_EXPECT_EQ(expected == 0, lhs == rc);
+      FATAL_EXPECT_EQ(expected > 0, lhs > rc);
+    }
+  }
+}
+
+/////////////////
+// operator << //
+/////////////////
+
+FATAL_TEST(tree_rope, ostream) {
+  tree_rope r("hello", ',', std::string(" world!"));
+  std::ostringstream ss;
+  ss << r;
+  FATAL_EXPECT_EQ("hello, world!", ss.str());
+}
+
+} // namespace fatal {
@@ -0,0 +1,1213 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/portability.h>
+#include <fatal/string/string_view.h>
+#include <fatal/type/safe_overload.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+FATAL_DIAGNOSTIC_PUSH
+FATAL_GCC_DIAGNOSTIC_IGNORED_SHADOW_IF_BROKEN
+
+namespace fatal {
+namespace detail {
+namespace tree_rope_impl {
+
+////////////////////////////
+// IMPLEMENTATION DETAILS //
+////////////////////////////
+
+// a node of the treap holding the pieces of a `tree_rope`, in order: each
+// node holds one piece, plus the number of characters and pieces in the
+// subtree rooted at it
+struct node {
+  explicit node(string_view s): piece(s) { set_priority(); }
+
+  explicit node(std::string &&s):
+    owned(std::move(s)),
+    piece(owned)
+  {
+    set_priority();
+  }
+
+  explicit node(char c):
+    character(c),
+    piece(std::addressof(character), 1)
+  {
+    set_priority();
+  }
+
+  node(node const &) = delete;
+  node(node &&) = delete;
+
+  bool owns() const { return !owned.empty(); }
+
+  std::string owned;
+  char character = 0;
+  string_view piece;
+
+  node *left = nullptr;
+  node *right = nullptr;
+
+  std::size_t size = piece.size();
+  std::size_t count = 1;
+  std::uint32_t priority;
+
+private:
+  // a hash of the node's address is as good as a random number for
+  // balancing the treap, and needs no state
+  void set_priority() {
+    auto x = static_cast<std::uint64_t>(
+      reinterpret_cast<std::uintptr_t>(this)
+    );
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    priority = static_cast<std::uint32_t>(x);
+  }
+};
+
+inline std::size_t size_of(node const *n) { return n ? n->size : 0; }
+inline std::size_t count_of(node const *n) { return n ? n->count : 0; }
+
+inline void update(node *n) {
+  assert(n);
+  n->size = size_of(n->left) + n->piece.size() + size_of(n->right);
+  n->count = count_of(n->left) + 1 + count_of(n->right);
+}
+
+inline void destroy(node *n) {
+  while (n) {
+    destroy(n->left);
+    auto const right = n->right;
+    delete n;
+    n = right;
+  }
+}
+
+// joins two treaps, with all pieces of `lhs` preceding those of `rhs` //
+inline node *merge(node *lhs, node *rhs) {
+  if (!lhs) {
+    return rhs;
+  }
+
+  if (!rhs) {
+    return lhs;
+  }
+
+  if (lhs->priority > rhs->priority) {
+    lhs->right = merge(lhs->right, rhs);
+    update(lhs);
+    return lhs;
+  }
+
+  rhs->left = merge(lhs, rhs->left);
+  update(rhs);
+  return rhs;
+}
+
+// splits a treap into its first `pieces` pieces and the remaining ones //
+inline std::pair<node *, node *> split_pieces(node *n, std::size_t pieces) {
+  if (!n) {
+    return std::make_pair(nullptr, nullptr);
+  }
+
+  auto const left = count_of(n->left);
+
+  if (pieces <= left) {
+    auto const result = split_pieces(n->left, pieces);
+    n->left = result.second;
+    update(n);
+    return std::make_pair(result.first, n);
+  }
+
+  auto const result = split_pieces(n->right, pieces - left - 1);
+  n->right = result.first;
+  update(n);
+  return std::make_pair(n, result.second);
+}
+
+// iterates over the pieces of a treap, in order //
+struct piece_cursor {
+  explicit piece_cursor(node const *root) { descend(root); }
+
+  // returns the next piece, or an empty one past the last piece
+  string_view next() {
+    if (stack_.empty()) {
+      return string_view();
+    }
+
+    auto const n = stack_.back();
+    stack_.pop_back();
+    descend(n->right);
+
+    assert(!n->piece.empty());
+    return n->piece;
+  }
+
+private:
+  void descend(node const *n) {
+    for (; n; n = n->left) {
+      stack_.push_back(n);
+    }
+  }
+
+  std::vector<node const *> stack_;
+};
+
+} // namespace tree_rope_impl {
+} // namespace detail {
+
+///////////////
+// tree_rope //
+///////////////
+
+/**
+ * A rope that keeps its pieces in a balanced tree rather than in a flat
+ * array, so that pieces can be inserted and erased anywhere in
+ * logarithmic time.
+ *
+ * It holds the same kinds of pieces as `rope`, with the same ownership
+ * rules: string literals, lvalue strings and `string_view`s are referenced,
+ * while temporary strings and single characters are owned.
+ *
+ * Edits in the middle of the string, which would require rebuilding a
+ * `rope`, take O(log n) time on the number of pieces:
+ *
+ *  - `insert(position, piece)` adds a piece at any position
+ *  - `erase(position, count)` removes a range of characters
+ *  - `splice(position, other)` moves all pieces of another tree rope
+ *  - `extract(position, count)` moves a range out into a new tree rope
+ *
+ * Pieces that straddle the edited position are split in two. The tail of
+ * a split owned string is copied into a new owned piece.
+ *
+ * The price is that accessing a piece by index takes O(log n) time rather
+ * than constant time, and each piece takes a separate allocation. For
+ * strings that are only appended to, `rope` is the better choice.
+ *
+ * Example:
+ *
+ *  tree_rope r("hello", " world");
+ *
+ *  r.insert(5, ",");
+ *  r.erase(0, 1);
+ *  r.insert(0, 'H');
+ *
+ *  // prints "Hello, world"
+ *  std::cout << r << std::endl;
+ */
+struct tree_rope {
+  /**
+   * The type used to represent the characters contained
+   * in the string represented by this rope.
+   */
+  using value_type = char;
+
+  /**
+   * The type used to represent the number of characters
+   * contained in the string represented by this rope.
+   */
+  using size_type = std::size_t;
+
+  /**
+   * The type used to represent the difference between two iterators.
+   */
+  using difference_type = std::make_signed<size_type>::type;
+
+  /**
+   * The type used to represent the number of pieces stored in this rope.
+   */
+  using piece_index = size_type;
+
+private:
+  using node = detail::tree_rope_impl::node;
+  using piece_cursor = detail::tree_rope_impl::piece_cursor;
+
+public:
+  /**
+   * Default constructor. Constructs an empty rope.
+   */
+  tree_rope() = default;
+
+  /**
+   * There is no copy constructor defined for this rope, for the same
+   * reasons as for `rope`.
+   */
+  tree_rope(tree_rope const &) = delete;
+
+  /**
+   * Move constructor. Commandeers the pieces contained in the given rope.
+   */
+  tree_rope(tree_rope &&rhs) noexcept:
+    root_(rhs.root_)
+  {
+    rhs.root_ = nullptr;
+  }
+
+  /**
+   * Constructs a rope ouf of the given pieces.
+   *
+   * This is equivalent to constructing an empty rope using
+   * the default constructor, then calling `append()` on
+   * each piece given.
+   *
+   * Example:
+   *
+   *  tree_rope hello("hello, ", std::string("world"), '!');
+   */
+  template <typename... Args, typename = safe_overload<tree_rope, Args...>>
+  explicit tree_rope(Args &&...args) {
+    multi_append(std::forward<Args>(args)...);
+  }
+
+  ~tree_rope() { detail::tree_rope_impl::destroy(root_); }
+
+  tree_rope &operator =(tree_rope const &) = delete;
+
+  /**
+   * Move assignment. Releases the pieces of this rope and commandeers
+   * the ones contained in the given rope.
+   */
+  tree_rope &operator =(tree_rope &&rhs) noexcept {
+    if (this != std::addressof(rhs)) {
+      detail::tree_rope_impl::destroy(root_);
+      root_ = rhs.root_;
+      rhs.root_ = nullptr;
+    }
+
+    return *this;
+  }
+
+  ///////////////
+  // accessors //
+  ///////////////
+
+  /**
+   * Returns a reference to the `i-th' piece contained in this rope.
+   *
+   * This takes O(log n) time on the number of pieces.
+   */
+  string_view piece(piece_index i) const {
+    assert(i < pieces());
+    return node_at(i)->piece;
+  }
+
+  /**
+   * The number of pieces contained in this rope.
+   */
+  piece_index pieces() const { return detail::tree_rope_impl::count_of(root_); }
+
+  /**
+   * Returns the first character of the string represented by this rope.
+   *
+   * No bounds checking is performed. It is up to the user to make sure
+   * this rope does not represent an empty string.
+   */
+  value_type front() const {
+    assert(root_);
+    return piece(0).front();
+  }
+
+  /**
+   * Returns the last character of the string represented by this rope.
+   *
+   * No bounds checking is performed. It is up to the user to make sure
+   * this rope does not represent an empty string.
+   */
+  value_type back() const {
+    assert(root_);
+    return piece(pieces() - 1).back();
+  }
+
+  /**
+   * Returns the `i-th` character of the string represented by this rope.
+   *
+   * Throws `std::out_of_range` if `i` is not a valid index.
+   */
+  value_type at(size_type i) const {
+    if (i >= size()) {
+      throw std::out_of_range("at(): index out of bounds");
+    }
+
+    return *pinpoint(i);
+  }
+
+  /**
+   * Returns the `i-th` character of the string represented by this rope.
+   *
+   * No bounds checking is performed. It is up to the user to make sure
+   * `i` represents a valid index.
+   */
+  value_type operator [](size_type i) const {
+    assert(i < size());
+    return *pinpoint(i);
+  }
+
+  ////////////////////
+  // const_iterator //
+  ////////////////////
+
+  /**
+   * The class used to represent an iterator for the characters
+   * contained in the string represented by this rope.
+   *
+   * Moving within a piece takes constant time, while moving to
+   * another piece takes O(log n) time on the number of pieces.
+   */
+  struct const_iterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = tree_rope::value_type;
+    using difference_type = tree_rope::difference_type;
+    using pointer = value_type *;
+    using reference = value_type &;
+
+    explicit const_iterator(
+      tree_rope const *r,
+      string_view piece,
+      piece_index index,
+      size_type offset,
+      size_type base
+    ):
+      rope_(r),
+      piece_(piece),
+      index_(index),
+      offset_(offset),
+      base_(base)
+    {
+      assert(piece_.empty() || offset_ < piece_.size());
+    }
+
+    piece_index index() const { return index_; }
+    size_type offset() const { return offset_; }
+    size_type absolute() const { return base_ + offset_; }
+
+    string_view ref() const {
+      assert(!piece_.empty());
+      return piece_ + offset_;
+    }
+
+    char operator *() const {
+      assert(offset_ < piece_.size());
+      return piece_[offset_];
+    }
+
+    size_type operator +(size_type rhs) const { return absolute() + rhs; }
+    size_type operator -(size_type rhs) const { return absolute() - rhs; }
+
+    const_iterator &operator ++() {
+      assert(offset_ < piece_.size());
+
+      if (++offset_ == piece_.size()) {
+        base_ += piece_.size();
+        offset_ = 0;
+        piece_ = ++index_ < rope_->pieces()
+          ? rope_->piece(index_)
+          : string_view();
+      }
+
+      return *this;
+    }
+
+    const_iterator &operator --() {
+      if (offset_) {
+        --offset_;
+      } else {
+        assert(index_ > 0);
+        piece_ = rope_->piece(--index_);
+        base_ -= piece_.size();
+        offset_ = piece_.size() - 1;
+      }
+
+      return *this;
+    }
+
+    const_iterator operator ++(int) {
+      auto copy(*this);
+      ++*this;
+      return copy;
+    }
+
+    const_iterator operator --(int) {
+      auto copy(*this);
+      --*this;
+      return copy;
+    }
+
+    const_iterator &operator +=(size_type rhs) {
+      if (rhs < piece_.size() - offset_) {
+        offset_ += rhs;
+      } else {
+        *this = rope_->pinpoint(absolute() + rhs);
+      }
+
+      return *this;
+    }
+
+    const_iterator &operator -=(size_type rhs) {
+      if (rhs <= offset_) {
+        offset_ -= rhs;
+      } else {
+        assert(rhs <= absolute());
+        *this = rope_->pinpoint(absolute() - rhs);
+      }
+
+      return *this;
+    }
+
+    bool operator ==(size_type rhs) const { return rhs == absolute(); }
+    bool operator !=(size_type rhs) const { return rhs != absolute(); }
+
+    bool operator ==(const_iterator const &rhs) const {
+      return offset_ == rhs.offset_
+        && index_ == rhs.index_
+        && rope_ == rhs.rope_;
+    }
+
+    bool operator !=(const_iterator const &rhs) const {
+      return !(*this == rhs);
+    }
+
+    bool operator <(const_iterator const &rhs) const {
+      assert(rope_ == rhs.rope_);
+      return absolute() < rhs.absolute();
+    }
+
+    bool operator <=(const_iterator const &rhs) const { return !(rhs < *this); }
+    bool operator >(const_iterator const &rhs) const { return rhs < *this; }
+    bool operator >=(const_iterator const &rhs) const { return !(*this < rhs); }
+
+    explicit operator size_type() const { return absolute(); }
+
+  private:
+    tree_rope const *rope_;
+    string_view piece_;
+    piece_index index_;
+
+    // relative to the piece
+    size_type offset_;
+
+    // absolute offset of the piece
+    size_type base_;
+  };
+
+  ///////////////
+  // iterators //
+  ///////////////
+
+  /**
+   * Gets an iterator pointing to the first character of the
+   * string represented by this rope.
+   */
+  const_iterator cbegin() const {
+    return root_
+      ? const_iterator(this, piece(0), 0, 0, 0)
+      : cend();
+  }
+
+  /**
+   * Gets an iterator pointing to the first character of the
+   * string represented by this rope.
+   */
+  const_iterator begin() const { return cbegin(); }
+
+  /**
+   * Gets an iterator pointing to one past the last character
+   * of the string represented by this rope.
+   */
+  const_iterator cend() const {
+    return const_iterator(this, string_view(), pieces(), 0, size());
+  }
+
+  /**
+   * Gets an iterator pointing to one past the last character
+   * of the string represented by this rope.
+   */
+  const_iterator end() const { return cend(); }
+
+  ////////////
+  // append //
+  ////////////
+
+  /**
+   * Appends the given string to the end of this rope. The string is
+   * moved into and owned by this rope.
+   */
+  void append(std::string &&s) {
+    if (!s.empty()) {
+      root_ = detail::tree_rope_impl::merge(root_, new node(std::move(s)));
+    }
+  }
+
+  /**
+   * Appends a reference to the string represented by the
+   * given `string_view` to the end of this rope.
+   */
+  void append(string_view s) {
+    if (!s.empty()) {
+      root_ = detail::tree_rope_impl::merge(root_, new node(s));
+    }
+  }
+
+  /**
+   * Appends the given character to the end of this rope.
+   *
+   * The character will be copied, not referenced.
+   */
+  void append(char c) {
+    root_ = detail::tree_rope_impl::merge(root_, new node(c));
+  }
+
+  /**
+   * Constructs a `string_view` out of the given arguments, then
+   * adds it to the end of this rope.
+   */
+  template <typename... Args, typename = safe_overload<tree_rope, Args...>>
+  void append(Args &&...args) {
+    append(string_view(std::forward<Args>(args)...));
+  }
+
+  /**
+   * Appends the given character to the end of this rope.
+   *
+   * The character will be copied, not referenced.
+   */
+  void push_back(char c) { append(c); }
+
+  /**
+   * Appends each of the given pieces to the end of this rope.
+   */
+  template <typename... Args>
+  void multi_append(Args &&...args) {
+    multi_append_impl(std::forward<Args>(args)...);
+  }
+
+  ////////////
+  // insert //
+  ////////////
+
+  /**
+   * Inserts the given string at the character offset `position`. The
+   * string is moved into and owned by this rope.
+   *
+   * Throws `std::out_of_range` if `position` is past the end.
+   *
+   * Example:
+   *
+   *  tree_rope r("hello world");
+   *
+   *  // `r` now holds "hello, world" in 3 pieces: "hello", "," and " world"
+   *  r.insert(5, std::string(","));
+   */
+  void insert(size_type position, std::string &&s) {
+    check_position(position, "insert");
+
+    if (!s.empty()) {
+      insert_node(position, new node(std::move(s)));
+    }
+  }
+
+  /**
+   * Inserts a reference to the string represented by the given
+   * `string_view` at the character offset `position`.
+   *
+   * Throws `std::out_of_range` if `position` is past the end.
+   */
+  void insert(size_type position, string_view s) {
+    check_position(position, "insert");
+
+    if (!s.empty()) {
+      insert_node(position, new node(s));
+    }
+  }
+
+  /**
+   * Inserts the given character at the character offset `position`.
+   *
+   * Throws `std::out_of_range` if `position` is past the end.
+   */
+  void insert(size_type position, char c) {
+    check_position(position, "insert");
+    insert_node(position, new node(c));
+  }
+
+  /**
+   * Constructs a `string_view` out of the given arguments, then
+   * inserts it at the character offset `position`.
+   *
+   * Throws `std::out_of_range` if `position` is past the end.
+   */
+  template <typename... Args, typename = safe_overload<tree_rope, Args...>>
+  void insert(size_type position, Args &&...args) {
+    insert(position, string_view(std::forward<Args>(args)...));
+  }
+
+  ///////////
+  // erase //
+  ///////////
+
+  /**
+   * Removes up to `count` characters starting at `position`, like
+   * `std::string::erase` does.
+   *
+   * Throws `std::out_of_range` if `position` is past the end.
+   *
+   * Example:
+   *
+   *  tree_rope r("hello", ", ", "world");
+   *
+   *  // `r` now holds "helorld"
+   *  r.erase(3, 5);
+   */
+  void erase(size_type position, size_type count) {
+    detail::tree_rope_impl::destroy(cut(position, count, "erase"));
+  }
+
+  /////////////
+  // extract //
+  /////////////
+
+  /**
+   * Moves up to `count` characters starting at `position` out of this
+   * rope and into a new one, which is returned.
+   *
+   * Throws `std::out_of_range` if `position` is past the end.
+   */
+  tree_rope extract(size_type position, size_type count) {
+    tree_rope result;
+    result.root_ = cut(position, count, "extract");
+    return result;
+  }
+
+  ////////////
+  // splice //
+  ////////////
+
+  /**
+   * Moves all pieces of `other` into this rope at the character offset
+   * `position`. After this function returns, `other` will be empty.
+   *
+   * Throws `std::out_of_range` if `position` is past the end.
+   *
+   * Example:
+   *
+   *  tree_rope r("hello", "world");
+   *  tree_rope s(", ", "beautiful ");
+   *
+   *  // `r` now holds "hello, beautiful world" and `s` is empty
+   *  r.splice(5, std::move(s));
+   */
+  void splice(size_type position, tree_rope &&other) {
+    if (this == std::addressof(other)) {
+      throw std::invalid_argument("cannot splice r-value reference to self");
+    }
+
+    check_position(position, "splice");
+
+    auto const parts = split(root_, position);
+    root_ = detail::tree_rope_impl::merge(
+      detail::tree_rope_impl::merge(parts.first, other.root_),
+      parts.second
+    );
+    other.root_ = nullptr;
+  }
+
+  //////////
+  // copy //
+  //////////
+
+  /**
+   * Copies as much as possible of this rope's contents to the output
+   * range `[begin, end)`.
+   *
+   * Returns the pointer `e`, which is one element past the last one
+   * written, such that the written range lies within `[begin, e)`.
+   */
+  char *copy(char *begin, char *end) const {
+    piece_cursor cursor(root_);
+
+    for (auto piece = cursor.next(); piece && begin < end;) {
+      piece.limit(static_cast<size_type>(std::distance(begin, end)));
+      begin = std::copy(piece.begin(), piece.end(), begin);
+      piece = cursor.next();
+    }
+
+    return begin;
+  }
+
+  ////////////
+  // string //
+  ////////////
+
+  /**
+   * Returns a copy of this rope's contents as an instance of `std:string`.
+   */
+  std::string to_string() const {
+    std::string s;
+    append_to(s);
+    return s;
+  }
+
+  /**
+   * Appends the contents of this rope to the given string.
+   *
+   * Uses the member function `append()` from `out` passing
+   * a pair of iterators `begin` and `end` to each of the
+   * pieces contained in this rope.
+   */
+  template <typename String>
+  String &append_to(String &out) const {
+    out.reserve(out.size() + size());
+
+    piece_cursor cursor(root_);
+
+    for (auto piece = cursor.next(); piece; piece = cursor.next()) {
+      out.append(piece.begin(), piece.end());
+    }
+
+    return out;
+  }
+
+  //////////
+  // size //
+  //////////
+
+  /**
+   * Returns the total number of characters contained
+   * in the string represented by this rope.
+   */
+  size_type size() const { return detail::tree_rope_impl::size_of(root_); }
+
+  ///////////
+  // empty //
+  ///////////
+
+  /**
+   * Tells whether this rope represents an empty string.
+   */
+  bool empty() const { return !root_; }
+
+  ///////////
+  // clear //
+  ///////////
+
+  /**
+   * Clears the contents of this rope, making it represent an empty string.
+   */
+  void clear() {
+    detail::tree_rope_impl::destroy(root_);
+    root_ = nullptr;
+  }
+
+  /////////////
+  // compare //
+  /////////////
+
+  /**
+   * Lexicographically compares the string represented by `rhs` to
+   * the string represented by this rope. Returns a negative integer
+   * when this rope is lexicographically smaller than `rhs`, a positive
+   * integer when this rope is lexicographically greater than `rhs`
+   * or 0 when this rope represents the same string as `rhs`.
+   */
+  int compare(string_view rhs) const {
+    piece_cursor cursor(root_);
+
+    for (auto piece = cursor.next(); piece; piece = cursor.next()) {
+      if (!rhs) {
+        return 1;
+      }
+
+      auto const length = std::min(rhs.size(), piece.size());
+
+      if (auto const result = std::memcmp(piece.data(), rhs.data(), length)) {
+        return result;
+      }
+
+      if (length == rhs.size()) {
+        return length != piece.size() || cursor.next();
+      }
+
+      rhs += length;
+    }
+
+    return -!rhs.empty();
+  }
+
+  /**
+   * Lexicographically compares the string represented by `rhs` to
+   * the string represented by this rope. Returns a negative integer
+   * when this rope is lexicographically smaller than `rhs`, a positive
+   * integer when this rope is lexicographically greater than `rhs`
+   * or 0 when this rope represents the same string as `rhs`.
+   */
+  int compare(tree_rope const &rhs) const {
+    piece_cursor lcursor(root_);
+    piece_cursor rcursor(rhs.root_);
+
+    auto left = lcursor.next();
+    auto right = rcursor.next();
+
+    while (left && right) {
+      auto const length = std::min(left.size(), right.size());
+
+      if (auto const result = std::memcmp(left.data(), right.data(), length)) {
+        return result;
+      }
+
+      if (!(left += length)) {
+        left = lcursor.next();
+      }
+
+      if (!(right += length)) {
+        right = rcursor.next();
+      }
+    }
+
+    return static_cast<int>(!left.empty()) - static_cast<int>(!right.empty());
+  }
+
+  /**
+   * Lexicographically compares the string represented by `rhs` to
+   * the string represented by this rope. Returns a negative integer
+   * when this rope is lexicographically smaller than `rhs`, a positive
+   * integer when this rope is lexicographically greater than `rhs`
+   * or 0 when this rope represents the same string as `rhs`.
+   */
+  template <typename T, typename = safe_overload<tree_rope, T>>
+  int compare(T &&rhs) const {
+    return compare(string_view(std::forward<T>(rhs)));
+  }
+
+  /////////////////
+  // operator == //
+  /////////////////
+
+  /**
+   * Returns true if the string represented by `rhs` is equal to
+   * the string represented by this rope, or false otherwise.
+   */
+  bool operator ==(string_view rhs) const {
+    return size() == rhs.size() && !compare(rhs);
+  }
+
+  /**
+   * Returns true if the string represented by `rhs` is equal to
+   * the string represented by this rope, or false otherwise.
+   */
+  bool operator ==(tree_rope const &rhs) const {
+    return size() == rhs.size() && !compare(rhs);
+  }
+
+  /**
+   * Returns true if the string represented by `rhs` is equal to
+   * the string represented by this rope, or false otherwise.
+   */
+  template <typename T, typename = safe_overload<tree_rope, T>>
+  bool operator ==(T &&rhs) const {
+    return *this == string_view(std::forward<T>(rhs));
+  }
+
+  ////////////////
+  // operator < //
+  ////////////////
+
+  /**
+   * Returns true if the string represented by `rhs` is lexicographically
+   * less than the string represented by this rope, or false otherwise.
+   */
+  template <typename T>
+  bool operator <(T &&rhs) const {
+    return compare(std::forward<T>(rhs)) < 0;
+  }
+
+  ////////////////
+  // operator > //
+  ////////////////
+
+  /**
+   * Returns true if the string represented by `rhs` is lexicographically
+   * greater than the string represented by this rope, or false otherwise.
+   */
+  template <typename T>
+  bool operator >(T &&rhs) const {
+    return compare(std::forward<T>(rhs)) > 0;
+  }
+
+private:
+  ////////////////////////////
+  // IMPLEMENTATION DETAILS //
+  ////////////////////////////
+
+  node const *node_at(piece_index i) const {
+    for (auto n = root_;;) {
+      assert(n);
+      auto const left = detail::tree_rope_impl::count_of(n->left);
+
+      if (i < left) {
+        n = n->left;
+      } else if (i == left) {
+        return n;
+      } else {
+        i -= left + 1;
+        n = n->right;
+      }
+    }
+  }
+
+  const_iterator pinpoint(size_type i) const {
+    if (i >= size()) {
+      return cend();
+    }
+
+    piece_index index = 0;
+    size_type base = 0;
+
+    for (auto n = root_;;) {
+      assert(n);
+      auto const left = detail::tree_rope_impl::size_of(n->left);
+
+      if (i < left) {
+        n = n->left;
+        continue;
+      }
+
+      i -= left;
+      base += left;
+      index += detail::tree_rope_impl::count_of(n->left);
+
+      if (i < n->piece.size()) {
+        return const_iterator(this, n->piece, index, i, base);
+      }
+
+      i -= n->piece.size();
+      base += n->piece.size();
+      ++index;
+      n = n->right;
+    }
+  }
+
+  void check_position(size_type position, char const *what) const {
+    if (position > size()) {
+      throw std::out_of_range(std::string(what) + "(): position out of bounds");
+    }
+  }
+
+  // splits the treap `n` into its first `position` characters and the
+  // remaining ones, splitting the piece that straddles `position` //
+  static std::pair<node *, node *> split(node *n, size_type position) {
+    using detail::tree_rope_impl::count_of;
+    using detail::tree_rope_impl::merge;
+    using detail::tree_rope_impl::size_of;
+    using detail::tree_rope_impl::split_pieces;
+    using detail::tree_rope_impl::update;
+
+    if (!position) {
+      return std::make_pair(nullptr, n);
+    }
+
+    if (position >= size_of(n)) {
+      return std::make_pair(n, nullptr);
+    }
+
+    // find the piece containing `position`
+    piece_index index = 0;
+    auto offset = position;
+
+    for (auto i = n;;) {
+      auto const left = size_of(i->left);
+
+      if (offset < left) {
+        i = i->left;
+        continue;
+      }
+
+      offset -= left;
+      index += count_of(i->left);
+
+      if (offset < i->piece.size()) {
+        break;
+      }
+
+      offset -= i->piece.size();
+      ++index;
+      i = i->right;
+    }
+
+    auto const parts = split_pieces(n, index);
+
+    if (!offset) {
+      return parts;
+    }
+
+    auto const tail = split_pieces(parts.second, 1);
+    auto const head = tail.first;
+    assert(head && !head->left && !head->right);
+    assert(offset < head->piece.size());
+
+    auto const rest = head->owns()
+      ? new node(std::string(head->piece.data() + offset, head->piece.end()))
+      : new node(head->piece + offset);
+
+    head->piece.limit(offset);
+    update(head);
+
+    return std::make_pair(
+      merge(parts.first, head),
+      merge(rest, tail.second)
+    );
+  }
+
+  void insert_node(size_type position, node *n) {
+    assert(position <= size());
+
+    auto const parts = split(root_, position);
+    root_ = detail::tree_rope_impl::merge(
+      detail::tree_rope_impl::merge(parts.first, n),
+      parts.second
+    );
+  }
+
+  // takes the characters in `[position, position + count)` out of this
+  // rope and returns the treap holding them //
+  node *cut(size_type position, size_type count, char const *what) {
+    check_position(position, what);
+    count = std::min(count, size() - position);
+
+    if (!count) {
+      return nullptr;
+    }
+
+    auto const left = split(root_, position);
+    auto const right = split(left.second, count);
+    root_ = detail::tree_rope_impl::merge(left.first, right.second);
+
+    return right.first;
+  }
+
+  template <typename T, typename... Args>
+  void multi_append_impl(T &&s, Args &&...args) {
+    append(std::forward<T>(s));
+    multi_append_impl(std::forward<Args>(args)...);
+  }
+
+  void multi_append_impl() {}
+
+  node *root_ = nullptr;
+
+  template <typename C, typename T>
+  friend std::ostream &operator <<(
+    std::basic_ostream<C, T> &out,
+    tree_rope const &r
+  );
+};
+
+/////////////////
+// operator == //
+/////////////////
+
+template <typename T, typename = safe_overload<tree_rope, T>>
+bool operator ==(T const &lhs, tree_rope const &rhs) {
+  return rhs.operator==(lhs);
+}
+
+////////////////
+// operator < //
+////////////////
+
+template <typename T, typename = safe_overload<tree_rope, T>>
+bool operator <(T const &lhs, tree_rope const &rhs) {
+  return rhs > lhs;
+}
+
+////////////////
+// operator > //
+////////////////
+
+template <typename T, typename = safe_overload<tree_rope, T>>
+bool operator >(T const &lhs, tree_rope const &rhs) {
+  return rhs < lhs;
+}
+
+/////////////////
+// operator != //
+/////////////////
+
+template <typename T>
+bool operator !=(tree_rope const &lhs, T const &rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, typename = safe_overload<tree_rope, T>>
+bool operator !=(T const &lhs, tree_rope const &rhs) {
+  return !(rhs == lhs);
+}
+
+/////////////////
+// operator <= //
+/////////////////
+
+template <typename T>
+bool operator <=(tree_rope const &lhs, T const &rhs) {
+  return !(lhs > rhs);
+}
+
+template <typename T, typename = safe_overload<tree_rope, T>>
+bool operator <=(T const &lhs, tree_rope const &rhs) {
+  return !(rhs < lhs);
+}
+
+/////////////////
+// operator >= //
+/////////////////
+
+template <typename T>
+bool operator >=(tree_rope const &lhs, T const &rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename T, typename = safe_overload<tree_rope, T>>
+bool operator >=(T const &lhs, tree_rope const &rhs) {
+  return !(rhs > lhs);
+}
+
+/////////////////////////////////////
+// operator <<(std::basic_ostream) //
+/////////////////////////////////////
+
+template <typename C, typename T>
+std::ostream &operator <<(std::basic_ostream<C, T> &out, tree_rope const &r) {
+  tree_rope::piece_cursor cursor(r.root_);
+
+  for (auto piece = cursor.next(); piece; piece = cursor.next()) {
+    out.write(piece.data(), static_cast<std::streamsize>(piece.size()));
+  }
+
+  return out;
+}
+
+} // namespace fatal {
+
+FATAL_DIAGNOSTIC_POP
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/test/test.h>
+
+#include <string>
+
+#include <cstdlib>
+
+#include <unistd.h>
+
+namespace fatal {
+
+// a temporary file with the given contents, removed on destruction //
+struct temporary_file {
+  explicit temporary_file(std::string const &contents) {
+    char path[] = "/tmp/fatal_test.XXXXXX";
+    auto const fd = ::mkstemp(path);
+    FATAL_ASSERT_LE(0, fd);
+    path_ = path;
+
+    for (std::size_t offset = 0; offset < contents.size(); ) {
+      auto const written = ::write(
+        fd, contents.data() + offset, contents.size() - offset
+      );
+      FATAL_ASSERT_LT(0, written);
+      offset += static_cast<std::size_t>(written);
+    }
+
+    ::close(fd);
+  }
+
+  temporary_file(temporary_file const &) = delete;
+
+  ~temporary_file() { ::unlink(path_.c_str()); }
+
+  std::string const &path() const { return path_; }
+
+private:
+  std::string path_;
+};
+
+} // namespace fatal {
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/functional/no_op.h>
+#include <fatal/type/identity.h>
+
+#include <fatal/type/impl/aho_corasick.h>
+
+#include <utility>
+
+namespace fatal {
+
+/**
+ * Finds every occurrence of the compile-time strings in `T` inside the
+ * input `[begin, end)`, in a single linear pass, using an Aho-Corasick
+ * automaton built at compile time.
+ *
+ * For each occurrence, calls `visitor(tag<String>(), offset, args...)`,
+ * where `String` is the matching element of `T` and `offset` is the
+ * position in the input where the occurrence starts. Occurrences are
+ * reported in the order they end in the input. Occurrences ending at the
+ * same position are reported from the longest to the shortest.
+ * Overlapping occurrences are all reported.
+ *
+ * Returns the number of occurrences found.
+ *
+ * `Filter` is applied to each element of `T` to obtain the string to look
+ * for. Strings are matched as sequences of `char`. The strings in `T` must
+ * be unique and not empty.
+ *
+ * The automaton is a flat transition table indexed by state and by
+ * character class. Only the characters that appear in `T` get a class of
+ * their own, which keeps the table small.
+ *
+ * Example:
+ *
+ *  FATAL_S(he, "he");
+ *  FATAL_S(she, "she");
+ *  FATAL_S(hers, "hers");
+ *
+ *  std::string s("ushers");
+ *
+ *  // returns `3` after calling `visitor(tag<she>(), 1)`,
+ *  // `visitor(tag<he>(), 2)` and `visitor(tag<hers>(), 2)`
+ *  aho_corasick_scan<list<he, she, hers>>(s.begin(), s.end(), visitor);
+ */
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Begin,
+  typename End,
+  typename Visitor,
+  typename... VArgs
+>
+static inline std::size_t aho_corasick_scan(
+  Begin begin,
+  End end,
+  Visitor &&visitor,
+  VArgs &&...args
+) {
+  return i_ac::s<T, Filter>::f(
+    std::move(begin),
+    std::move(end),
+    visitor,
+    args...
+  );
+}
+
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Begin,
+  typename End
+>
+static inline std::size_t aho_corasick_scan(Begin begin, End end) {
+  return aho_corasick_scan<T, Filter>(
+    std::move(begin),
+    std::move(end),
+    fn::no_op()
+  );
+}
+
+} // namespace fatal {
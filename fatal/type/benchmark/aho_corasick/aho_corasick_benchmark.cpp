@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/test/words.h>
+#include <fatal/type/aho_corasick.h>
+#include <fatal/type/array.h>
+#include <fatal/type/trie.h>
+
+#include <fatal/benchmark/benchmark.h>
+#include <fatal/benchmark/driver.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+namespace fatal {
+
+// Each benchmark iteration scans a single character of the input, so the
+// reported frequency reads directly as characters per second.
+
+using scan_words = random_250_words<list, sequence>;
+
+// log like text where about 1 in 10 words is one of `scan_words`, and the
+// rest are random words made of letters starting at `Filler`: upper case
+// fillers never start a match, lower case fillers often start partial ones //
+template <char Filler>
+std::string const &scan_input() {
+  static auto const input = []() {
+    using words = z_array<scan_words, char const *>;
+
+    std::mt19937 rng(0x5ca9);
+    std::uniform_int_distribution<std::size_t> pick(0, words::size::value - 1);
+
+    std::string result;
+    while (result.size() < (1 << 20)) {
+      if (rng() % 10) {
+        for (auto i = 3 + rng() % 6; i--; ) {
+          result.push_back(static_cast<char>(Filler + rng() % 26));
+        }
+      } else {
+        result.append(words::data[pick(rng)]);
+      }
+      result.push_back(' ');
+    }
+
+    return result;
+  }();
+
+  return input;
+}
+
+struct scan_visitor {
+  template <typename String>
+  void operator ()(tag<String>, std::size_t offset, std::size_t &count) const {
+    count += offset;
+  }
+};
+
+template <char Filler, typename Controller>
+void aho_corasick_scan_benchmark(Controller &benchmark, std::size_t n) {
+  std::string const *input = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    input = std::addressof(scan_input<Filler>());
+  }
+
+  while (n) {
+    auto const chunk = std::min(n, input->size());
+    count += aho_corasick_scan<scan_words>(
+      input->data(), input->data() + chunk, scan_visitor(), count
+    );
+    n -= chunk;
+  }
+
+  prevent_optimization(count);
+}
+
+// the longest match starting at each offset, which already is less work than
+// finding every match //
+template <char Filler, typename Controller>
+void trie_find_longest_prefix_benchmark(Controller &benchmark, std::size_t n) {
+  std::string const *input = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    input = std::addressof(scan_input<Filler>());
+  }
+
+  while (n) {
+    auto const chunk = std::min(n, input->size());
+    auto const end = input->data() + chunk;
+
+    for (auto i = input->data(); i != end; ++i) {
+      count += trie_find_longest_prefix<scan_words>(
+        i, end, scan_visitor(), count
+      );
+    }
+
+    n -= chunk;
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(scan_250_words_upper_filler, aho_corasick_scan, n) {
+  aho_corasick_scan_benchmark<'A'>(benchmark, n);
+}
+
+FATAL_BENCHMARK(
+  scan_250_words_upper_filler,
+  trie_find_longest_prefix_at_every_offset,
+  n
+) {
+  trie_find_longest_prefix_benchmark<'A'>(benchmark, n);
+}
+
+FATAL_BENCHMARK(scan_250_words_lower_filler, aho_corasick_scan, n) {
+  aho_corasick_scan_benchmark<'a'>(benchmark, n);
+}
+
+FATAL_BENCHMARK(
+  scan_250_words_lower_filler,
+  trie_find_longest_prefix_at_every_offset,
+  n
+) {
+  trie_find_longest_prefix_benchmark<'a'>(benchmark, n);
+}
+
+} // namespace fatal {
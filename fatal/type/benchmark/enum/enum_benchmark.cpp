@@ -0,0 +1,460 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/enum.h>
+#include <fatal/type/perfect_hash.h>
+
+#include <fatal/string/rope.h>
+
+#include <fatal/benchmark/benchmark.h>
+#include <fatal/benchmark/driver.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cstring>
+
+namespace fatal {
+
+// Each benchmark iteration converts a single value, so the reported
+// frequency reads directly as conversions per second. Periods are reported
+// with a resolution of 1 ns.
+
+FATAL_RICH_ENUM_CLASS(
+  contiguous_enum,
+  field0, field1, field2, field3, field4, field5, field6, field7,
+  field8, field9, field10, field11, field12, field13, field14, field15
+);
+
+FATAL_RICH_ENUM_CLASS_WITH_FINDER(
+  hashed_enum,
+  ::fatal::perfect_hash_finder,
+  field0, field1, field2, field3, field4, field5, field6, field7,
+  field8, field9, field10, field11, field12, field13, field14, field15
+);
+
+// the `switch` generated by `FATAL_RICH_ENUM_CLASS` //
+struct switch_policy {
+  template <typename Enum>
+  static char const *to_string(Enum e) {
+    using traits = at<
+      registry_lookup<detail::enum_impl::metadata_tag, Enum>,
+      0
+    >;
+    return traits::to_string(e, "");
+  }
+};
+
+// what `enum_traits` uses for traits lacking `to_string` //
+struct scalar_search_policy {
+  struct visitor {
+    template <typename Field, std::size_t Index>
+    void operator ()(indexed<Field, Index>, char const *&out) const {
+      out = z_data<typename Field::name>();
+    }
+  };
+
+  template <typename Enum>
+  static char const *to_string(Enum e) {
+    char const *out = "";
+    scalar_search<typename enum_traits<Enum>::fields, get_type::value>(
+      e, visitor(), out
+    );
+    return out;
+  }
+};
+
+struct enum_traits_policy {
+  template <typename Enum>
+  static char const *to_string(Enum e) {
+    return enum_traits<Enum>::to_string(e, "");
+  }
+};
+
+// a name along with its size //
+struct strlen_policy {
+  template <typename Enum>
+  static string_view to_string(Enum e) {
+    return string_view(enum_traits<Enum>::to_string(e, ""));
+  }
+};
+
+struct names_view_policy {
+  template <typename Enum>
+  static string_view to_string(Enum e) {
+    return enum_traits<Enum>::names_view(e);
+  }
+};
+
+// random values, about 1 in 16 being invalid //
+template <typename Enum>
+std::vector<Enum> const &enum_values() {
+  static auto const values = []() {
+    std::mt19937 rng(0xe9);
+    std::uniform_int_distribution<int> pick(0, 16);
+
+    std::vector<Enum> result(1 << 12);
+    for (auto &value: result) {
+      value = static_cast<Enum>(pick(rng));
+    }
+
+    return result;
+  }();
+
+  return values;
+}
+
+template <typename Enum>
+std::vector<std::string> const &enum_strings() {
+  static auto const strings = []() {
+    std::vector<std::string> result;
+    for (auto value: enum_values<Enum>()) {
+      result.emplace_back(enum_traits<Enum>::to_string(value, "field"));
+    }
+
+    return result;
+  }();
+
+  return strings;
+}
+
+template <typename Policy, typename Enum, typename Controller>
+void to_string_benchmark(Controller &benchmark, std::size_t n) {
+  std::vector<Enum> const *values = nullptr;
+
+  FATAL_BENCHMARK_SUSPEND {
+    values = std::addressof(enum_values<Enum>());
+  }
+
+  // the number of values is a power of 2 //
+  auto const mask = values->size() - 1;
+
+  for (std::size_t i = 0; n--; i = (i + 1) & mask) {
+    auto const s = Policy::template to_string<Enum>((*values)[i]);
+    prevent_optimization(s);
+  }
+}
+
+template <typename Enum, typename Controller>
+void parse_benchmark(Controller &benchmark, std::size_t n) {
+  std::vector<std::string> const *strings = nullptr;
+  std::size_t count = 0;
+  Enum out;
+
+  FATAL_BENCHMARK_SUSPEND {
+    strings = std::addressof(enum_strings<Enum>());
+  }
+
+  // the number of strings is a power of 2 //
+  auto const mask = strings->size() - 1;
+
+  for (std::size_t i = 0; n--; i = (i + 1) & mask) {
+    count += enum_traits<Enum>::try_parse(out, (*strings)[i]);
+  }
+
+  prevent_optimization(count);
+  prevent_optimization(out);
+}
+
+// converts `n` values, a whole column at a time //
+template <typename Enum, typename Controller, typename Convert>
+void column_benchmark(Controller &benchmark, std::size_t n, Convert convert) {
+  std::vector<Enum> const *values = nullptr;
+  std::vector<std::string> const *strings = nullptr;
+  std::vector<char> buffer;
+  std::vector<Enum> out;
+  std::unique_ptr<bool[]> parsed;
+
+  FATAL_BENCHMARK_SUSPEND {
+    values = std::addressof(enum_values<Enum>());
+    strings = std::addressof(enum_strings<Enum>());
+    buffer.resize(
+      values->size() * (enum_traits<Enum>::max_name_size::value + 1)
+    );
+    out.resize(values->size());
+    parsed.reset(new bool[values->size()]);
+  }
+
+  while (n) {
+    auto const size = std::min(n, values->size());
+    convert(*values, *strings, size, buffer.data(), out.data(), parsed.get());
+    prevent_optimization(buffer.front());
+    prevent_optimization(out.front());
+    n -= size;
+  }
+}
+
+struct to_string_loop {
+  template <typename Enum>
+  void operator ()(
+    std::vector<Enum> const &values,
+    std::vector<std::string> const &,
+    std::size_t size,
+    char *buffer,
+    Enum *,
+    bool *
+  ) const {
+    for (std::size_t i = 0; i < size; ++i) {
+      auto const name = enum_traits<Enum>::to_string(values[i], "");
+      auto const length = std::strlen(name);
+      std::memcpy(buffer, name, length);
+      buffer += length;
+      *buffer++ = ',';
+    }
+  }
+};
+
+struct to_string_many_call {
+  template <typename Enum>
+  void operator ()(
+    std::vector<Enum> const &values,
+    std::vector<std::string> const &,
+    std::size_t size,
+    char *buffer,
+    Enum *,
+    bool *
+  ) const {
+    enum_traits<Enum>::to_string_many(
+      values.begin(), values.begin() + size, buffer, ','
+    );
+  }
+};
+
+struct parse_loop {
+  template <typename Enum>
+  void operator ()(
+    std::vector<Enum> const &,
+    std::vector<std::string> const &strings,
+    std::size_t size,
+    char *,
+    Enum *out,
+    bool *parsed
+  ) const {
+    for (std::size_t i = 0; i < size; ++i) {
+      try {
+        out[i] = enum_traits<Enum>::parse(strings[i]);
+        parsed[i] = true;
+      } catch (std::invalid_argument const &) {
+        parsed[i] = false;
+      }
+    }
+  }
+};
+
+struct try_parse_loop {
+  template <typename Enum>
+  void operator ()(
+    std::vector<Enum> const &,
+    std::vector<std::string> const &strings,
+    std::size_t size,
+    char *,
+    Enum *out,
+    bool *parsed
+  ) const {
+    for (std::size_t i = 0; i < size; ++i) {
+      parsed[i] = enum_traits<Enum>::try_parse(out[i], strings[i]);
+    }
+  }
+};
+
+struct parse_many_call {
+  template <typename Enum>
+  void operator ()(
+    std::vector<Enum> const &,
+    std::vector<std::string> const &strings,
+    std::size_t size,
+    char *,
+    Enum *out,
+    bool *parsed
+  ) const {
+    enum_traits<Enum>::parse_many(
+      strings.begin(), strings.begin() + size, out, parsed
+    );
+  }
+};
+
+// appends a log line like `"op=field3 status=field12\n"` to `out`, for
+// two enum values //
+struct log_to_string {
+  template <typename Enum, typename String>
+  static void append(String &out, Enum op, Enum status) {
+    out.append("op=", 3);
+    out.append(enum_traits<Enum>::to_string(op, ""));
+    out.append(" status=", 8);
+    out.append(enum_traits<Enum>::to_string(status, ""));
+    out.push_back('\n');
+  }
+
+  template <typename Enum>
+  static char *append(char *out, Enum op, Enum status) {
+    std::memcpy(out, "op=", 3);
+    out += 3;
+    auto const name1 = enum_traits<Enum>::to_string(op, "");
+    auto const size1 = std::strlen(name1);
+    std::memcpy(out, name1, size1);
+    out += size1;
+    std::memcpy(out, " status=", 8);
+    out += 8;
+    auto const name2 = enum_traits<Enum>::to_string(status, "");
+    auto const size2 = std::strlen(name2);
+    std::memcpy(out, name2, size2);
+    out += size2;
+    *out++ = '\n';
+    return out;
+  }
+};
+
+struct log_append_to {
+  template <typename Enum, typename String>
+  static void append(String &out, Enum op, Enum status) {
+    out.append("op=", 3);
+    enum_traits<Enum>::append_to(out, op);
+    out.append(" status=", 8);
+    enum_traits<Enum>::append_to(out, status);
+    out.push_back('\n');
+  }
+
+  template <typename Enum>
+  static char *append(char *out, Enum op, Enum status) {
+    std::memcpy(out, "op=", 3);
+    out = enum_traits<Enum>::append_to(out + 3, op);
+    std::memcpy(out, " status=", 8);
+    out = enum_traits<Enum>::append_to(out + 8, status);
+    *out++ = '\n';
+    return out;
+  }
+};
+
+template <typename String>
+struct log_output {
+  String out;
+
+  void clear() { out.clear(); }
+
+  template <typename Policy, typename Enum>
+  void append(Enum op, Enum status) {
+    Policy::append(out, op, status);
+  }
+
+  String const &result() const { return out; }
+};
+
+template <>
+struct log_output<char *> {
+  // room for a whole line, plus the slack needed by `append_to` //
+  char out[64];
+  char *end = out;
+
+  void clear() { end = out; }
+
+  template <typename Policy, typename Enum>
+  void append(Enum op, Enum status) {
+    end = Policy::append(end, op, status);
+  }
+
+  char const *result() const { return out; }
+};
+
+// formats one log line per iteration //
+template <typename Policy, typename String, typename Enum, typename Controller>
+void log_benchmark(Controller &benchmark, std::size_t n) {
+  std::vector<Enum> const *values = nullptr;
+  log_output<String> output;
+
+  FATAL_BENCHMARK_SUSPEND {
+    values = std::addressof(enum_values<Enum>());
+  }
+
+  // the number of values is a power of 2 //
+  auto const mask = values->size() - 1;
+
+  for (std::size_t i = 0; n--; i = (i + 2) & mask) {
+    output.clear();
+    output.template append<Policy>((*values)[i], (*values)[i + 1]);
+    prevent_optimization(output.result());
+  }
+}
+
+FATAL_BENCHMARK(to_string, enum_traits, n) {
+  to_string_benchmark<enum_traits_policy, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(to_string, switch, n) {
+  to_string_benchmark<switch_policy, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(to_string, scalar_search, n) {
+  to_string_benchmark<scalar_search_policy, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(name, strlen, n) {
+  to_string_benchmark<strlen_policy, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(name, names_view, n) {
+  to_string_benchmark<names_view_policy, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(parse, trie, n) {
+  parse_benchmark<contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(parse, perfect_hash, n) {
+  parse_benchmark<hashed_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(to_string_column, loop, n) {
+  column_benchmark<contiguous_enum>(benchmark, n, to_string_loop());
+}
+
+FATAL_BENCHMARK(to_string_column, to_string_many, n) {
+  column_benchmark<contiguous_enum>(benchmark, n, to_string_many_call());
+}
+
+FATAL_BENCHMARK(parse_column, loop, n) {
+  column_benchmark<contiguous_enum>(benchmark, n, parse_loop());
+}
+
+FATAL_BENCHMARK(parse_column, try_parse_loop, n) {
+  column_benchmark<contiguous_enum>(benchmark, n, try_parse_loop());
+}
+
+FATAL_BENCHMARK(parse_column, parse_many, n) {
+  column_benchmark<contiguous_enum>(benchmark, n, parse_many_call());
+}
+
+FATAL_BENCHMARK(log_string, to_string, n) {
+  log_benchmark<log_to_string, std::string, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(log_string, append_to, n) {
+  log_benchmark<log_append_to, std::string, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(log_rope, to_string, n) {
+  log_benchmark<log_to_string, rope<>, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(log_rope, append_to, n) {
+  log_benchmark<log_append_to, rope<>, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(log_buffer, to_string, n) {
+  log_benchmark<log_to_string, char *, contiguous_enum>(benchmark, n);
+}
+
+FATAL_BENCHMARK(log_buffer, append_to, n) {
+  log_benchmark<log_append_to, char *, contiguous_enum>(benchmark, n);
+}
+
+} // namespace fatal {
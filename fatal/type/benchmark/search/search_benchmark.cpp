@@ -0,0 +1,355 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/list.h>
+#include <fatal/type/search.h>
+#include <fatal/type/sequence.h>
+
+#include <fatal/benchmark/benchmark.h>
+#include <fatal/benchmark/driver.h>
+
+#include <random>
+#include <vector>
+
+namespace fatal {
+
+// Each benchmark iteration looks up a single needle, so the reported
+// frequency reads directly as lookups per second.
+
+template <typename, std::size_t, typename> struct spaced_values;
+
+// `Size` sorted values of type `T`, `Step` apart //
+template <typename T, std::size_t Step, std::size_t... Values>
+struct spaced_values<T, Step, index_sequence<Values...>> {
+  using type = list<std::integral_constant<T, Values * Step + 1>...>;
+};
+
+template <std::size_t Size, std::size_t Step = 3, typename T = std::size_t>
+using spaced = typename spaced_values<
+  T, Step, make_index_sequence<Size>
+>::type;
+
+// random needles in `[0, Size * Step]`, about 1 in `Step` being one of the
+// `Size` values `Step` apart //
+template <std::size_t Size, std::size_t Step = 3>
+std::vector<std::size_t> const &search_needles() {
+  static auto const needles = []() {
+    std::mt19937 rng(0x5ea2c);
+    std::uniform_int_distribution<std::size_t> pick(0, Size * Step);
+
+    std::vector<std::size_t> result(1 << 16);
+    for (auto &needle: result) {
+      needle = pick(rng);
+    }
+
+    return result;
+  }();
+
+  return needles;
+}
+
+struct search_visitor {
+  template <typename T, std::size_t Index>
+  void operator ()(indexed<T, Index>, std::size_t &count) const {
+    count += Index;
+  }
+};
+
+struct sorted_search_policy {
+  template <typename T, typename Needle>
+  static bool search(Needle needle, std::size_t &count) {
+    return sorted_search<T>(needle, search_visitor(), count);
+  }
+};
+
+struct eytzinger_search_policy {
+  template <typename T, typename Needle>
+  static bool search(Needle needle, std::size_t &count) {
+    return eytzinger_search<T>(needle, search_visitor(), count);
+  }
+};
+
+template <typename Policy>
+struct scalar_search_policy {
+  template <typename T, typename Needle>
+  static bool search(Needle needle, std::size_t &count) {
+    return scalar_search<T, get_identity, value_comparer, Policy>(
+      needle, search_visitor(), count
+    );
+  }
+};
+
+template <typename Policy>
+struct index_search_policy {
+  template <typename T, typename Needle>
+  static bool search(Needle needle, std::size_t &count) {
+    return index_search<T, Policy>(needle, search_visitor(), count);
+  }
+};
+
+template <
+  typename Policy,
+  std::size_t Size,
+  std::size_t Step = 3,
+  typename T = std::size_t,
+  typename Controller
+>
+void search_benchmark(Controller &benchmark, std::size_t n) {
+  std::vector<std::size_t> const *needles = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    needles = std::addressof(search_needles<Size, Step>());
+  }
+
+  // the number of needles is a power of 2 //
+  auto const mask = needles->size() - 1;
+
+  for (std::size_t i = 0; n--; i = (i + 1) & mask) {
+    count += Policy::template search<spaced<Size, Step, T>>(
+      static_cast<T>((*needles)[i]), count
+    );
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(search_16, sorted_search, n) {
+  search_benchmark<sorted_search_policy, 16>(benchmark, n);
+}
+
+FATAL_BENCHMARK(search_16, eytzinger_search, n) {
+  search_benchmark<eytzinger_search_policy, 16>(benchmark, n);
+}
+
+FATAL_BENCHMARK(search_64, sorted_search, n) {
+  search_benchmark<sorted_search_policy, 64>(benchmark, n);
+}
+
+FATAL_BENCHMARK(search_64, eytzinger_search, n) {
+  search_benchmark<eytzinger_search_policy, 64>(benchmark, n);
+}
+
+FATAL_BENCHMARK(search_256, sorted_search, n) {
+  search_benchmark<sorted_search_policy, 256>(benchmark, n);
+}
+
+FATAL_BENCHMARK(search_256, eytzinger_search, n) {
+  search_benchmark<eytzinger_search_policy, 256>(benchmark, n);
+}
+
+FATAL_BENCHMARK(search_1024, sorted_search, n) {
+  search_benchmark<sorted_search_policy, 1024>(benchmark, n);
+}
+
+FATAL_BENCHMARK(search_1024, eytzinger_search, n) {
+  search_benchmark<eytzinger_search_policy, 1024>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_4, scalar_search, n) {
+  search_benchmark<scalar_search_policy<search_policy<>>, 4, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_4, scalar_search_no_jump_table, n) {
+  search_benchmark<scalar_search_policy<search_policy<0>>, 4, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(dense_4, index_search, n) {
+  search_benchmark<index_search_policy<search_policy<>>, 4, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_4, index_search_no_jump_table, n) {
+  search_benchmark<index_search_policy<search_policy<0>>, 4, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(dense_16, scalar_search, n) {
+  search_benchmark<scalar_search_policy<search_policy<>>, 16, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_16, scalar_search_no_jump_table, n) {
+  search_benchmark<scalar_search_policy<search_policy<0>>, 16, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(dense_16, index_search, n) {
+  search_benchmark<index_search_policy<search_policy<>>, 16, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_16, index_search_no_jump_table, n) {
+  search_benchmark<index_search_policy<search_policy<0>>, 16, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(dense_64, scalar_search, n) {
+  search_benchmark<scalar_search_policy<search_policy<>>, 64, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_64, scalar_search_no_jump_table, n) {
+  search_benchmark<scalar_search_policy<search_policy<0>>, 64, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(dense_64, index_search, n) {
+  search_benchmark<index_search_policy<search_policy<>>, 64, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_64, index_search_no_jump_table, n) {
+  search_benchmark<index_search_policy<search_policy<0>>, 64, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(dense_256, scalar_search, n) {
+  search_benchmark<scalar_search_policy<search_policy<>>, 256, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_256, scalar_search_no_jump_table, n) {
+  search_benchmark<scalar_search_policy<search_policy<0>>, 256, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(dense_256, index_search, n) {
+  search_benchmark<index_search_policy<search_policy<>>, 256, 1>(benchmark, n);
+}
+
+FATAL_BENCHMARK(dense_256, index_search_no_jump_table, n) {
+  search_benchmark<index_search_policy<search_policy<0>>, 256, 1>(
+    benchmark, n
+  );
+}
+
+FATAL_BENCHMARK(small_4, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 4, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_4, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 4, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_4, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 4, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_4, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 4, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_4, jump_table, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<50, 256, 0>>, 4, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_8, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 8, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_8, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 8, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_8, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 8, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_8, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 8, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_8, jump_table, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<50, 256, 0>>, 8, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_16, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 16, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_16, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 16, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_16, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 16, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_16, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 16, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_16, jump_table, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<50, 256, 0>>, 16, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_32, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 32, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_32, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 32, 3, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_32, nested, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 0>>, 32, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_32, linear, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<0, 256, 32>>, 32, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+FATAL_BENCHMARK(small_dense_32, jump_table, n) {
+  search_benchmark<
+    scalar_search_policy<search_policy<50, 256, 0>>, 32, 1, std::uint16_t
+  >(benchmark, n);
+}
+
+} // namespace fatal {
@@ -1,15 +1,72 @@
 #include <fatal/test/words.h>
+#include <fatal/type/cat.h>
+#include <fatal/type/transform.h>
 #include <fatal/type/trie.h>
 
 #include <iostream>
 #include <string>
 
+// number of keys in the trie: one of 100, 250, 500, 1000 or 2000
+// see compile-time.sh for measuring compile time and memory usage
+#ifndef FATAL_TRIE_COMPILE_TIME_KEYS
+# define FATAL_TRIE_COMPILE_TIME_KEYS 250
+#endif
+
+namespace fatal {
+
+template <typename> struct suffixed;
+
+template <char... Chars>
+struct suffixed<sequence<char, Chars...>> {
+  using type = sequence<char, Chars..., '2'>;
+};
+
+struct suffix {
+  template <typename T>
+  using apply = typename suffixed<T>::type;
+};
+
+template <std::size_t> struct compile_time_keys;
+
+template <>
+struct compile_time_keys<100> {
+  using type = random_100_words<list, sequence>;
+};
+
+template <>
+struct compile_time_keys<250> {
+  using type = random_250_words<list, sequence>;
+};
+
+template <>
+struct compile_time_keys<500> {
+  using type = random_500_words<list, sequence>;
+};
+
+template <>
+struct compile_time_keys<1000> {
+  using type = random_1000_words<list, sequence>;
+};
+
+// every word, plus the same word with an additional character
+template <>
+struct compile_time_keys<2000> {
+  using type = cat<
+    random_1000_words<list, sequence>,
+    transform<random_1000_words<list, sequence>, suffix>
+  >;
+};
+
+} // namespace fatal {
+
 int main() {
   using namespace fatal;
 
+  using keys = compile_time_keys<FATAL_TRIE_COMPILE_TIME_KEYS>::type;
+
   for (std::string needle; std::cin >> needle; ) {
     std::cout << needle << ": " << std::boolalpha
-      << trie_find<random_250_words<list, sequence>>(
+      << trie_find<keys>(
         needle.begin(),
         needle.end()
       )
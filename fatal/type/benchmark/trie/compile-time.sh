@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# measures how long it takes to compile a trie of 100, 500, 1000 and 2000 keys
+# along with the peak memory used by the compiler
+#
+# usage (from the repository root): fatal/type/benchmark/trie/compile-time.sh
+#
+# set `KEYS` to measure a different set of sizes, from the ones supported by
+# compile-time.cpp
+
+. ./scripts.inc
+
+set -e
+
+if [ -z "$USE_CC" ]; then
+  export USE_CC="$default_compiler"
+fi
+
+if [ -z "$USE_STD" ]; then
+  export USE_STD="c++17"
+fi
+
+if [ -z "$KEYS" ]; then
+  KEYS="100 500 1000 2000"
+fi
+
+file_name="fatal/type/benchmark/trie/compile-time.cpp"
+
+for keys in $KEYS; do
+  echo "$keys keys:"
+
+  if [ -x /usr/bin/time ]; then
+    /usr/bin/time -f "  %e seconds, %M KB peak memory" \
+      "$USE_CC" -O2 -Wall -Werror -Wextra -ftemplate-depth-1024 \
+        "-std=$USE_STD" -I . "-DFATAL_TRIE_COMPILE_TIME_KEYS=$keys" \
+        -o /dev/null -c "$file_name"
+  else
+    time "$USE_CC" -O2 -Wall -Werror -Wextra -ftemplate-depth-1024 \
+      "-std=$USE_STD" -I . "-DFATAL_TRIE_COMPILE_TIME_KEYS=$keys" \
+      -o /dev/null -c "$file_name"
+  fi
+done
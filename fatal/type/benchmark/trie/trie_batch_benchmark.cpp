@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/container/runtime_trie.h>
+#include <fatal/test/words.h>
+#include <fatal/type/array.h>
+#include <fatal/type/trie.h>
+
+#include <fatal/benchmark/benchmark.h>
+#include <fatal/benchmark/driver.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fatal {
+
+// Each benchmark iteration looks up a single token, so the reported frequency
+// reads directly as tokens per second.
+
+using batch_words = random_250_words<list, sequence>;
+
+// about 3 in 4 tokens are found //
+std::vector<std::string> const &batch_tokens() {
+  static auto const tokens = []() {
+    using words = z_array<batch_words, char const *>;
+
+    std::mt19937 rng(0x7a11e);
+    std::uniform_int_distribution<std::size_t> pick(0, words::size::value - 1);
+
+    std::vector<std::string> result(1 << 16);
+    for (auto &token: result) {
+      token = words::data[pick(rng)];
+
+      switch (rng() % 8) {
+        case 0: token.back() = '!'; break;
+        case 1: token.pop_back(); break;
+        default: break;
+      }
+    }
+
+    return result;
+  }();
+
+  return tokens;
+}
+
+struct batch_visitor {
+  template <typename String>
+  void operator ()(tag<String>, std::size_t &count) const {
+    count += size<String>::value;
+  }
+
+  template <typename String>
+  void operator ()(tag<String>, std::size_t, std::size_t &count) const {
+    count += size<String>::value;
+  }
+};
+
+template <typename Policy, typename Controller>
+void trie_find_batch_benchmark(Controller &benchmark, std::size_t n) {
+  std::vector<std::string> const *tokens = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    tokens = std::addressof(batch_tokens());
+  }
+
+  while (n) {
+    auto const chunk = std::min(n, tokens->size());
+    count += trie_find_batch<batch_words, get_identity, less, Policy>(
+      tokens->begin(), std::next(tokens->begin(), chunk), batch_visitor(), count
+    );
+    n -= chunk;
+  }
+
+  prevent_optimization(count);
+}
+
+template <typename Policy, typename Controller>
+void trie_find_benchmark(Controller &benchmark, std::size_t n) {
+  std::vector<std::string> const *tokens = nullptr;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    tokens = std::addressof(batch_tokens());
+  }
+
+  for (std::size_t i = 0; n--; i = (i + 1) % tokens->size()) {
+    auto const &s = (*tokens)[i];
+    count += trie_find<batch_words, get_identity, less, Policy>(
+      s.data(), s.data() + s.size(), batch_visitor(), count
+    );
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find, n) {
+  trie_find_benchmark<trie_policy<>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_no_jump_table, n) {
+  trie_find_benchmark<trie_policy<true, 8, 0>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_jump_table_fanout_2, n) {
+  trie_find_benchmark<trie_policy<true, 8, 2>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_jump_table_fanout_4, n) {
+  trie_find_benchmark<trie_policy<true, 8, 4>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_jump_table_fanout_8, n) {
+  trie_find_benchmark<trie_policy<true, 8, 8>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_jump_table_fanout_16, n) {
+  trie_find_benchmark<trie_policy<true, 8, 16>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, runtime_trie, n) {
+  using words = z_array<batch_words, char const *>;
+
+  std::vector<std::string> const *tokens = nullptr;
+  std::unique_ptr<runtime_trie> trie;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    tokens = std::addressof(batch_tokens());
+    trie.reset(
+      new runtime_trie(words::data, words::data + words::size::value)
+    );
+  }
+
+  for (std::size_t i = 0; n--; i = (i + 1) % tokens->size()) {
+    auto const &s = (*tokens)[i];
+    count += trie->find(
+      s.data(),
+      s.data() + s.size(),
+      [&count](std::size_t index) { count += index; }
+    );
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(tokens_250_words, std_unordered_map, n) {
+  using words = z_array<batch_words, char const *>;
+
+  std::vector<std::string> const *tokens = nullptr;
+  std::unordered_map<std::string, std::size_t> map;
+  std::size_t count = 0;
+
+  FATAL_BENCHMARK_SUSPEND {
+    tokens = std::addressof(batch_tokens());
+    for (std::size_t i = 0; i < words::size::value; ++i) {
+      map.emplace(words::data[i], i);
+    }
+  }
+
+  for (std::size_t i = 0; n--; i = (i + 1) % tokens->size()) {
+    auto const j = map.find((*tokens)[i]);
+    if (j != map.end()) {
+      count += j->second + 1;
+    }
+  }
+
+  prevent_optimization(count);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_batch_no_lookahead, n) {
+  trie_find_batch_benchmark<trie_policy<true, 0>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_batch_lookahead_4, n) {
+  trie_find_batch_benchmark<trie_policy<true, 4>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_batch_lookahead_8, n) {
+  trie_find_batch_benchmark<trie_policy<true, 8>>(benchmark, n);
+}
+
+FATAL_BENCHMARK(tokens_250_words, trie_find_batch_lookahead_16, n) {
+  trie_find_batch_benchmark<trie_policy<true, 16>>(benchmark, n);
+}
+
+} // namespace fatal {
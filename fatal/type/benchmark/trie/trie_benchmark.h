@@ -7,6 +7,8 @@
  *  of patent rights can be found in the PATENTS file in the same directory.
  */
 
+#include <fatal/container/runtime_trie.h>
+#include <fatal/type/perfect_hash.h>
 #include <fatal/type/trie.h>
 #include <fatal/type/sequence.h>
 
@@ -77,6 +79,57 @@ struct benchmark_impl {
     prevent_optimization(count);
   }
 
+  template <typename Policy, typename Controller>
+  static void trie_pointer_benchmark(Controller &benchmark) {
+    unsigned count = 0;
+
+    FATAL_BENCHMARK_SUSPEND {}
+
+    for (auto const &s: str) {
+      trie_find<list<Strings...>, get_identity, less, Policy>(
+        s.data(), s.data() + s.size(), visitor{}, s, count
+      );
+    }
+
+    prevent_optimization(count);
+  }
+
+  template <typename Controller>
+  static void perfect_hash_benchmark(Controller &benchmark) {
+    unsigned count = 0;
+
+    FATAL_BENCHMARK_SUSPEND {}
+
+    for (auto const &s: str) {
+      perfect_hash_find<list<Strings...>>(
+        s.data(), s.data() + s.size(), visitor{}, s, count
+      );
+    }
+
+    prevent_optimization(count);
+  }
+
+  template <typename Controller>
+  static void runtime_trie_benchmark(Controller &benchmark) {
+    unsigned count = 0;
+    runtime_trie const *trie = nullptr;
+
+    FATAL_BENCHMARK_SUSPEND {
+      static runtime_trie const instance(str.begin(), str.end());
+      trie = std::addressof(instance);
+    }
+
+    for (auto const &s: str) {
+      trie->find(
+        s.data(),
+        s.data() + s.size(),
+        [&count, &s](std::size_t) { count += s.size(); }
+      );
+    }
+
+    prevent_optimization(count);
+  }
+
   template <typename Controller>
   static void sequential_ifs_benchmark(Controller &benchmark) {
     unsigned count = 0;
@@ -199,6 +252,26 @@ std::array<std::string, sizeof...(Strings)> const benchmark_impl<
     prevent_optimization(Name##_warmup); \
     Name##_impl::trie_benchmark(benchmark); \
   } \
+  FATAL_BENCHMARK(Name, type_prefix_tree_bytewise) { \
+    prevent_optimization(Name##_warmup); \
+    Name##_impl::trie_pointer_benchmark<trie_policy<false>>(benchmark); \
+  } \
+  FATAL_BENCHMARK(Name, type_prefix_tree_wordwise) { \
+    prevent_optimization(Name##_warmup); \
+    Name##_impl::trie_pointer_benchmark<trie_policy<true>>(benchmark); \
+  } \
+  FATAL_BENCHMARK(Name, type_prefix_tree_jump_table) { \
+    prevent_optimization(Name##_warmup); \
+    Name##_impl::trie_pointer_benchmark<trie_policy<true, 8, 8>>(benchmark); \
+  } \
+  FATAL_BENCHMARK(Name, runtime_trie) { \
+    prevent_optimization(Name##_warmup); \
+    Name##_impl::runtime_trie_benchmark(benchmark); \
+  } \
+  FATAL_BENCHMARK(Name, perfect_hash) { \
+    prevent_optimization(Name##_warmup); \
+    Name##_impl::perfect_hash_benchmark(benchmark); \
+  } \
   FATAL_BENCHMARK(Name, sorted_std_array) { \
     prevent_optimization(Name##_warmup); \
     Name##_impl::sorted_std_array_benchmark(benchmark); \
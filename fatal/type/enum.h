@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <fatal/portability.h>
 #include <fatal/preprocessor.h>
 #include <fatal/string/string_view.h>
 #include <fatal/type/apply.h>
@@ -21,14 +22,17 @@
 #include <fatal/type/search.h>
 #include <fatal/type/sequence.h>
 #include <fatal/type/slice.h>
+#include <fatal/type/sort.h>
 #include <fatal/type/traits.h>
 #include <fatal/type/transform.h>
 #include <fatal/type/trie.h>
 
+#include <algorithm>
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
 
+#include <cstdint>
 #include <cstring>
 
 namespace fatal {
@@ -37,6 +41,424 @@ namespace enum_impl {
 
 struct metadata_tag {};
 
+// the lookup backend used by `enum_traits::parse` unless told otherwise: the
+// traits' `finder`, if any, or a trie //
+template <typename Traits, typename = void>
+struct finder { using type = trie_finder<>; };
+
+template <typename Traits>
+struct finder<
+  Traits,
+  typename std::conditional<true, void, typename Traits::finder>::type
+> {
+  using type = typename Traits::finder;
+};
+
+// the sum and the longest of the given sizes //
+constexpr std::size_t total() { return 0; }
+
+template <typename... Sizes>
+constexpr std::size_t total(std::size_t head, Sizes... tail) {
+  return head + total(tail...);
+}
+
+constexpr std::size_t longest() { return 0; }
+
+template <typename... Sizes>
+constexpr std::size_t longest(std::size_t head, Sizes... tail) {
+  auto const rest = longest(tail...);
+  return head < rest ? rest : head;
+}
+
+// names back to back in a single array, each one followed by a null
+// terminator, along with the offset where each one starts and, last, the
+// offset past the last one //
+template <std::size_t Size, std::size_t Count>
+struct blob {
+  // one more null terminator, so that the array is never empty //
+  char data[Size + 1];
+  std::size_t offset[Count + 1];
+};
+
+template <typename Blob, typename... Names>
+constexpr Blob make_blob() {
+  // leading dummies, so that the arrays are never empty //
+  char const *const name[] = {nullptr, z_data<Names>()...};
+  std::size_t const length[] = {0, size<Names>::value...};
+
+  Blob result{};
+  std::size_t end = 0;
+
+  for (std::size_t i = 0; i < sizeof...(Names); ++i) {
+    result.offset[i] = end;
+
+    for (std::size_t j = 0; j < length[i + 1]; ++j) {
+      result.data[end++] = name[i + 1][j];
+    }
+
+    result.data[end++] = '\0';
+  }
+
+  result.offset[sizeof...(Names)] = end;
+  return result;
+}
+
+// the names of the fields of `Enum`, sorted by value, in a single blob: when
+// the values are contiguous, they're indexed by the offset of the value from
+// the smallest one //
+template <
+  typename Enum,
+  typename Fields,
+  typename = make_index_sequence<size<Fields>::value>
+>
+class names_table;
+
+template <typename Enum, typename Fields, std::size_t... Indexes>
+class names_table<Enum, Fields, index_sequence<Indexes...>> {
+  using int_type = typename std::underlying_type<Enum>::type;
+
+  template <std::size_t Index>
+  using name = typename at<Fields, Index>::name;
+
+  template <std::size_t Index>
+  using value = std::integral_constant<
+    std::uintmax_t,
+    static_cast<std::uintmax_t>(
+      static_cast<int_type>(at<Fields, Index>::value::value)
+    )
+  >;
+
+  struct visitor {
+    template <typename Field, std::size_t Index>
+    void operator ()(indexed<Field, Index>, std::size_t &out) const {
+      out = Index;
+    }
+  };
+
+  // the offset of `e` from the smallest value, which is out of bounds for
+  // values that don't belong to the enum //
+  static constexpr std::uintmax_t offset(Enum e) {
+    return static_cast<std::uintmax_t>(static_cast<int_type>(e))
+      - value<0>::value;
+  }
+
+  static std::size_t find(Enum e, std::true_type) {
+    return offset(e) < sizeof...(Indexes)
+      ? static_cast<std::size_t>(offset(e))
+      : sizeof...(Indexes);
+  }
+
+  static std::size_t find(Enum e, std::false_type) {
+    std::size_t out = sizeof...(Indexes);
+    scalar_search<Fields, get_type::value>(e, visitor(), out);
+    return out;
+  }
+
+public:
+  using contiguous = std::integral_constant<
+    bool,
+    sizeof...(Indexes) && std::is_same<
+      sequence<std::uintmax_t, (value<Indexes>::value - value<0>::value)...>,
+      sequence<std::uintmax_t, Indexes...>
+    >::value
+  >;
+
+  using longest = std::integral_constant<
+    std::size_t,
+    enum_impl::longest(size<name<Indexes>>::value...)
+  >;
+
+  // padded so that `longest` characters can be copied from any name //
+  using blob_type = blob<
+    enum_impl::total((size<name<Indexes>>::value + 1)...) + longest::value,
+    sizeof...(Indexes)
+  >;
+
+  static constexpr blob_type names = make_blob<blob_type, name<Indexes>...>();
+
+  // the position of `e` in the sorted fields, or their count if it doesn't
+  // belong to the enum //
+  static std::size_t find(Enum e) {
+    return find(e, contiguous());
+  }
+
+  // copies `longest` characters, starting at the name at `index`, to `out`,
+  // returning a pointer past the end of the name //
+  static char *copy(std::size_t index, char *out) {
+    std::memcpy(out, names.data + names.offset[index], longest::value);
+    return out + (names.offset[index + 1] - names.offset[index] - 1);
+  }
+
+  static string_view view(std::size_t index) {
+    return string_view(
+      names.data + names.offset[index],
+      names.offset[index + 1] - names.offset[index] - 1
+    );
+  }
+};
+
+// the size of the longest name among `Fields` //
+template <typename> struct longest_name;
+
+template <template <typename...> class List, typename... Fields>
+struct longest_name<List<Fields...>> {
+  using type = std::integral_constant<
+    std::size_t,
+    enum_impl::longest(size<typename Fields::name>::value...)
+  >;
+};
+
+// the names of the fields of `Enum` indexed by the offset of their value from
+// the smallest one, built in declaration order so that the fields don't need
+// to be sorted: only meaningful when the values are contiguous //
+template <
+  typename Enum,
+  typename Fields,
+  typename = make_index_sequence<size<Fields>::value>
+>
+class offset_table;
+
+template <typename Enum, typename Fields, std::size_t... Indexes>
+class offset_table<Enum, Fields, index_sequence<Indexes...>> {
+  using int_type = typename std::underlying_type<Enum>::type;
+
+  // a trailing dummy, so that the arrays are never empty //
+  struct values_type {
+    int_type data[sizeof...(Indexes) + 1];
+  };
+
+  struct names_type {
+    char const *data[sizeof...(Indexes) + 1];
+  };
+
+  static constexpr values_type const values{{
+    static_cast<int_type>(at<Fields, Indexes>::value::value)..., int_type()
+  }};
+
+  static constexpr int_type smallest() {
+    auto result = values.data[0];
+
+    for (std::size_t i = 1; i < sizeof...(Indexes); ++i) {
+      result = values.data[i] < result ? values.data[i] : result;
+    }
+
+    return result;
+  }
+
+  static constexpr std::uintmax_t offset(int_type value) {
+    return static_cast<std::uintmax_t>(value)
+      - static_cast<std::uintmax_t>(smallest());
+  }
+
+  // every value lies within `sizeof...(Indexes)` of the smallest one, and no
+  // two values are the same //
+  static constexpr bool is_contiguous() {
+    bool seen[sizeof...(Indexes) + 1] = {};
+
+    for (std::size_t i = 0; i < sizeof...(Indexes); ++i) {
+      auto const slot = offset(values.data[i]);
+
+      if (slot >= sizeof...(Indexes) || seen[slot]) {
+        return false;
+      }
+
+      seen[slot] = true;
+    }
+
+    return sizeof...(Indexes) != 0;
+  }
+
+public:
+  using contiguous = std::integral_constant<bool, is_contiguous()>;
+
+private:
+  static constexpr names_type make_names() {
+    char const *const name[] = {
+      z_data<typename at<Fields, Indexes>::name>()..., nullptr
+    };
+
+    names_type result{};
+
+    for (std::size_t i = 0; contiguous::value && i < sizeof...(Indexes); ++i) {
+      result.data[offset(values.data[i])] = name[i];
+    }
+
+    return result;
+  }
+
+  static constexpr names_type const names = make_names();
+
+public:
+  static constexpr bool is_valid(Enum e) {
+    return offset(static_cast<int_type>(e)) < sizeof...(Indexes);
+  }
+
+  static constexpr char const *to_string(Enum e, char const *fallback) {
+    return is_valid(e)
+      ? names.data[offset(static_cast<int_type>(e))]
+      : fallback;
+  }
+};
+
+// the number of bits indexing the slots of a `column_table` for `count` names:
+// at least twice as many slots as names, so that probing always hits an empty
+// slot //
+constexpr std::size_t column_bits(std::size_t count) {
+  std::size_t result = 1;
+
+  while ((std::size_t(1) << result) < 2 * count) {
+    ++result;
+  }
+
+  return result;
+}
+
+// multiplicative hashing of the size and the first and last characters, which
+// tells apart names that only differ by a suffix or by their size //
+constexpr std::size_t column_hash(
+  std::size_t bits,
+  std::size_t size,
+  char first,
+  char last
+) {
+  auto const key = size
+    ^ (static_cast<std::size_t>(static_cast<unsigned char>(first)) << 8)
+    ^ (static_cast<std::size_t>(static_cast<unsigned char>(last)) << 16);
+
+  return static_cast<std::uint32_t>(key * 0x9e3779b1u) >> (32 - bits);
+}
+
+// an open addressing hash table over the names of the fields of `Enum`, keyed
+// by their size and their first and last characters, so that parsing a whole
+// column costs a single probe and comparison for most strings, instead of a
+// walk down the finder for each one //
+template <
+  typename Enum,
+  typename Fields,
+  typename = make_index_sequence<size<Fields>::value>
+>
+class column_table;
+
+template <typename Enum, typename Fields, std::size_t... Indexes>
+class column_table<Enum, Fields, index_sequence<Indexes...>> {
+  using bits = std::integral_constant<
+    std::size_t,
+    column_bits(sizeof...(Indexes))
+  >;
+
+  using slots = std::integral_constant<std::size_t, 1u << bits::value>;
+
+  using longest = std::integral_constant<
+    std::size_t,
+    enum_impl::longest(size<typename at<Fields, Indexes>::name>::value...)
+  >;
+
+  // the fields in declaration order, with a trailing dummy so that the arrays
+  // are never empty, and the slots holding their indexes, or
+  // `sizeof...(Indexes)` when empty //
+  struct table_type {
+    char const *name[sizeof...(Indexes) + 1];
+    std::size_t size[sizeof...(Indexes) + 1];
+    Enum value[sizeof...(Indexes) + 1];
+    std::size_t slot[slots::value];
+  };
+
+  static constexpr table_type make_table() {
+    table_type result{
+      {z_data<typename at<Fields, Indexes>::name>()..., nullptr},
+      {size<typename at<Fields, Indexes>::name>::value..., 0},
+      {at<Fields, Indexes>::value::value..., Enum()},
+      {}
+    };
+
+    for (std::size_t i = 0; i < slots::value; ++i) {
+      result.slot[i] = sizeof...(Indexes);
+    }
+
+    for (std::size_t i = 0; i < sizeof...(Indexes); ++i) {
+      auto const size = result.size[i];
+      auto slot = column_hash(
+        bits::value,
+        size,
+        size ? result.name[i][0] : '\0',
+        size ? result.name[i][size - 1] : '\0'
+      );
+
+      while (result.slot[slot] != sizeof...(Indexes)) {
+        slot = (slot + 1) & (slots::value - 1);
+      }
+
+      result.slot[slot] = i;
+    }
+
+    return result;
+  }
+
+  static constexpr table_type const table = make_table();
+
+public:
+  // sets `out` to the value of the field named by `[begin, end)`, returning
+  // whether there's one //
+  template <typename Iterator>
+  static bool find(Iterator begin, Iterator end, Enum &out) {
+    auto const size = static_cast<std::size_t>(std::distance(begin, end));
+
+    if (size > longest::value) {
+      return false;
+    }
+
+    auto slot = column_hash(
+      bits::value,
+      size,
+      size ? *begin : '\0',
+      size ? *std::prev(end) : '\0'
+    );
+
+    for (;; slot = (slot + 1) & (slots::value - 1)) {
+      auto const index = table.slot[slot];
+
+      if (index == sizeof...(Indexes)) {
+        return false;
+      }
+
+      auto const name = table.name[index];
+
+      if (table.size[index] == size && std::equal(begin, end, name)) {
+        out = table.value[index];
+        return true;
+      }
+    }
+  }
+};
+
+#if FATAL_CPLUSPLUS < 201703L
+template <typename Enum, typename Fields, std::size_t... Indexes>
+constexpr typename names_table<
+  Enum, Fields, index_sequence<Indexes...>
+>::blob_type names_table<Enum, Fields, index_sequence<Indexes...>>::names;
+
+template <typename Enum, typename Fields, std::size_t... Indexes>
+constexpr typename offset_table<
+  Enum, Fields, index_sequence<Indexes...>
+>::values_type const offset_table<
+  Enum, Fields, index_sequence<Indexes...>
+>::values;
+
+template <typename Enum, typename Fields, std::size_t... Indexes>
+constexpr typename offset_table<
+  Enum, Fields, index_sequence<Indexes...>
+>::names_type const offset_table<
+  Enum, Fields, index_sequence<Indexes...>
+>::names;
+
+template <typename Enum, typename Fields, std::size_t... Indexes>
+constexpr typename column_table<
+  Enum, Fields, index_sequence<Indexes...>
+>::table_type const column_table<
+  Enum, Fields, index_sequence<Indexes...>
+>::table;
+#endif
+
 } // namespace enum_impl {
 } // namespace detail {
 
@@ -255,7 +677,34 @@ public:
   template <typename Name>
   using value_of = typename get<fields, Name, get_type::name>::value;
 
+  /**
+   * The lookup backend used by `parse()` and `try_parse()` when none is
+   * given. It's the traits' `finder` member, if any, or `trie_finder<>`
+   * otherwise.
+   *
+   * See `FATAL_RICH_ENUM_WITH_FINDER` for choosing it when declaring the enum.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, field1, field2);
+   *
+   *  // yields `trie_finder<>`
+   *  using result = enum_traits<my_enum>::finder;
+   */
+  using finder = typename detail::enum_impl::finder<traits>::type;
+
 private:
+  using offset_table = detail::enum_impl::offset_table<type, fields>;
+  using column_table = detail::enum_impl::column_table<type, fields>;
+
+  // a template so that the fields are only sorted by the functions that need
+  // the names in a single blob //
+  template <typename Fields = fields>
+  using names_table = detail::enum_impl::names_table<
+    type,
+    sort<Fields, value_comparer, get_type::value>
+  >;
+
   struct parser {
     template <typename Field>
     void operator ()(tag<Field>, Enum &out) {
@@ -263,22 +712,49 @@ private:
     }
   };
 
-  struct to_string_visitor {
-    template <typename Field, std::size_t Index>
-    void operator ()(indexed<Field, Index>, char const *&out) const {
-      out = z_data<typename Field::name>();
-    }
-  };
-
   struct to_string_fallback {
     char const *operator ()(type e, char const *fallback) const {
-      scalar_search<fields, get_type::value>(e, to_string_visitor(), fallback);
-
-      return fallback;
+      auto const index = names_table<>::find(e);
+      return index < size<fields>::value
+        ? names_table<>::names.data + names_table<>::names.offset[index]
+        : fallback;
     }
   };
 
+  static constexpr bool is_valid(type e, std::true_type) {
+    return offset_table::is_valid(e);
+  }
+
+  static constexpr bool is_valid(type e, std::false_type) {
+    return scalar_search<fields, get_type::value>(e);
+  }
+
+  static char const *to_string(type e, char const *fallback, std::true_type) {
+    return offset_table::to_string(e, fallback);
+  }
+
+  static char const *to_string(type e, char const *fallback, std::false_type) {
+    using caller = call_traits::to_string::static_member::bind<traits>;
+    return call_if_supported<caller, to_string_fallback>(e, fallback);
+  }
+
 public:
+  /**
+   * The size of the longest name among the enumeration fields, as a
+   * `std::integral_constant`. Useful for sizing the buffer given to
+   * `to_string_many()`.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, (field10, 10), field11);
+   *
+   *  // yields `std::integral_constant<std::size_t, 7>`
+   *  using result = enum_traits<my_enum>::max_name_size;
+   */
+  using max_name_size = typename detail::enum_impl::longest_name<
+    fields
+  >::type;
+
   /**
    * Tells if the given value is a valid value for this enum.
    *
@@ -299,7 +775,7 @@ public:
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
   static constexpr bool is_valid(type e) {
-    return scalar_search<fields, get_type::value>(e);
+    return is_valid(e, typename offset_table::contiguous());
   }
 
   /**
@@ -309,6 +785,9 @@ public:
    *
    * The default value for `fallback` is `nullptr`.
    *
+   * When the values of the enum are contiguous, this is a bounds checked
+   * lookup into an array of names.
+   *
    * See also `enum_to_string()` for a convenient shortcut.
    *
    * Example:
@@ -321,8 +800,7 @@ public:
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
   static char const *to_string(type e, char const *fallback = nullptr) {
-    using caller = call_traits::to_string::static_member::bind<traits>;
-    return call_if_supported<caller, to_string_fallback>(e, fallback);
+    return to_string(e, fallback, typename offset_table::contiguous());
   }
 
   /**
@@ -345,13 +823,21 @@ public:
    *  // throws `std::invalid_argument`
    *  auto result2 = enum_traits<my_enum>::parse(f2.begin(), f2.end());
    *
+   * The lookup backend can be chosen with `Finder`, which defaults to
+   * `finder`. See also `trie_finder` and `perfect_hash_finder`.
+   *
+   *  // returns `my_enum::field0`, looked up through a perfect hash
+   *  auto result3 = enum_traits<my_enum>::parse<perfect_hash_finder>(
+   *    f1.begin(), f1.end()
+   *  );
+   *
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
-  template <typename TBegin, typename TEnd>
+  template <typename Finder = finder, typename TBegin, typename TEnd>
   static type parse(TBegin &&begin, TEnd &&end) {
     type out;
 
-    if (!trie_find<fields, get_type::name>(
+    if (!Finder::template find<fields, get_type::name>(
       static_cast<TBegin &&>(begin), static_cast<TEnd &&>(end), parser(), out
     )) {
       throw std::invalid_argument("unrecognized enum value");
@@ -375,9 +861,9 @@ public:
    *
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
-  template <typename TString>
+  template <typename Finder = finder, typename TString>
   static type parse(TString const &s) {
-    return parse(std::begin(s), std::end(s));
+    return parse<Finder>(std::begin(s), std::end(s));
   }
 
   /**
@@ -401,11 +887,13 @@ public:
    *  // returns `false` and leaves `out` untouched
    *  bool result2 = enum_traits<my_enum>::try_parse(out, f2.begin(), f2.end());
    *
+   * The lookup backend can be chosen with `Finder`, as in `parse()`.
+   *
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
-  template <typename TBegin, typename TEnd>
+  template <typename Finder = finder, typename TBegin, typename TEnd>
   static constexpr bool try_parse(type &out, TBegin &&begin, TEnd &&end) {
-    return trie_find<fields, get_type::name>(
+    return Finder::template find<fields, get_type::name>(
       static_cast<TBegin &&>(begin), static_cast<TEnd &&>(end), parser(), out
     );
   }
@@ -427,9 +915,243 @@ public:
    *
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
-  template <typename TString>
+  template <typename Finder = finder, typename TString>
   static constexpr bool try_parse(type &out, TString const &s) {
-    return try_parse(out, std::begin(s), std::end(s));
+    return try_parse<Finder>(out, std::begin(s), std::end(s));
+  }
+
+  /**
+   * Parses each string in the range `[begin, end)`, like a column of values
+   * read from a file, into the array starting at `out`.
+   *
+   * For each string, `parsed` receives whether it was successfully parsed.
+   * The corresponding element of `out` is left untouched when it wasn't.
+   * Returns the number of strings successfully parsed.
+   *
+   * Strings can be of any type accepted by `try_parse()`, like
+   * `string_view` or `std::string`.
+   *
+   * Names are looked up in a hash table built once, at compile time, for the
+   * whole enum: most strings cost a single probe and comparison instead of
+   * a walk down `Finder`. Strings that aren't a field's exact name are then
+   * given to `Finder`, so that finders accepting more than the exact names
+   * still parse them.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, field1, field2);
+   *
+   *  std::vector<string_view> column{"field2", "yolo", "field0"};
+   *  my_enum out[3];
+   *  bool parsed[3];
+   *
+   *  // returns `2`, sets `out[0]` to `my_enum::field2`, `out[2]` to
+   *  // `my_enum::field0` and `parsed` to `{true, false, true}`
+   *  auto result = enum_traits<my_enum>::parse_many(
+   *    column.begin(), column.end(), out, parsed
+   *  );
+   */
+  template <typename Finder = finder, typename Iterator>
+  static std::size_t parse_many(
+    Iterator begin,
+    Iterator end,
+    type *out,
+    bool *parsed
+  ) {
+    std::size_t count = 0;
+
+    for (; begin != end; ++begin, ++out, ++parsed) {
+      *parsed = column_table::find(std::begin(*begin), std::end(*begin), *out)
+        || try_parse<Finder>(*out, *begin);
+      count += *parsed;
+    }
+
+    return count;
+  }
+
+  /**
+   * Writes the names of the enumeration values in the range `[begin, end)`
+   * back to back into the buffer starting at `out`, each one followed by
+   * `separator`, like a column of values to be written to a file.
+   *
+   * Values that are not valid for this enum are written as `fallback`, which
+   * is empty by default. Returns a pointer past the last character written.
+   *
+   * The buffer must be large enough to hold every name and separator. Given
+   * `n` values, `n * (max_name_size::value + 1)` characters are enough as
+   * long as `fallback` is no longer than `max_name_size::value`.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, field1, field2);
+   *
+   *  my_enum const column[] = {my_enum::field2, my_enum(-1), my_enum::field0};
+   *  char buffer[3 * (enum_traits<my_enum>::max_name_size::value + 1)];
+   *
+   *  auto const last = enum_traits<my_enum>::to_string_many(
+   *    std::begin(column), std::end(column), buffer, ','
+   *  );
+   *
+   *  // yields `"field2,,field0,"`
+   *  auto result = std::string(buffer, last);
+   */
+  template <typename Iterator>
+  static char *to_string_many(
+    Iterator begin,
+    Iterator end,
+    char *out,
+    char separator,
+    string_view fallback = string_view()
+  ) {
+    for (; begin != end; ++begin) {
+      auto const index = names_table<>::find(*begin);
+      auto const name = index < size<fields>::value
+        ? names_table<>::view(index)
+        : fallback;
+
+      if (!name.empty()) {
+        std::memcpy(out, name.data(), name.size());
+        out += name.size();
+      }
+
+      *out++ = separator;
+    }
+
+    return out;
+  }
+
+  /**
+   * Returns the name of the given enumeration value as a `string_view` into
+   * `names_blob()`, or `fallback` when the given value is not supported.
+   *
+   * Unlike `to_string()`, the size of the name is known without scanning it.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, field1, field2);
+   *
+   *  // yields `string_view("field0")`
+   *  auto result1 = enum_traits<my_enum>::names_view(my_enum::field0);
+   *
+   *  // yields an empty `string_view`
+   *  auto result2 = enum_traits<my_enum>::names_view(my_enum(-1));
+   */
+  static string_view names_view(
+    type e,
+    string_view fallback = string_view()
+  ) {
+    auto const index = names_table<>::find(e);
+    return index < size<fields>::value ? names_table<>::view(index) : fallback;
+  }
+
+  /**
+   * Appends the name of the given enumeration value to `out`, or `fallback`
+   * when the given value is not supported. The size of the name is known
+   * up front, so no `strlen()` is involved.
+   *
+   * `out` can be any string offering `append(char const *, std::size_t)`,
+   * like `std::string` or `rope`. Since names are statically allocated, a
+   * `rope` references them rather than copying them.
+   *
+   * Returns `out`.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, field1, field2);
+   *
+   *  std::string out("value=");
+   *
+   *  // `out` becomes `"value=field1"`
+   *  enum_traits<my_enum>::append_to(out, my_enum::field1);
+   */
+  template <typename String>
+  static String &append_to(
+    String &out,
+    type e,
+    string_view fallback = string_view()
+  ) {
+    auto const name = names_view(e, fallback);
+    out.append(name.data(), name.size());
+    return out;
+  }
+
+  /**
+   * Writes the name of the given enumeration value to the buffer starting at
+   * `out`, or `fallback` when the given value is not supported, returning a
+   * pointer past the last character of the name. No null terminator is
+   * written.
+   *
+   * Names are written with a single copy of `max_name_size::value`
+   * characters, regardless of their actual size, so the buffer must have
+   * room for at least that many characters, or for `fallback` if it's
+   * longer. Characters past the returned pointer are left unspecified.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, field1, field2);
+   *
+   *  char buffer[enum_traits<my_enum>::max_name_size::value];
+   *  auto const last = enum_traits<my_enum>::append_to(
+   *    buffer, my_enum::field2
+   *  );
+   *
+   *  // yields `"field2"`
+   *  auto result = std::string(buffer, last);
+   */
+  static char *append_to(
+    char *out,
+    type e,
+    string_view fallback = string_view()
+  ) {
+    auto const index = names_table<>::find(e);
+
+    if (index < size<fields>::value) {
+      return names_table<>::copy(index, out);
+    }
+
+    if (!fallback.empty()) {
+      std::memcpy(out, fallback.data(), fallback.size());
+    }
+
+    return out + fallback.size();
+  }
+
+  /**
+   * A statically allocated array holding the names of every enumeration
+   * field back to back, sorted by the fields' values, each one followed by a
+   * null terminator.
+   *
+   * The name of the `i`-th field, in the order of their values, starts at
+   * `names_blob().data() + names_offsets()[i]`.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, (field1, 10), (field2, 5));
+   *
+   *  // yields a view of `"field0\0field2\0field1\0"`
+   *  auto result = enum_traits<my_enum>::names_blob();
+   */
+  static string_view names_blob() {
+    return string_view(
+      names_table<>::names.data,
+      names_table<>::names.offset[size<fields>::value]
+    );
+  }
+
+  /**
+   * The offset of each field's name in `names_blob()`, sorted by the fields'
+   * values, followed by the size of `names_blob()`. The array holds one more
+   * element than there are fields.
+   *
+   * Example:
+   *
+   *  FATAL_RICH_ENUM_CLASS(my_enum, field0, (field1, 10), (field2, 5));
+   *
+   *  // yields `{0, 7, 14, 21}`
+   *  auto result = enum_traits<my_enum>::names_offsets();
+   */
+  static std::size_t const *names_offsets() {
+    return names_table<>::names.offset;
   }
 };
 
@@ -645,6 +1367,57 @@ using enum_values_array = as_array<
     FATAL_SIMPLE_MAP(FATAL_IMPL_RICH_ENUM_EXTRACT_FIELD, __VA_ARGS__) \
   )
 
+/**
+ * The same as `FATAL_RICH_ENUM`, but also chooses the lookup backend used by
+ * `enum_traits::parse` and `enum_traits::try_parse` by default, which is
+ * otherwise `trie_finder<>`.
+ *
+ * `Finder` can't contain unparenthesized commas. Use a type alias if needed.
+ * Its header must be included by the caller: `enum.h` only provides
+ * `trie_finder`.
+ *
+ * Example:
+ *
+ *  #include <fatal/type/perfect_hash.h>
+ *
+ *  FATAL_RICH_ENUM_WITH_FINDER(
+ *    my_enum, ::fatal::perfect_hash_finder, field0, field1, field2
+ *  );
+ *
+ *  // yields `my_enum::field0`, looked up through a perfect hash
+ *  auto result = enum_traits<my_enum>::parse("field0");
+ */
+#define FATAL_RICH_ENUM_WITH_FINDER(Enum, Finder, ...) \
+  FATAL_ENUM(Enum, __VA_ARGS__); \
+  \
+  FATAL_IMPL_EXPORT_RICH_ENUM_WITH_FINDER_CALL( \
+    Enum, \
+    Finder \
+    FATAL_SIMPLE_MAP(FATAL_IMPL_RICH_ENUM_EXTRACT_FIELD, __VA_ARGS__) \
+  )
+
+/**
+ * The same as `FATAL_RICH_ENUM_WITH_FINDER`, but declares
+ * an `enum class` instead of an `enum`.
+ *
+ * Example:
+ *
+ *  FATAL_RICH_ENUM_CLASS_WITH_FINDER(
+ *    my_enum, ::fatal::perfect_hash_finder, field0, field1, field2
+ *  );
+ *
+ *  // yields `my_enum::field0`, looked up through a perfect hash
+ *  auto result = enum_traits<my_enum>::parse("field0");
+ */
+#define FATAL_RICH_ENUM_CLASS_WITH_FINDER(Enum, Finder, ...) \
+  FATAL_ENUM_CLASS(Enum, __VA_ARGS__); \
+  \
+  FATAL_IMPL_EXPORT_RICH_ENUM_WITH_FINDER_CALL( \
+    Enum, \
+    Finder \
+    FATAL_SIMPLE_MAP(FATAL_IMPL_RICH_ENUM_EXTRACT_FIELD, __VA_ARGS__) \
+  )
+
 /**
  * Adds `enum_traits` support for an existing enum `Enum` to `enum_traits`.
  *
@@ -668,6 +1441,30 @@ using enum_values_array = as_array<
     FATAL_UID(TBegin), \
     FATAL_UID(TEnd), \
     Enum, \
+    ::fatal::trie_finder<>, \
+    __VA_ARGS__ \
+  )
+
+/**
+ * The same as `FATAL_EXPORT_RICH_ENUM`, but also chooses the lookup backend
+ * used by `enum_traits::parse` by default. See `FATAL_RICH_ENUM_WITH_FINDER`.
+ *
+ * Example:
+ *
+ *  enum class my_enum { field0, field1 = 37, field2 };
+ *
+ *  FATAL_EXPORT_RICH_ENUM_WITH_FINDER(
+ *    my_enum, ::fatal::perfect_hash_finder, field0, field1, field2
+ *  );
+ */
+#define FATAL_EXPORT_RICH_ENUM_WITH_FINDER(Enum, Finder, ...) \
+  FATAL_IMPL_EXPORT_RICH_ENUM( \
+    FATAL_UID(FATAL_CAT(enum_metadata_impl_, Enum)), \
+    FATAL_UID(TString), \
+    FATAL_UID(TBegin), \
+    FATAL_UID(TEnd), \
+    Enum, \
+    Finder, \
     __VA_ARGS__ \
   )
 
@@ -706,6 +1503,10 @@ using enum_values_array = as_array<
  *
  *    using fields = list<member::field0, member::field1, member::field2>;
  *
+ *    // this alias is optional: it's the lookup backend `enum_traits::parse`
+ *    // uses by default, which is `trie_finder<>` when absent
+ *    using finder = perfect_hash_finder;
+ *
  *    // this function is optional but its presence greatly
  *    // improves build times and runtime performance
  *    static char const *to_string(type e, char const *fallback) {
@@ -753,6 +1554,9 @@ using enum_values_array = as_array<
 #define FATAL_IMPL_EXPORT_RICH_ENUM_CALL(...) \
   FATAL_EXPORT_RICH_ENUM(__VA_ARGS__)
 
+#define FATAL_IMPL_EXPORT_RICH_ENUM_WITH_FINDER_CALL(...) \
+  FATAL_EXPORT_RICH_ENUM_WITH_FINDER(__VA_ARGS__)
+
 #define FATAL_IMPL_EXPORT_RICH_ENUM_MEMBER(...) \
   FATAL_CONDITIONAL(IsFirst)()(,) struct __VA_ARGS__ { \
     FATAL_S(name, FATAL_TO_STR(__VA_ARGS__)); \
@@ -767,10 +1571,11 @@ using enum_values_array = as_array<
   case type::__VA_ARGS__: return FATAL_TO_STR(__VA_ARGS__);
 
 #define FATAL_IMPL_EXPORT_RICH_ENUM( \
-  ClassName, TString, TBegin, TEnd, Enum, ... \
+  ClassName, TString, TBegin, TEnd, Enum, Finder, ... \
 ) \
   struct ClassName { \
     using type = Enum; \
+    using finder = Finder; \
     \
     FATAL_S(name, FATAL_TO_STR(Enum)); \
     \
@@ -0,0 +1,304 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/portability.h>
+#include <fatal/type/array.h>
+#include <fatal/type/sequence.h>
+#include <fatal/type/size.h>
+#include <fatal/type/slice.h>
+#include <fatal/type/tag.h>
+
+#include <limits>
+#include <type_traits>
+
+#include <cstdint>
+
+namespace fatal {
+namespace i_ac {
+
+// smallest unsigned type able to represent `Value` //
+template <std::size_t Value>
+using u = typename std::conditional<
+  Value <= std::numeric_limits<std::uint8_t>::max(),
+  std::uint8_t,
+  typename std::conditional<
+    Value <= std::numeric_limits<std::uint16_t>::max(),
+    std::uint16_t,
+    std::uint32_t
+  >::type
+>::type;
+
+// total size of the strings //
+template <std::size_t Keys>
+static constexpr std::size_t S(std::size_t const (&size)[Keys]) {
+  std::size_t total = 0;
+
+  for (std::size_t i = 0; i < Keys; ++i) {
+    total += size[i];
+  }
+
+  return total;
+}
+
+// whether none of the strings is empty //
+template <std::size_t Keys>
+static constexpr bool E(std::size_t const (&size)[Keys]) {
+  for (std::size_t i = 0; i < Keys; ++i) {
+    if (!size[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// number of alphabet classes: one per distinct character in the strings,
+// plus one for every other character //
+template <std::size_t Keys>
+static constexpr std::size_t C(
+  char const *const (&data)[Keys],
+  std::size_t const (&size)[Keys]
+) {
+  bool seen[1 << 8] = {};
+  std::size_t classes = 1;
+
+  for (std::size_t i = 0; i < Keys; ++i) {
+    for (std::size_t j = 0; j < size[i]; ++j) {
+      auto const character = static_cast<unsigned char>(data[i][j]);
+
+      if (!seen[character]) {
+        seen[character] = true;
+        ++classes;
+      }
+    }
+  }
+
+  return classes;
+}
+
+// base 2 logarithm of the smallest power of two not less than `value` //
+static constexpr std::size_t L(std::size_t value, std::size_t result = 0) {
+  return (std::size_t(1) << result) < value ? L(value, result + 1) : result;
+}
+
+// automaton: `Classes` is a power of two so that the transition table can
+// be indexed with a shift rather than a multiplication //
+template <std::size_t States, std::size_t Classes>
+struct t {
+  using state = u<States>;
+
+  // character -> alphabet class //
+  u<Classes> alphabet[1 << 8];
+  // state x class -> state, already following the failure links //
+  state delta[States * Classes];
+  // state -> 1 + index of the string ending at it, or 0 //
+  std::size_t match[States];
+  // state -> the closest state along the failure links with a match, or 0 //
+  state dictionary[States];
+  // state -> the first state to report matches from: the state itself if a
+  // string ends at it, otherwise the dictionary link //
+  state report[States];
+};
+
+// automaton construction: the strings are inserted in a trie, then the
+// failure links are computed breadth first, filling in the missing
+// transitions of each state with those of its failure state //
+template <std::size_t States, std::size_t Classes, std::size_t Keys>
+static constexpr t<States, Classes> c(
+  char const *const (&data)[Keys],
+  std::size_t const (&size)[Keys]
+) {
+  using state = typename t<States, Classes>::state;
+
+  t<States, Classes> result{};
+  state failure[States] = {};
+  state queue[States] = {};
+
+  std::size_t classes = 1;
+  for (std::size_t i = 0; i < Keys; ++i) {
+    for (std::size_t j = 0; j < size[i]; ++j) {
+      auto const character = static_cast<unsigned char>(data[i][j]);
+
+      if (!result.alphabet[character]) {
+        result.alphabet[character] = static_cast<u<Classes>>(classes++);
+      }
+    }
+  }
+
+  std::size_t states = 1;
+  for (std::size_t i = 0; i < Keys; ++i) {
+    std::size_t s = 0;
+
+    for (std::size_t j = 0; j < size[i]; ++j) {
+      auto &next = result.delta[
+        s * Classes + result.alphabet[static_cast<unsigned char>(data[i][j])]
+      ];
+
+      if (!next) {
+        next = static_cast<state>(states++);
+      }
+
+      s = next;
+    }
+
+    result.match[s] = i + 1;
+  }
+
+  std::size_t head = 0;
+  std::size_t tail = 0;
+
+  for (std::size_t i = 1; i < Classes; ++i) {
+    if (result.delta[i]) {
+      queue[tail++] = result.delta[i];
+    }
+  }
+
+  while (head != tail) {
+    auto const s = queue[head++];
+    auto const f = failure[s];
+
+    result.dictionary[s] = result.match[f] ? f : result.dictionary[f];
+
+    for (std::size_t i = 1; i < Classes; ++i) {
+      auto &next = result.delta[s * Classes + i];
+
+      if (next) {
+        failure[next] = result.delta[f * Classes + i];
+        queue[tail++] = next;
+      } else {
+        next = result.delta[f * Classes + i];
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < States; ++i) {
+    result.report[i] = result.match[i]
+      ? static_cast<state>(i)
+      : result.dictionary[i];
+  }
+
+  return result;
+}
+
+// scanner implementation //
+template <
+  typename T,
+  typename Filter,
+  typename = make_index_sequence<size<T>::value>
+>
+struct s;
+
+// no strings //
+template <typename T, typename Filter>
+struct s<T, Filter, index_sequence<>> {
+  template <typename Begin, typename End, typename... Args>
+  static std::size_t f(Begin, End, Args &&...) { return 0; }
+};
+
+template <typename T, typename Filter, std::size_t... Index>
+struct s<T, Filter, index_sequence<Index...>> {
+  static constexpr char const *const data[sizeof...(Index)] = {
+    z_data<typename Filter::template apply<at<T, Index>>, char>()...
+  };
+
+  static constexpr std::size_t const size[sizeof...(Index)] = {
+    fatal::size<typename Filter::template apply<at<T, Index>>>::value...
+  };
+
+  static_assert(E(size), "the empty string can't be scanned for");
+
+  using states = std::integral_constant<std::size_t, 1 + S(size)>;
+
+  using shift = std::integral_constant<std::size_t, L(C(data, size))>;
+
+  using classes = std::integral_constant<
+    std::size_t,
+    std::size_t(1) << shift::value
+  >;
+
+  static constexpr t<states::value, classes::value> const table
+    = c<states::value, classes::value>(data, size);
+
+  // string index -> visitor thunk //
+  template <typename Visitor, typename... VArgs>
+  struct V {
+    using type = void (*)(Visitor &, std::size_t, VArgs &...);
+
+    template <typename Key>
+    static void v(Visitor &visitor, std::size_t offset, VArgs &...args) {
+      visitor(tag<Key>(), offset, args...);
+    }
+
+    static constexpr type const data[sizeof...(Index)] = {
+      &v<at<T, Index>>...
+    };
+  };
+
+  template <typename Begin, typename End, typename Visitor, typename... VArgs>
+  static std::size_t f(
+    Begin begin,
+    End const end,
+    Visitor &visitor,
+    VArgs &...args
+  ) {
+    std::size_t state = 0;
+    std::size_t offset = 0;
+    std::size_t matches = 0;
+
+    for (; begin != end; ++begin) {
+      ++offset;
+      state = table.delta[
+        (state << shift::value)
+          | table.alphabet[static_cast<unsigned char>(*begin)]
+      ];
+
+      for (
+        std::size_t match = table.report[state];
+        match;
+        match = table.dictionary[match]
+      ) {
+        auto const key = table.match[match] - 1;
+        V<Visitor, VArgs...>::data[key](visitor, offset - size[key], args...);
+        ++matches;
+      }
+    }
+
+    return matches;
+  }
+};
+
+#if FATAL_CPLUSPLUS < 201703L
+template <typename T, typename Filter, std::size_t... Index>
+constexpr char const *const s<
+  T, Filter, index_sequence<Index...>
+>::data[sizeof...(Index)];
+
+template <typename T, typename Filter, std::size_t... Index>
+constexpr std::size_t const s<
+  T, Filter, index_sequence<Index...>
+>::size[sizeof...(Index)];
+
+template <typename T, typename Filter, std::size_t... Index>
+constexpr t<
+  s<T, Filter, index_sequence<Index...>>::states::value,
+  s<T, Filter, index_sequence<Index...>>::classes::value
+> const s<T, Filter, index_sequence<Index...>>::table;
+
+template <typename T, typename Filter, std::size_t... Index>
+template <typename Visitor, typename... VArgs>
+constexpr typename s<T, Filter, index_sequence<Index...>>::template V<
+  Visitor, VArgs...
+>::type const s<T, Filter, index_sequence<Index...>>::V<
+  Visitor, VArgs...
+>::data[sizeof...(Index)];
+#endif
+
+} // namespace i_ac {
+} // namespace fatal {
@@ -0,0 +1,355 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/type/array.h>
+#include <fatal/type/sequence.h>
+#include <fatal/type/size.h>
+#include <fatal/type/slice.h>
+#include <fatal/type/tag.h>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <cstdint>
+#include <cstring>
+
+namespace fatal {
+namespace i_ph {
+
+// mixing constants //
+using k0 = std::integral_constant<std::uint64_t, 0x9e3779b97f4a7c15ull>;
+using k1 = std::integral_constant<std::uint64_t, 0xff51afd7ed558ccdull>;
+using k2 = std::integral_constant<std::uint64_t, 0xc4ceb9fe1a85ec53ull>;
+
+// avalanche //
+static constexpr inline std::uint64_t m(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= k1::value;
+  x ^= x >> 33;
+  x *= k2::value;
+  return x ^ (x >> 33);
+}
+
+// little endian word out of up to 8 characters //
+template <typename Iterator>
+static constexpr inline std::uint64_t w(Iterator &i, std::size_t size) {
+  std::uint64_t word = 0;
+
+  for (std::size_t j = 0; j < size; ++j, ++i) {
+    word |= static_cast<std::uint64_t>(
+      static_cast<unsigned char>(static_cast<char>(*i))
+    ) << (j * 8);
+  }
+
+  return word;
+}
+
+// string hash, evaluated both at compile time and at runtime //
+template <typename Iterator>
+static constexpr inline std::uint64_t h(Iterator i, std::size_t size) {
+  std::uint64_t hash = k0::value ^ size;
+
+  for (; size >= 8; size -= 8) {
+    hash = (hash ^ w(i, 8)) * k1::value;
+    hash ^= hash >> 29;
+  }
+
+  if (size) {
+    hash = (hash ^ w(i, size)) * k1::value;
+  }
+
+  return m(hash);
+}
+
+// runtime string hash for contiguous bytes, yields the same result as `h` //
+template <typename Iterator>
+static inline std::uint64_t H(Iterator i, std::size_t size) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::uint64_t hash = k0::value ^ size;
+
+  for (; size >= 8; size -= 8, i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, i, 8);
+    hash = (hash ^ word) * k1::value;
+    hash ^= hash >> 29;
+  }
+
+  if (size) {
+    hash = (hash ^ w(i, size)) * k1::value;
+  }
+
+  return m(hash);
+#else
+  return h(i, size);
+#endif
+}
+
+// hashes the needle, picking the fastest way available for its type //
+template <typename Iterator>
+static inline std::uint64_t r(
+  std::true_type,
+  Iterator begin,
+  std::size_t size
+) {
+  return H(begin, size);
+}
+
+template <typename Iterator>
+static inline std::uint64_t r(
+  std::false_type,
+  Iterator begin,
+  std::size_t size
+) {
+  return h(begin, size);
+}
+
+template <typename Iterator>
+using R = std::integral_constant<
+  bool,
+  std::is_pointer<Iterator>::value
+    && std::is_integral<
+      typename std::iterator_traits<Iterator>::value_type
+    >::value
+    && sizeof(typename std::iterator_traits<Iterator>::value_type) == 1
+>;
+
+// bucket of a hash //
+static constexpr inline std::size_t b(
+  std::uint64_t hash,
+  std::size_t buckets
+) {
+  return static_cast<std::size_t>(hash >> 32) % buckets;
+}
+
+// slot of a hash, given its bucket's pilot //
+static constexpr inline std::size_t s(
+  std::uint64_t hash,
+  std::uint64_t pilot,
+  std::size_t slots
+) {
+  auto x = (hash ^ pilot) * k2::value;
+  return static_cast<std::size_t>(x ^ (x >> 32)) % slots;
+}
+
+// maximum number of pilots tried per bucket //
+using attempts = std::integral_constant<std::uint64_t, 1u << 16>;
+
+// minimal perfect hash table //
+template <std::size_t Size, std::size_t Buckets>
+struct t {
+  // per bucket pilot //
+  std::uint64_t pilot[Buckets];
+  // slot -> key index //
+  std::size_t key[Size];
+  bool ok;
+};
+
+// minimal perfect hash table construction (hash and displace): buckets are
+// placed from the largest to the smallest, each one searching for a pilot
+// that sends all of its keys to free slots //
+template <std::size_t Size, std::size_t Buckets>
+static constexpr t<Size, Buckets> c(std::uint64_t const (&hashes)[Size]) {
+  t<Size, Buckets> result{};
+  std::size_t bucket_size[Buckets] = {};
+  std::size_t order[Buckets] = {};
+  bool taken[Size] = {};
+  std::size_t members[Size] = {};
+  std::size_t slots[Size] = {};
+
+  for (std::size_t i = 0; i < Size; ++i) {
+    ++bucket_size[b(hashes[i], Buckets)];
+  }
+
+  for (std::size_t i = 0; i < Buckets; ++i) {
+    order[i] = i;
+  }
+
+  for (std::size_t i = 1; i < Buckets; ++i) {
+    for (
+      auto j = i;
+      j && bucket_size[order[j - 1]] < bucket_size[order[j]];
+      --j
+    ) {
+      auto const swap = order[j - 1];
+      order[j - 1] = order[j];
+      order[j] = swap;
+    }
+  }
+
+  for (std::size_t i = 0; i < Buckets; ++i) {
+    auto const bucket = order[i];
+
+    if (!bucket_size[bucket]) {
+      break;
+    }
+
+    std::size_t count = 0;
+    for (std::size_t j = 0; j < Size; ++j) {
+      if (b(hashes[j], Buckets) == bucket) {
+        members[count++] = j;
+      }
+    }
+
+    bool placed = false;
+
+    for (std::uint64_t attempt = 0; !placed && attempt < attempts::value;) {
+      auto const pilot = m(++attempt);
+      placed = true;
+
+      for (std::size_t j = 0; placed && j < count; ++j) {
+        slots[j] = s(hashes[members[j]], pilot, Size);
+        placed = !taken[slots[j]];
+
+        for (std::size_t k = 0; placed && k < j; ++k) {
+          placed = slots[k] != slots[j];
+        }
+      }
+
+      if (placed) {
+        result.pilot[bucket] = pilot;
+
+        for (std::size_t j = 0; j < count; ++j) {
+          taken[slots[j]] = true;
+          result.key[slots[j]] = members[j];
+        }
+      }
+    }
+
+    if (!placed) {
+      return result;
+    }
+  }
+
+  result.ok = true;
+  return result;
+}
+
+// perfect hash lookup implementation //
+template <
+  typename T,
+  typename Filter,
+  typename = make_index_sequence<size<T>::value>
+>
+struct f;
+
+// empty set //
+template <typename T, typename Filter>
+struct f<T, Filter, index_sequence<>> {
+  template <typename... Args>
+  static constexpr inline bool F(Args &&...) { return false; }
+};
+
+template <typename T, typename Filter, std::size_t... Index>
+struct f<T, Filter, index_sequence<Index...>> {
+  using slots = std::integral_constant<std::size_t, sizeof...(Index)>;
+  using buckets = std::integral_constant<std::size_t, slots::value / 2 + 1>;
+
+  static constexpr std::uint64_t const hashes[slots::value] = {
+    h(
+      z_data<typename Filter::template apply<at<T, Index>>, char>(),
+      size<typename Filter::template apply<at<T, Index>>>::value
+    )...
+  };
+
+  static constexpr t<slots::value, buckets::value> const table
+    = c<slots::value, buckets::value>(hashes);
+
+  static_assert(
+    table.ok,
+    "unable to build a perfect hash - duplicate strings in the input?"
+  );
+
+  // matches the needle against a single key //
+  template <
+    typename Key,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  static bool k(
+    std::size_t const size,
+    NeedleBegin const &begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
+    using haystack = typename Filter::template apply<Key>;
+    using length = fatal::size<haystack>;
+    using value_type = typename std::iterator_traits<NeedleBegin>::value_type;
+
+    auto const key = z_data<haystack, value_type>();
+
+    if (size != length::value || !std::equal(key, key + length::value, begin)) {
+      return false;
+    }
+
+    visitor(tag<Key>(), static_cast<VArgs &&>(args)...);
+    return true;
+  }
+
+  // slot -> key matcher //
+  template <typename NeedleBegin, typename Visitor, typename... VArgs>
+  struct K {
+    using type = bool (*)(
+      std::size_t, NeedleBegin const &, Visitor &&, VArgs &&...
+    );
+
+    static constexpr type const data[slots::value] = {
+      &k<at<T, table.key[Index]>, NeedleBegin, Visitor, VArgs...>...
+    };
+  };
+
+  template <typename NeedleBegin, typename Visitor, typename... VArgs>
+  static inline bool F(
+    std::size_t const size,
+    NeedleBegin const &begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
+    auto const hash = r(R<NeedleBegin>(), begin, size);
+    auto const slot = s(
+      hash,
+      table.pilot[b(hash, buckets::value)],
+      slots::value
+    );
+
+    return K<NeedleBegin, Visitor, VArgs...>::data[slot](
+      size,
+      begin,
+      static_cast<Visitor &&>(visitor),
+      static_cast<VArgs &&>(args)...
+    );
+  }
+};
+
+#if FATAL_CPLUSPLUS < 201703L
+template <typename T, typename Filter, std::size_t... Index>
+constexpr std::uint64_t const f<
+  T, Filter, index_sequence<Index...>
+>::hashes[slots::value];
+
+template <typename T, typename Filter, std::size_t... Index>
+constexpr t<
+  f<T, Filter, index_sequence<Index...>>::slots::value,
+  f<T, Filter, index_sequence<Index...>>::buckets::value
+> const f<T, Filter, index_sequence<Index...>>::table;
+
+template <typename T, typename Filter, std::size_t... Index>
+template <typename NeedleBegin, typename Visitor, typename... VArgs>
+constexpr typename f<T, Filter, index_sequence<Index...>>::template K<
+  NeedleBegin, Visitor, VArgs...
+>::type const f<T, Filter, index_sequence<Index...>>::K<
+  NeedleBegin, Visitor, VArgs...
+>::data[slots::value];
+#endif
+
+} // namespace i_ph {
+} // namespace fatal {
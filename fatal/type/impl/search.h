@@ -8,10 +8,21 @@
  */
 #pragma once
 
+#include <fatal/portability.h>
+#include <fatal/type/compare.h>
+#include <fatal/type/sequence.h>
 #include <fatal/type/size.h>
 #include <fatal/type/slice.h>
 #include <fatal/type/tag.h>
 
+#include <type_traits>
+
+#include <cstdint>
+
+#if __SSE2__
+# include <emmintrin.h>
+#endif
+
 namespace fatal {
 namespace i_S {
 
@@ -130,5 +141,623 @@ struct s<Offset, 2> {
   }
 };
 
+// Eytzinger (breadth first) layout of a sorted list of `Size` elements:
+// `index[slot]` is the position in the sorted list of the element at `slot`.
+// Slots start at 1, so that the children of `slot` are `2 * slot` and
+// `2 * slot + 1` //
+template <std::size_t Size>
+struct y {
+  std::size_t index[Size + 1];
+};
+
+// in-order traversal of the implicit tree rooted at `slot` //
+template <std::size_t Size>
+static constexpr std::size_t Y(
+  y<Size> &layout,
+  std::size_t position,
+  std::size_t slot
+) {
+  if (slot <= Size) {
+    position = Y(layout, position, 2 * slot);
+    layout.index[slot] = position++;
+    position = Y(layout, position, 2 * slot + 1);
+  }
+
+  return position;
+}
+
+template <std::size_t Size>
+static constexpr y<Size> L() {
+  y<Size> layout{};
+  Y(layout, 0, 1);
+  return layout;
+}
+
+// branchless search over the values of the sorted list `T`, laid out in
+// Eytzinger order so that each step of the search only depends on the
+// outcome of a single comparison, and so that the next few levels of the
+// tree share a cache line that can be prefetched ahead of time //
+template <
+  typename T,
+  typename Filter,
+  typename = make_index_sequence<size<T>::value + 1>
+>
+struct e;
+
+template <typename T, typename Filter, std::size_t... Slots>
+struct e<T, Filter, index_sequence<Slots...>> {
+  static constexpr y<sizeof...(Slots) - 1> const layout = L<
+    sizeof...(Slots) - 1
+  >();
+
+  using value_type = typename std::decay<
+    decltype(Filter::template apply<at<T, 0>>::value)
+  >::type;
+
+  // slot 0 is never looked at //
+  static constexpr value_type const value[sizeof...(Slots)] = {
+    Filter::template apply<at<T, layout.index[Slots]>>::value...
+  };
+
+  // how many slots ahead the descendants of a slot are prefetched //
+  using stride = std::integral_constant<
+    std::size_t, (64 / sizeof(value_type)) ? (64 / sizeof(value_type)) : 1
+  >;
+
+  // slot -> visitor thunk //
+  template <typename Visitor, typename... Args>
+  struct V {
+    using type = void (*)(Visitor &, Args &...);
+
+    template <std::size_t Index>
+    static void visit(Visitor &visitor, Args &...args) {
+      visitor(indexed<at<T, Index>, Index>(), static_cast<Args &&>(args)...);
+    }
+
+    static constexpr type const data[sizeof...(Slots)] = {
+      &visit<layout.index[Slots]>...
+    };
+  };
+
+  template <typename Needle, typename Visitor, typename... Args>
+  static inline bool S(Needle &&needle, Visitor &&visitor, Args &&...args) {
+    auto const key = static_cast<value_type>(needle);
+
+    // the last slot whose value isn't less than the needle //
+    std::size_t found = 0;
+
+    for (std::size_t slot = 1; slot < sizeof...(Slots); ) {
+      auto const ahead = slot * stride::value;
+      FATAL_PREFETCH(value + (ahead < sizeof...(Slots) ? ahead : 0));
+
+      auto const right = value[slot] < key;
+      found = right ? found : slot;
+      slot = 2 * slot + right;
+    }
+
+    if (!found || value[found] != key) {
+      return false;
+    }
+
+    V<Visitor, Args...>::data[found](visitor, args...);
+    return true;
+  }
+};
+
+// empty list //
+template <typename T, typename Filter>
+struct e<T, Filter, index_sequence<0>> {
+  template <typename... Args>
+  static inline bool S(Args &&...) {
+    return false;
+  }
+};
+
+#if FATAL_CPLUSPLUS < 201703L
+template <typename T, typename Filter, std::size_t... Slots>
+constexpr y<sizeof...(Slots) - 1> const e<
+  T, Filter, index_sequence<Slots...>
+>::layout;
+
+template <typename T, typename Filter, std::size_t... Slots>
+constexpr typename e<T, Filter, index_sequence<Slots...>>::value_type const e<
+  T, Filter, index_sequence<Slots...>
+>::value[sizeof...(Slots)];
+
+template <typename T, typename Filter, std::size_t... Slots>
+template <typename Visitor, typename... Args>
+constexpr typename e<T, Filter, index_sequence<Slots...>>::template V<
+  Visitor, Args...
+>::type const e<T, Filter, index_sequence<Slots...>>::V<
+  Visitor, Args...
+>::data[sizeof...(Slots)];
+#endif
+
+// jump table over the slots `[0, sizeof...(Positions))`: each slot holds 1 +
+// the position in `T` of the element matching it, or 0 if none does //
+template <typename T, typename Positions> struct J;
+
+template <typename T, std::size_t... Positions>
+struct J<T, index_sequence<Positions...>> {
+  // slot -> visitor thunk //
+  template <typename Visitor, typename... Args>
+  struct V {
+    using type = bool (*)(Visitor &, Args &...);
+
+    static bool visit(std::false_type, Visitor &, Args &...) {
+      return false;
+    }
+
+    template <std::size_t Position>
+    static bool visit(
+      std::integral_constant<std::size_t, Position>,
+      Visitor &visitor,
+      Args &...args
+    ) {
+      visitor(
+        indexed<at<T, Position - 1>, Position - 1>(),
+        static_cast<Args &&>(args)...
+      );
+      return true;
+    }
+
+    template <std::size_t Position>
+    static bool thunk(Visitor &visitor, Args &...args) {
+      return visit(
+        typename std::conditional<
+          Position != 0,
+          std::integral_constant<std::size_t, Position>,
+          std::false_type
+        >::type(),
+        visitor,
+        args...
+      );
+    }
+
+    static constexpr type const data[sizeof...(Positions)] = {
+      &thunk<Positions>...
+    };
+  };
+
+  template <typename Visitor, typename... Args>
+  static inline bool S(
+    std::uintmax_t const slot,
+    Visitor &&visitor,
+    Args &&...args
+  ) {
+    return slot < sizeof...(Positions)
+      && V<Visitor, Args...>::data[slot](visitor, args...);
+  }
+};
+
+// slot -> 1 + position of the element of the sorted list `T` matching it //
+template <std::size_t Size>
+struct k {
+  std::size_t slot[Size];
+};
+
+template <std::size_t Size, typename... Values>
+static constexpr k<Size> K(std::uintmax_t min, Values... values) {
+  std::uintmax_t const offset[] = {
+    static_cast<std::uintmax_t>(values) - min...
+  };
+
+  k<Size> result{};
+
+  // the first one wins on duplicates //
+  for (std::size_t i = sizeof...(Values); i--; ) {
+    result.slot[offset[i]] = i + 1;
+  }
+
+  return result;
+}
+
+// dense search over the integral or enum values of the sorted list `T`: the
+// needle's offset from the smallest value indexes a jump table //
+template <typename, typename, typename = void> struct D;
+
+template <typename T, typename Filter>
+struct D<T, Filter, void>:
+  D<T, Filter, make_index_sequence<size<T>::value>>
+{};
+
+template <typename T, typename Filter, std::size_t... Indexes>
+struct D<T, Filter, index_sequence<Indexes...>> {
+  using value_type = typename std::decay<
+    decltype(Filter::template apply<at<T, 0>>::value)
+  >::type;
+
+  using min = std::integral_constant<
+    std::uintmax_t,
+    static_cast<std::uintmax_t>(Filter::template apply<at<T, 0>>::value)
+  >;
+
+  using range = std::integral_constant<
+    std::uintmax_t,
+    static_cast<std::uintmax_t>(
+      Filter::template apply<at<T, sizeof...(Indexes) - 1>>::value
+    ) - min::value + 1
+  >;
+
+  template <typename Slots>
+  struct table;
+
+  template <std::size_t... Slots>
+  struct table<index_sequence<Slots...>> {
+    static constexpr k<sizeof...(Slots)> positions = K<sizeof...(Slots)>(
+      min::value,
+      Filter::template apply<at<T, Indexes>>::value...
+    );
+
+    using type = J<T, index_sequence<positions.slot[Slots]...>>;
+  };
+
+  template <typename Needle, typename Visitor, typename... Args>
+  static inline bool S(Needle &&needle, Visitor &&visitor, Args &&...args) {
+    return table<make_index_sequence<range::value>>::type::S(
+      static_cast<std::uintmax_t>(static_cast<value_type>(needle))
+        - min::value,
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
+#if FATAL_CPLUSPLUS < 201703L
+template <typename T, std::size_t... Positions>
+template <typename Visitor, typename... Args>
+constexpr typename J<T, index_sequence<Positions...>>::template V<
+  Visitor, Args...
+>::type const J<T, index_sequence<Positions...>>::V<
+  Visitor, Args...
+>::data[sizeof...(Positions)];
+
+template <typename T, typename Filter, std::size_t... Indexes>
+template <std::size_t... Slots>
+constexpr k<sizeof...(Slots)> D<
+  T, Filter, index_sequence<Indexes...>
+>::table<index_sequence<Slots...>>::positions;
+#endif
+
+// unsigned integer of the given size //
+template <std::size_t> struct w;
+template <> struct w<1> { using type = std::uint8_t; };
+template <> struct w<2> { using type = std::uint16_t; };
+template <> struct w<4> { using type = std::uint32_t; };
+template <> struct w<8> { using type = std::uint64_t; };
+
+#if __SSE2__
+// compares 16 bytes worth of values of the given size against the needle,
+// giving a mask with one bit set per matching byte //
+template <std::size_t> struct M;
+
+template <>
+struct M<1> {
+  static __m128i set(std::uint8_t key) {
+    return _mm_set1_epi8(static_cast<char>(key));
+  }
+
+  static __m128i equal(__m128i lhs, __m128i rhs) {
+    return _mm_cmpeq_epi8(lhs, rhs);
+  }
+};
+
+template <>
+struct M<2> {
+  static __m128i set(std::uint16_t key) {
+    return _mm_set1_epi16(static_cast<short>(key));
+  }
+
+  static __m128i equal(__m128i lhs, __m128i rhs) {
+    return _mm_cmpeq_epi16(lhs, rhs);
+  }
+};
+
+template <>
+struct M<4> {
+  static __m128i set(std::uint32_t key) {
+    return _mm_set1_epi32(static_cast<int>(key));
+  }
+
+  static __m128i equal(__m128i lhs, __m128i rhs) {
+    return _mm_cmpeq_epi32(lhs, rhs);
+  }
+};
+
+// SSE2 has no 64 bits compare: both 32 bits halves must match //
+template <>
+struct M<8> {
+  static __m128i set(std::uint64_t key) {
+    return _mm_set1_epi64x(static_cast<long long>(key));
+  }
+
+  static __m128i equal(__m128i lhs, __m128i rhs) {
+    auto const half = _mm_cmpeq_epi32(lhs, rhs);
+    return _mm_and_si128(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+};
+#endif // __SSE2__
+
+// linear scan over the integral or enum values of the sorted list `T`, which
+// must fit a cache line: the needle is compared against every value at once,
+// 16 bytes at a time when SSE2 is available, and the first match gives the
+// slot of a jump table //
+template <
+  typename T,
+  typename Filter,
+  typename = typename std::decay<
+    decltype(Filter::template apply<at<T, 0>>::value)
+  >::type,
+  typename = void
+>
+struct c;
+
+template <typename T, typename Filter, typename Value>
+struct c<T, Filter, Value, void>:
+  c<
+    T,
+    Filter,
+    Value,
+    make_index_sequence<(size<T>::value * sizeof(Value) + 15) / 16>
+  >
+{};
+
+template <typename T, typename Filter, typename Value, std::size_t... Chunks>
+struct c<T, Filter, Value, index_sequence<Chunks...>> {
+  static_assert(sizeof...(Chunks) <= 4, "values must fit a cache line");
+
+  using word = typename w<sizeof(Value)>::type;
+  using lanes = std::integral_constant<std::size_t, 16 / sizeof(word)>;
+
+  template <typename> struct data;
+
+  // padded to whole chunks with copies of the first value, which can't
+  // shadow a match since the first match is the one that counts //
+  template <std::size_t... Slots>
+  struct data<index_sequence<Slots...>> {
+    alignas(16) static constexpr word const value[sizeof...(Slots)] = {
+      static_cast<word>(
+        Filter::template apply<
+          at<T, (Slots < size<T>::value ? Slots : 0)>
+        >::value
+      )...
+    };
+  };
+
+  using values = data<make_index_sequence<sizeof...(Chunks) * lanes::value>>;
+
+  using positions = J<T, make_interval<std::size_t, 1, size<T>::value + 1>>;
+
+  template <typename Needle, typename Visitor, typename... Args>
+  static inline bool S(Needle &&needle, Visitor &&visitor, Args &&...args) {
+    auto const key = static_cast<word>(static_cast<Value>(needle));
+
+#if __SSE2__
+    // one bit per matching byte, with no branch until all chunks are done //
+    auto const pattern = M<sizeof(word)>::set(key);
+    std::uint64_t mask = 0;
+
+    using expand = int[];
+    (void) expand{0, (
+      mask |= static_cast<std::uint64_t>(
+        static_cast<unsigned>(
+          _mm_movemask_epi8(
+            M<sizeof(word)>::equal(
+              _mm_load_si128(
+                reinterpret_cast<__m128i const *>(
+                  values::value + Chunks * lanes::value
+                )
+              ),
+              pattern
+            )
+          )
+        )
+      ) << (Chunks * 16),
+      0
+    )...};
+
+    return mask && positions::S(
+      static_cast<std::size_t>(__builtin_ctzll(mask)) / sizeof(word),
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+#else
+    for (std::size_t i = 0; i < size<T>::value; ++i) {
+      if (values::value[i] == key) {
+        return positions::S(
+          i,
+          static_cast<Visitor &&>(visitor),
+          static_cast<Args &&>(args)...
+        );
+      }
+    }
+
+    return false;
+#endif // __SSE2__
+  }
+};
+
+#if FATAL_CPLUSPLUS < 201703L
+template <typename T, typename Filter, typename Value, std::size_t... Chunks>
+template <std::size_t... Slots>
+alignas(16) constexpr typename c<
+  T, Filter, Value, index_sequence<Chunks...>
+>::word const c<T, Filter, Value, index_sequence<Chunks...>>::data<
+  index_sequence<Slots...>
+>::value[sizeof...(Slots)];
+#endif
+
+// `scalar_search` and `index_search` backends //
+enum class B { nested, linear, eytzinger, dense };
+
+// picks the backend `scalar_search` looks up the sorted list `T` with: only
+// lists of integral or enum values compared with `value_comparer` can do
+// better than nested comparisons //
+template <
+  typename T,
+  typename Filter,
+  typename Comparer,
+  typename Policy,
+  bool = std::is_same<Comparer, value_comparer>::value && size<T>::value
+>
+struct u {
+  static constexpr B value = B::nested;
+};
+
+template <typename T, typename Filter, typename Policy, bool IsScalar>
+struct U {
+  static constexpr B value = B::nested;
+};
+
+template <typename T, typename Filter, typename Policy>
+struct U<T, Filter, Policy, true> {
+  static constexpr B value = Policy::density_percent::value
+      && D<T, Filter>::range::value
+      && D<T, Filter>::range::value
+        <= size<T>::value * 100 / Policy::density_percent::value
+    ? B::dense
+    : size<T>::value <= Policy::linear_size::value
+        && size<T>::value * sizeof(typename D<T, Filter>::value_type) <= 64
+      ? B::linear
+      : size<T>::value >= Policy::eytzinger_size::value
+        ? B::eytzinger
+        : B::nested;
+};
+
+template <typename T, typename Filter, typename Comparer, typename Policy>
+struct u<T, Filter, Comparer, Policy, true>:
+  U<
+    T, Filter, Policy,
+    std::is_integral<
+      typename std::decay<
+        decltype(Filter::template apply<at<T, 0>>::value)
+      >::type
+    >::value || std::is_enum<
+      typename std::decay<
+        decltype(Filter::template apply<at<T, 0>>::value)
+      >::type
+    >::value
+  >
+{};
+
+// backend dispatch //
+template <B> struct d;
+
+template <>
+struct d<B::nested> {
+  template <
+    typename T,
+    typename Comparer,
+    typename Filter,
+    typename Needle,
+    typename Visitor,
+    typename... Args
+  >
+  static constexpr inline bool S(
+    Needle &&needle,
+    Visitor &&visitor,
+    Args &&...args
+  ) {
+    return s<0, size<T>::value>::template S<T, Comparer, Filter>(
+      static_cast<Needle &&>(needle),
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
+template <>
+struct d<B::linear> {
+  template <
+    typename T,
+    typename Comparer,
+    typename Filter,
+    typename Needle,
+    typename Visitor,
+    typename... Args
+  >
+  static inline bool S(Needle &&needle, Visitor &&visitor, Args &&...args) {
+    return c<T, Filter>::S(
+      static_cast<Needle &&>(needle),
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
+template <>
+struct d<B::eytzinger> {
+  template <
+    typename T,
+    typename Comparer,
+    typename Filter,
+    typename Needle,
+    typename Visitor,
+    typename... Args
+  >
+  static inline bool S(Needle &&needle, Visitor &&visitor, Args &&...args) {
+    return e<T, Filter>::S(
+      static_cast<Needle &&>(needle),
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
+template <>
+struct d<B::dense> {
+  template <
+    typename T,
+    typename Comparer,
+    typename Filter,
+    typename Needle,
+    typename Visitor,
+    typename... Args
+  >
+  static inline bool S(Needle &&needle, Visitor &&visitor, Args &&...args) {
+    return D<T, Filter>::S(
+      static_cast<Needle &&>(needle),
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
+// `index_search` dispatch: positions are dense by definition, so the needle
+// is the slot of the jump table //
+template <bool> struct x;
+
+template <>
+struct x<false> {
+  template <typename T, typename Visitor, typename... Args>
+  static constexpr inline bool S(
+    std::size_t const needle,
+    Visitor &&visitor,
+    Args &&...args
+  ) {
+    return s<0, size<T>::value>::template S<T, value_comparer, index<T>>(
+      needle,
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
+template <>
+struct x<true> {
+  template <typename T, typename Visitor, typename... Args>
+  static inline bool S(
+    std::size_t const needle,
+    Visitor &&visitor,
+    Args &&...args
+  ) {
+    return J<T, make_interval<std::size_t, 1, size<T>::value + 1>>::S(
+      needle,
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
 } // namespace i_S {
 } // namespace fatal {
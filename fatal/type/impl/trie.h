@@ -8,13 +8,19 @@
  */
 #pragma once
 
+#include <fatal/type/arithmetic.h>
 #include <fatal/type/array.h>
+#include <fatal/type/cat.h>
 #include <fatal/type/conditional.h>
 #include <fatal/type/longest_common_prefix.h>
 #include <fatal/type/search.h>
 #include <fatal/type/select.h>
-#include <fatal/type/group_by.h>
+#include <fatal/type/list.h>
+#include <fatal/type/scalar.h>
+#include <fatal/type/sequence.h>
 #include <fatal/type/size.h>
+#include <fatal/type/slice.h>
+#include <fatal/type/sort.h>
 #include <fatal/type/tag.h>
 
 #include <algorithm>
@@ -23,6 +29,8 @@
 #include <utility>
 
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 namespace fatal {
 namespace i_t {
@@ -46,13 +54,6 @@ struct N {
   using apply = n<T, IsTerminal, Begin, End, Args...>;
 };
 
-// filtered at
-template <std::size_t Index, typename Filter>
-struct a {
-  template <typename T>
-  using apply = at<typename Filter::template apply<T>, Index>;
-};
-
 // node filter for sorted search (lookup) //
 template <std::size_t Index, typename Filter>
 struct F {
@@ -63,13 +64,194 @@ struct F {
   >;
 };
 
+// unaligned word load //
+template <typename Word, typename T>
+static inline Word w(T const *data) {
+  Word word;
+  std::memcpy(std::addressof(word), data, sizeof(Word));
+  return word;
+}
+
+// edge comparison - one character at a time //
+template <bool, std::size_t Size>
+struct q {
+  template <typename NeedleBegin, typename T>
+  static inline bool f(NeedleBegin const &needle, T const *haystack) {
+    return std::equal(needle, std::next(needle, Size), haystack);
+  }
+};
+
+// edge comparison - one word at a time, the last word overlapping the
+// previous one so that no character past the end of the edge is read //
+template <std::size_t Size>
+struct q<true, Size> {
+  using word = typename std::conditional<
+    (Size >= sizeof(std::uint64_t)), std::uint64_t, std::uint32_t
+  >::type;
+
+  static_assert(Size >= sizeof(word), "internal error");
+
+  template <typename T>
+  static inline bool f(T const *needle, T const *haystack) {
+    return !d(
+      needle,
+      haystack,
+      make_index_sequence<(Size - 1) / sizeof(word)>()
+    );
+  }
+
+private:
+  template <typename T, std::size_t... Index>
+  static inline word d(
+    T const *needle,
+    T const *haystack,
+    index_sequence<Index...>
+  ) {
+    word diff = w<word>(needle + Size - sizeof(word))
+      ^ w<word>(haystack + Size - sizeof(word));
+
+    bool const unused[] = {
+      false,
+      (
+        diff |= w<word>(needle + Index * sizeof(word))
+          ^ w<word>(haystack + Index * sizeof(word)),
+        false
+      )...
+    };
+    (void) unused;
+
+    return diff;
+  }
+};
+
+// tells whether an edge of the given size can be compared a word at a time //
+template <typename Policy, typename NeedleBegin, std::size_t Size>
+using Q = q<
+  Policy::word_compare::value
+    && std::is_pointer<NeedleBegin>::value
+    && std::is_integral<
+      typename std::remove_pointer<NeedleBegin>::type
+    >::value
+    && sizeof(typename std::remove_pointer<NeedleBegin>::type) == 1
+    && (Size >= sizeof(std::uint32_t)),
+  Size
+>;
+
+// jump table: character -> 1 + index of the sibling starting with it, or 0 //
+template <typename Slot>
+struct k {
+  Slot slot[1 << 8];
+};
+
+template <typename Slot, typename... Characters>
+static constexpr k<Slot> K(Characters... characters) {
+  unsigned char const first[] = {
+    static_cast<unsigned char>(characters)...
+  };
+
+  k<Slot> result{};
+
+  for (std::size_t i = 0; i < sizeof...(Characters); ++i) {
+    result.slot[first[i]] = static_cast<Slot>(i + 1);
+  }
+
+  return result;
+}
+
+// tells whether `Count` siblings are dispatched with a jump table on their
+// next character rather than with a binary search //
+template <
+  typename Policy,
+  typename NeedleBegin,
+  typename Character,
+  std::size_t Count
+>
+using j = std::integral_constant<
+  bool,
+  Policy::jump_table_fanout::value != 0
+    && Count >= Policy::jump_table_fanout::value
+    && std::is_integral<
+      typename std::iterator_traits<NeedleBegin>::value_type
+    >::value
+    && sizeof(typename std::iterator_traits<NeedleBegin>::value_type) == 1
+    && sizeof(typename Character::value_type) == 1
+>;
+
+// jump table dispatch over the siblings `Nodes`, recursing into `Lookup` //
+template <
+  template <std::size_t, typename...> class Lookup,
+  typename Filter,
+  std::size_t Begin,
+  typename... Nodes
+>
+struct J {
+  using slot = typename std::conditional<
+    (sizeof...(Nodes) < (1 << 8)), std::uint8_t, std::uint16_t
+  >::type;
+
+  static constexpr k<slot> const table = K<slot>(
+    F<Begin, Filter>::template apply<Nodes>::value...
+  );
+
+  // slot -> lookup thunk //
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  struct T {
+    using type = bool (*)(std::size_t, NeedleBegin &, Visitor &, VArgs &...);
+
+    static bool none(std::size_t, NeedleBegin &, Visitor &, VArgs &...) {
+      return false;
+    }
+
+    template <typename Node>
+    static bool node(
+      std::size_t const size,
+      NeedleBegin &begin,
+      Visitor &visitor,
+      VArgs &...args
+    ) {
+      return Lookup<1, Filter, Node>::template f<Policy>(
+        size - 1,
+        std::next(begin),
+        static_cast<Visitor &&>(visitor),
+        static_cast<VArgs &&>(args)...
+      );
+    }
+
+    static constexpr type const data[sizeof...(Nodes) + 1] = {
+      &none, &node<Nodes>...
+    };
+  };
+
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  static inline bool f(
+    std::size_t const size,
+    NeedleBegin &&begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
+    return T<Policy, NeedleBegin, Visitor, VArgs...>::data[
+      table.slot[static_cast<unsigned char>(*begin)]
+    ](size, begin, visitor, args...);
+  }
+};
+
 // trie lookup implementation //
 template <std::size_t, typename...> struct l;
 
 // empty subtrie //
 template <typename Filter>
 struct l<0, Filter> {
-  template <typename... Args>
+  template <typename, typename... Args>
   static constexpr inline bool f(Args &&...) { return false; }
 };
 
@@ -87,6 +269,7 @@ struct l<Offset, Filter, n<Haystack, IsTerminal, Begin, End, Children...>> {
   static_assert(Offset + Begin <= End, "internal error");
 
   template <
+    typename Policy,
     typename NeedleBegin,
     typename Visitor,
     typename... VArgs
@@ -111,21 +294,23 @@ struct l<Offset, Filter, n<Haystack, IsTerminal, Begin, End, Children...>> {
       typename std::decay<NeedleBegin>::type
     >::value_type;
 
-    auto i = std::next(begin, End - Begin - Offset);
-    if (!std::equal(
+    if (!Q<
+      Policy, typename std::decay<NeedleBegin>::type, End - Begin - Offset
+    >::f(
       begin,
-      i,
       std::next(z_data<haystack_data, value_type>(), Offset + Begin)
     )) {
       return false;
     }
 
+    auto i = std::next(begin, End - Begin - Offset);
+
     if (IsTerminal && size == End - Begin - Offset) {
       visitor(tag<Haystack>(), static_cast<VArgs &&>(args)...);
       return true;
     }
 
-    return l<0, Filter, Children...>::f(
+    return l<0, Filter, Children...>::template f<Policy>(
       size - (End - Begin - Offset),
       std::move(i),
       static_cast<Visitor &&>(visitor),
@@ -152,7 +337,12 @@ struct l<
   Node,
   Siblings...
 > {
-  template <typename NeedleBegin, typename Visitor, typename... VArgs>
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
   static inline bool f(
     std::size_t const size,
     NeedleBegin &&begin,
@@ -163,13 +353,43 @@ struct l<
       return false;
     }
 
+    return d<Policy>(
+      j<
+        Policy,
+        typename std::decay<NeedleBegin>::type,
+        typename F<Begin, Filter>::template apply<
+          n<Haystack, IsTerminal, Begin, End, Children...>
+        >,
+        sizeof...(Siblings) + 2
+      >(),
+      size,
+      static_cast<NeedleBegin &&>(begin),
+      static_cast<Visitor &&>(visitor),
+      static_cast<VArgs &&>(args)...
+    );
+  }
+
+private:
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  static inline bool d(
+    std::false_type,
+    std::size_t const size,
+    NeedleBegin &&begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
     bool found = false;
     sorted_search<
       list<n<Haystack, IsTerminal, Begin, End, Children...>, Node, Siblings...>,
       F<Begin, Filter>
     >(
       *begin,
-      l(),
+      v<Policy>(),
       found,
       size,
       static_cast<NeedleBegin &&>(begin),
@@ -181,27 +401,59 @@ struct l<
   }
 
   template <
-    typename Match,
-    std::size_t Index,
+    typename Policy,
     typename NeedleBegin,
     typename Visitor,
     typename... VArgs
   >
-  void operator ()(
-    indexed<Match, Index>,
-    bool &found,
+  static inline bool d(
+    std::true_type,
     std::size_t const size,
     NeedleBegin &&begin,
     Visitor &&visitor,
     VArgs &&...args
-  ) const {
-    found = l<1, Filter, Match>::f(
-      size - 1,
-      std::next(begin),
+  ) {
+    return J<
+      l,
+      Filter,
+      Begin,
+      n<Haystack, IsTerminal, Begin, End, Children...>,
+      Node,
+      Siblings...
+    >::template f<Policy>(
+      size,
+      static_cast<NeedleBegin &&>(begin),
       static_cast<Visitor &&>(visitor),
       static_cast<VArgs &&>(args)...
     );
   }
+
+  // sorted search visitor //
+  template <typename Policy>
+  struct v {
+    template <
+      typename Match,
+      std::size_t Index,
+      typename NeedleBegin,
+      typename Visitor,
+      typename... VArgs
+    >
+    void operator ()(
+      indexed<Match, Index>,
+      bool &found,
+      std::size_t const size,
+      NeedleBegin &&begin,
+      Visitor &&visitor,
+      VArgs &&...args
+    ) const {
+      found = l<1, Filter, Match>::template f<Policy>(
+        size - 1,
+        std::next(begin),
+        static_cast<Visitor &&>(visitor),
+        static_cast<VArgs &&>(args)...
+      );
+    }
+  };
 };
 
 // helper to expose the trie lookup implementation as a transform //
@@ -211,94 +463,603 @@ struct L {
   using apply = l<0, Filter, T...>;
 };
 
-// trie build recursion //
-template <std::size_t, typename...> struct r;
+// trie longest prefix lookup implementation //
+template <std::size_t, typename...> struct P;
 
-// helper to expose the trie build recursion as a transform //
-template <std::size_t Depth, typename Filter>
-struct R {
-  template <typename... Args>
-  using apply = typename r<Depth, Filter, Args...>::type;
+// empty subtrie //
+template <typename Filter>
+struct P<0, Filter> {
+  template <typename, typename... Args>
+  static constexpr inline bool f(Args &&...) { return false; }
 };
 
-// leaf //
-template <std::size_t Depth, typename Filter, typename T>
-struct r<Depth, Filter, T> {
-  using type = n<
-    T, true, Depth, size<typename Filter::template apply<T>>::value
-  >;
+// subtrie with single node: the deepest match wins, so children are looked
+// up before reporting this node //
+template <
+  std::size_t Offset,
+  typename Filter,
+  typename Haystack,
+  bool IsTerminal,
+  std::size_t Begin,
+  std::size_t End,
+  typename... Children
+>
+struct P<Offset, Filter, n<Haystack, IsTerminal, Begin, End, Children...>> {
+  static_assert(Offset + Begin <= End, "internal error");
+
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  static inline bool f(
+    std::size_t const size,
+    NeedleBegin &&begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
+    using haystack_data = typename Filter::template apply<Haystack>;
+
+    if (size < End - Begin - Offset) {
+      return false;
+    }
+
+    using value_type = typename std::iterator_traits<
+      typename std::decay<NeedleBegin>::type
+    >::value_type;
+
+    if (!Q<
+      Policy, typename std::decay<NeedleBegin>::type, End - Begin - Offset
+    >::f(
+      begin,
+      std::next(z_data<haystack_data, value_type>(), Offset + Begin)
+    )) {
+      return false;
+    }
+
+    if (P<0, Filter, Children...>::template f<Policy>(
+      size - (End - Begin - Offset),
+      std::next(begin, End - Begin - Offset),
+      visitor,
+      args...
+    )) {
+      return true;
+    }
+
+    if (IsTerminal) {
+      visitor(tag<Haystack>(), End, static_cast<VArgs &&>(args)...);
+    }
+
+    return IsTerminal;
+  }
+};
+
+// siblings //
+template <
+  typename Filter,
+  typename Haystack,
+  bool IsTerminal,
+  std::size_t Begin,
+  std::size_t End,
+  typename... Children,
+  typename Node,
+  typename... Siblings
+>
+struct P<
+  0,
+  Filter,
+  n<Haystack, IsTerminal, Begin, End, Children...>,
+  Node,
+  Siblings...
+> {
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  static inline bool f(
+    std::size_t const size,
+    NeedleBegin &&begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
+    if (!size) {
+      return false;
+    }
+
+    return d<Policy>(
+      j<
+        Policy,
+        typename std::decay<NeedleBegin>::type,
+        typename F<Begin, Filter>::template apply<
+          n<Haystack, IsTerminal, Begin, End, Children...>
+        >,
+        sizeof...(Siblings) + 2
+      >(),
+      size,
+      static_cast<NeedleBegin &&>(begin),
+      static_cast<Visitor &&>(visitor),
+      static_cast<VArgs &&>(args)...
+    );
+  }
+
+private:
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  static inline bool d(
+    std::false_type,
+    std::size_t const size,
+    NeedleBegin &&begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
+    bool found = false;
+    sorted_search<
+      list<n<Haystack, IsTerminal, Begin, End, Children...>, Node, Siblings...>,
+      F<Begin, Filter>
+    >(
+      *begin,
+      v<Policy>(),
+      found,
+      size,
+      static_cast<NeedleBegin &&>(begin),
+      static_cast<Visitor &&>(visitor),
+      static_cast<VArgs &&>(args)...
+    );
+
+    return found;
+  }
+
+  template <
+    typename Policy,
+    typename NeedleBegin,
+    typename Visitor,
+    typename... VArgs
+  >
+  static inline bool d(
+    std::true_type,
+    std::size_t const size,
+    NeedleBegin &&begin,
+    Visitor &&visitor,
+    VArgs &&...args
+  ) {
+    return J<
+      P,
+      Filter,
+      Begin,
+      n<Haystack, IsTerminal, Begin, End, Children...>,
+      Node,
+      Siblings...
+    >::template f<Policy>(
+      size,
+      static_cast<NeedleBegin &&>(begin),
+      static_cast<Visitor &&>(visitor),
+      static_cast<VArgs &&>(args)...
+    );
+  }
+
+  // sorted search visitor //
+  template <typename Policy>
+  struct v {
+    template <
+      typename Match,
+      std::size_t Index,
+      typename NeedleBegin,
+      typename Visitor,
+      typename... VArgs
+    >
+    void operator ()(
+      indexed<Match, Index>,
+      bool &found,
+      std::size_t const size,
+      NeedleBegin &&begin,
+      Visitor &&visitor,
+      VArgs &&...args
+    ) const {
+      found = P<1, Filter, Match>::template f<Policy>(
+        size - 1,
+        std::next(begin),
+        static_cast<Visitor &&>(visitor),
+        static_cast<VArgs &&>(args)...
+      );
+    }
+  };
+};
+
+// maps the trie lookup implementation to the longest prefix one //
+template <typename> struct p;
+
+template <typename Filter, typename... Nodes>
+struct p<l<0, Filter, Nodes...>> {
+  using type = P<0, Filter, Nodes...>;
+};
+
+// the characters of a key given as a sequence of values, or `void` as the
+// `type` of any other key //
+template <typename>
+struct a {
+  using type = void;
+};
+
+template <template <typename V, V...> class Variadic, typename T, T... Values>
+struct a<Variadic<T, Values...>> {
+  using type = T;
+
+  static constexpr T const data[sizeof...(Values) + 1] = {Values..., T()};
 };
 
-// internal node //
-template <std::size_t Depth, typename Filter, typename T, typename... Args>
-struct r<Depth, Filter, T, Args...> {
-  using common = longest_common_prefix<
+// tells whether key `lhs` sorts before key `rhs`, the same way as
+// `sequence_compare` does for sequences of values //
+template <typename T>
+static constexpr bool B(
+  T const *lhs,
+  std::size_t lhs_size,
+  T const *rhs,
+  std::size_t rhs_size
+) {
+  for (std::size_t i = 0; i < lhs_size && i < rhs_size; ++i) {
+    if (lhs[i] != rhs[i]) {
+      return lhs[i] < rhs[i];
+    }
+  }
+
+  return lhs_size < rhs_size;
+}
+
+// the order of a list of keys, as indexes into the list //
+template <std::size_t Size>
+struct O {
+  std::size_t data[Size];
+};
+
+// stable merge sort of the indexes of the keys `key`, so that only the
+// resulting order needs to be instantiated as a list of types //
+template <std::size_t Size, typename T>
+static constexpr O<Size> Z(T const *const *key, std::size_t const *size) {
+  O<Size> order{};
+  O<Size> merged{};
+
+  for (std::size_t i = 0; i < Size; ++i) {
+    order.data[i] = i;
+  }
+
+  for (std::size_t width = 1; width < Size; width *= 2) {
+    for (std::size_t begin = 0; begin < Size; begin += 2 * width) {
+      auto const middle = begin + width < Size ? begin + width : Size;
+      auto const end = middle + width < Size ? middle + width : Size;
+
+      for (auto i = begin, l = begin, r = middle; i < end; ++i) {
+        merged.data[i] = l < middle && (
+          r == end || !B(
+            key[order.data[r]], size[order.data[r]],
+            key[order.data[l]], size[order.data[l]]
+          )
+        ) ? order.data[l++] : order.data[r++];
+      }
+    }
+
+    for (std::size_t i = 0; i < Size; ++i) {
+      order.data[i] = merged.data[i];
+    }
+  }
+
+  return order;
+}
+
+// sorts the keys `T` for building the trie //
+template <bool, typename, typename, typename> struct H;
+
+// keys other than sequences of values, compared as types //
+template <typename Filter, typename Comparer, typename T>
+struct H<false, Filter, Comparer, T> {
+  using type = sort<T, sequence_compare<Comparer>, Filter>;
+};
+
+// keys given as sequences of values of the same type: `sequence_compare`
+// compares those values with `<` regardless of `Comparer`, so the keys are
+// sorted by a constexpr function over their characters instead, which is
+// cheaper to compile than instantiating a comparison per pair of keys //
+template <
+  typename Filter,
+  typename Comparer,
+  template <typename...> class Variadic,
+  typename T,
+  typename... Args
+>
+struct H<true, Filter, Comparer, Variadic<T, Args...>> {
+  using value_type = typename a<typename Filter::template apply<T>>::type;
+
+  static constexpr value_type const *const key[sizeof...(Args) + 1] = {
+    a<typename Filter::template apply<T>>::data,
+    a<typename Filter::template apply<Args>>::data...
+  };
+
+  static constexpr std::size_t const size[sizeof...(Args) + 1] = {
+    fatal::size<typename Filter::template apply<T>>::value,
+    fatal::size<typename Filter::template apply<Args>>::value...
+  };
+
+  static constexpr O<sizeof...(Args) + 1> const order = Z<
+    sizeof...(Args) + 1
+  >(key, size);
+
+  template <typename> struct A;
+
+  template <std::size_t... Index>
+  struct A<index_sequence<Index...>> {
+    using type = pick<Variadic<T, Args...>, order.data[Index]...>;
+  };
+
+  using type = typename A<make_index_sequence<sizeof...(Args) + 1>>::type;
+};
+
+// trie build input: the keys `T` sorted with `Comparer` //
+template <typename Filter, typename Comparer, typename T>
+struct Y;
+
+template <
+  typename Filter,
+  typename Comparer,
+  template <typename...> class Variadic
+>
+struct Y<Filter, Comparer, Variadic<>> {
+  using type = Variadic<>;
+};
+
+template <
+  typename Filter,
+  typename Comparer,
+  template <typename...> class Variadic,
+  typename T,
+  typename... Args
+>
+struct Y<Filter, Comparer, Variadic<T, Args...>>:
+  H<
+    sizeof...(Args)
+      && !std::is_void<
+        typename a<typename Filter::template apply<T>>::type
+      >::value
+      && std::is_same<
+        list<
+          typename a<typename Filter::template apply<T>>::type,
+          typename a<typename Filter::template apply<Args>>::type...
+        >,
+        list<
+          typename a<typename Filter::template apply<Args>>::type...,
+          typename a<typename Filter::template apply<T>>::type
+        >
+      >::value,
+    Filter,
+    Comparer,
+    Variadic<T, Args...>
+  >
+{};
+
+// common prefix size of the characters `lhs` and `rhs` //
+template <typename T>
+static constexpr std::size_t W(
+  T const *lhs,
+  std::size_t lhs_size,
+  T const *rhs,
+  std::size_t rhs_size
+) {
+  std::size_t i = 0;
+
+  while (i < lhs_size && i < rhs_size && lhs[i] == rhs[i]) {
+    ++i;
+  }
+
+  return i;
+}
+
+// common prefix size of two filtered keys //
+template <typename LHS, typename RHS>
+struct U:
+  longest_common_prefix<
     at,
-    Depth,
-    vmin<
-      less,
-      size<typename Filter::template apply<T>>,
-      size<typename Filter::template apply<Args>>...
-    >::value,
-    typename Filter::template apply<T>, typename Filter::template apply<Args>...
+    0,
+    vmin<less, size<LHS>, size<RHS>>::value,
+    LHS,
+    RHS
+  >
+{};
+
+// keys given as sequences of values, compared by a constexpr function //
+template <
+  template <typename V, V...> class Variadic,
+  typename T,
+  T... LHS,
+  T... RHS
+>
+struct U<Variadic<T, LHS...>, Variadic<T, RHS...>>:
+  std::integral_constant<
+    std::size_t,
+    W(
+      a<Variadic<T, LHS...>>::data, sizeof...(LHS),
+      a<Variadic<T, RHS...>>::data, sizeof...(RHS)
+    )
+  >
+{};
+
+// common prefix size of two keys, or 0 past the last key //
+template <typename Filter, typename LHS, typename RHS>
+struct u:
+  U<
+    typename Filter::template apply<LHS>,
+    typename Filter::template apply<RHS>
+  >
+{};
+
+template <typename Filter, typename T>
+struct u<Filter, T, void>: std::integral_constant<std::size_t, 0> {};
+
+// sorted keys the trie is built from: knowing the size of each key and the
+// common prefix size of each pair of adjacent keys is enough to build any
+// subtrie out of a range of indexes, so that the keys are only compared once
+// and the build recursion is as deep as the longest key rather than as long
+// as the list of keys //
+template <typename, typename, typename> struct s;
+
+template <typename Filter, typename... T, typename... Next>
+struct s<Filter, list<T...>, list<Next...>> {
+  using keys = list<T...>;
+
+  static constexpr std::size_t const size[sizeof...(T)] = {
+    fatal::size<typename Filter::template apply<T>>::value...
+  };
+
+  // `lcp[i]` is the common prefix size of keys `i` and `i + 1` //
+  static constexpr std::size_t const lcp[sizeof...(T)] = {
+    u<Filter, T, Next>::value...
+  };
+};
+
+// common prefix size of the sorted keys `[begin, end)` //
+static constexpr std::size_t v(
+  std::size_t const *size,
+  std::size_t const *lcp,
+  std::size_t begin,
+  std::size_t end
+) {
+  std::size_t common = size[begin];
+
+  for (auto i = begin; i + 1 < end; ++i) {
+    common = lcp[i] < common ? lcp[i] : common;
+  }
+
+  return common;
+}
+
+// the children of a node sharing `common` characters are the runs of the
+// sorted keys `[begin, end)` that share more than that: this is the number
+// of such runs //
+static constexpr std::size_t m(
+  std::size_t const *lcp,
+  std::size_t begin,
+  std::size_t end,
+  std::size_t common
+) {
+  std::size_t count = begin < end;
+
+  for (auto i = begin; i + 1 < end; ++i) {
+    count += lcp[i] == common;
+  }
+
+  return count;
+}
+
+// where run `run` of the ones counted by `m` begins, or `end` past the last //
+static constexpr std::size_t S(
+  std::size_t const *lcp,
+  std::size_t begin,
+  std::size_t end,
+  std::size_t common,
+  std::size_t run
+) {
+  if (!run) {
+    return begin;
+  }
+
+  for (auto i = begin; i + 1 < end; ++i) {
+    if (lcp[i] == common && !--run) {
+      return i + 1;
+    }
+  }
+
+  return end;
+}
+
+// trie build recursion: the subtrie of the sorted keys `[Begin, End)`, all of
+// them sharing their first `Depth` characters //
+template <
+  typename Keys,
+  std::size_t Depth,
+  std::size_t Begin,
+  std::size_t End,
+  std::size_t Common = v(Keys::size, Keys::lcp, Begin, End),
+  // the first key ends at this node - it is not part of any child //
+  bool IsTerminal = Keys::size[Begin] == Common
+>
+struct r;
+
+// children of a node: the runs of the sorted keys `[Begin, End)` sharing more
+// than `Common` characters, given to `Node` //
+template <typename, std::size_t, std::size_t, std::size_t, typename> struct R;
+
+template <
+  typename Keys,
+  std::size_t Common,
+  std::size_t Begin,
+  std::size_t End,
+  std::size_t... Runs
+>
+struct R<Keys, Common, Begin, End, index_sequence<Runs...>> {
+  template <template <typename...> class Node>
+  using apply = Node<
+    typename r<
+      Keys,
+      Common,
+      S(Keys::lcp, Begin, End, Common, Runs),
+      S(Keys::lcp, Begin, End, Common, Runs + 1)
+    >::type...
   >;
+};
 
-  using type = group_by<
-    conditional<
-      size<typename Filter::template apply<T>>::value == common::value,
-      list<Args...>,
-      list<T, Args...>
-    >,
-    a<common::value, Filter>,
-    R<common::value, Filter>::template apply,
-    N<
-      T,
-      common::value == size<typename Filter::template apply<T>>::value,
-      Depth,
-      common::value
-    >::template apply
+template <typename Keys, std::size_t Begin, std::size_t End, std::size_t Common>
+using G = R<
+  Keys, Common, Begin, End,
+  make_index_sequence<m(Keys::lcp, Begin, End, Common)>
+>;
+
+template <
+  typename Keys,
+  std::size_t Depth,
+  std::size_t Begin,
+  std::size_t End,
+  std::size_t Common,
+  bool IsTerminal
+>
+struct r {
+  using type = typename G<
+    Keys, Begin + IsTerminal, End, Common
+  >::template apply<
+    N<at<typename Keys::keys, Begin>, IsTerminal, Depth, Common>::template apply
   >;
 };
 
 // trie build entry point helper //
-template <bool, std::size_t, typename...> struct h;
-
-// no common prefix and no empty string //
-template <std::size_t Common, typename Filter, typename T, typename... Args>
-struct h<true, Common, Filter, T, Args...> {
-  using type = group_by<
-    list<T, Args...>,
-    a<0, Filter>,
-    R<0, Filter>::template apply,
-    L<Filter>::template apply
-  >;
+template <bool, typename, typename> struct h;
+
+// no common prefix and no empty string: no root node //
+template <typename Filter, typename Keys>
+struct h<true, Filter, Keys> {
+  using type = typename G<
+    Keys, 0, size<typename Keys::keys>::value, 0
+  >::template apply<L<Filter>::template apply>;
 };
 
-// common prefix or empty string //
-template <std::size_t Common, typename Filter, typename T, typename... Args>
-struct h<false, Common, Filter, T, Args...> {
+// common prefix or empty string: a single root node //
+template <typename Filter, typename Keys>
+struct h<false, Filter, Keys> {
   using type = l<
-    0,
-    Filter,
-    group_by<
-      conditional<
-        size<typename Filter::template apply<T>>::value == Common,
-        list<Args...>,
-        list<T, Args...>
-      >,
-      a<Common, Filter>,
-      R<Common, Filter>::template apply,
-      N<
-        T, Common == size<typename Filter::template apply<T>>::value, 0, Common
-      >::template apply
-    >
+    0, Filter, typename r<Keys, 0, 0, size<typename Keys::keys>::value>::type
   >;
 };
 
+// sorted keys given to the trie build entry point //
+template <typename Filter, typename T, typename... Args>
+using E = s<Filter, list<T, Args...>, list<Args..., void>>;
+
 // trie build entry point //
 template <typename...> struct e;
 
-// non-empty input - find longest common prefix //
+// non-empty input //
 template <
   typename Filter,
   template <typename...> class Variadic,
@@ -306,44 +1067,374 @@ template <
 >
 struct e<Filter, Variadic<T, Args...>>:
   h<
-    (size<typename Filter::template apply<T>>::value > 1)
-      && !longest_common_prefix<
-        at,
-        0,
-        vmin<less, size<typename Filter::template apply<Args>>...>::value,
-        typename Filter::template apply<Args>...
-      >::value,
-    longest_common_prefix<
-      at,
+    !v(
+      E<Filter, T, Args...>::size,
+      E<Filter, T, Args...>::lcp,
       0,
-      vmin<
-        less,
-        size<typename Filter::template apply<T>>,
-        size<typename Filter::template apply<Args>>...
-      >::value,
-      typename Filter::template apply<T>,
-      typename Filter::template apply<Args>...
-    >::value,
+      sizeof...(Args) + 1
+    ) && E<Filter, T, Args...>::size[0],
     Filter,
-    T, Args...
+    E<Filter, T, Args...>
   >
 {};
 
-// unitary input //
-template <typename Filter, template <typename...> class Variadic, typename T>
-struct e<Filter, Variadic<T>> {
-  using type = l<
-    0,
-    Filter,
-    n<T, true, 0, size<typename Filter::template apply<T>>::value>
-  >;
-};
-
 // empty input //
 template <typename Filter, template <typename...> class Variadic>
 struct e<Filter, Variadic<>> {
   using type = l<0, Filter>;
 };
 
+// flat trie node, as laid out in memory //
+struct o {
+  // the edge leading to this node //
+  char const *edge;
+  std::size_t length;
+  // the contiguous range of children //
+  std::size_t first;
+  std::size_t count;
+  bool terminal;
+};
+
+// number of descendants of a node //
+template <typename> struct D;
+
+template <
+  typename Haystack,
+  bool IsTerminal,
+  std::size_t Begin,
+  std::size_t End,
+  typename... Children
+>
+struct D<n<Haystack, IsTerminal, Begin, End, Children...>>:
+  size_constant<
+    sizeof...(Children)
+      + add::apply<size_constant<0>, D<Children>...>::value
+  >
+{};
+
+// flat node entry: `First` and `Count` give the range of children //
+template <typename Node, std::size_t First, std::size_t Count>
+struct x;
+
+// synthetic root with an empty edge //
+template <std::size_t First, std::size_t Count>
+struct x<void, First, Count> {
+  template <typename>
+  static constexpr o get() { return o{nullptr, 0, First, Count, false}; }
+
+  template <typename>
+  static constexpr char head() { return '\0'; }
+
+  template <typename Visitor, typename... VArgs>
+  static void visit(Visitor &, VArgs &...) {}
+};
+
+template <
+  typename Haystack,
+  bool IsTerminal,
+  std::size_t Begin,
+  std::size_t End,
+  typename... Children,
+  std::size_t First,
+  std::size_t Count
+>
+struct x<n<Haystack, IsTerminal, Begin, End, Children...>, First, Count> {
+  // the first character of the edge is matched when picking the child, so
+  // it's left out of the edge //
+  template <typename Filter>
+  static constexpr o get() {
+    return o{
+      z_data<typename Filter::template apply<Haystack>, char>()
+        + Begin + (Begin < End),
+      End - Begin - (Begin < End),
+      First,
+      Count,
+      IsTerminal
+    };
+  }
+
+  // the first character of the edge, used to pick a child //
+  template <typename Filter>
+  static constexpr char head() {
+    return Begin < End
+      ? z_data<typename Filter::template apply<Haystack>, char>()[Begin]
+      : '\0';
+  }
+
+  template <typename Visitor, typename... VArgs>
+  static void visit(Visitor &visitor, VArgs &...args) {
+    visitor(tag<Haystack>(), args...);
+  }
+};
+
+// lays out a block of siblings starting at `Base`, followed by the blocks of
+// their descendants //
+template <std::size_t, typename> struct b;
+
+// sibling placement recursion //
+template <std::size_t, typename, typename, typename...> struct g;
+
+template <std::size_t Next, typename... Entries, typename... Blocks>
+struct g<Next, list<Entries...>, list<Blocks...>> {
+  using type = cat<list<Entries...>, Blocks...>;
+};
+
+template <
+  std::size_t Next,
+  typename... Entries,
+  typename... Blocks,
+  typename Haystack,
+  bool IsTerminal,
+  std::size_t Begin,
+  std::size_t End,
+  typename... Children,
+  typename... Siblings
+>
+struct g<
+  Next,
+  list<Entries...>,
+  list<Blocks...>,
+  n<Haystack, IsTerminal, Begin, End, Children...>,
+  Siblings...
+>:
+  g<
+    Next + D<n<Haystack, IsTerminal, Begin, End, Children...>>::value,
+    list<
+      Entries...,
+      x<
+        n<Haystack, IsTerminal, Begin, End, Children...>,
+        Next,
+        sizeof...(Children)
+      >
+    >,
+    list<Blocks..., typename b<Next, list<Children...>>::type>,
+    Siblings...
+  >
+{};
+
+template <std::size_t Base, typename... Nodes>
+struct b<Base, list<Nodes...>>:
+  g<Base + sizeof...(Nodes), list<>, list<>, Nodes...>
+{};
+
+// flat trie node table //
+template <typename, typename> struct y;
+
+template <typename Filter, typename... Entries>
+struct y<Filter, list<Entries...>> {
+  static constexpr o const node[sizeof...(Entries)] = {
+    Entries::template get<Filter>()...
+  };
+
+  static constexpr char const head[sizeof...(Entries)] = {
+    Entries::template head<Filter>()...
+  };
+
+  // node -> visitor thunk //
+  template <typename Visitor, typename... VArgs>
+  struct V {
+    using type = void (*)(Visitor &, VArgs &...);
+
+    static constexpr type const data[sizeof...(Entries)] = {
+      &Entries::template visit<Visitor, VArgs...>...
+    };
+  };
+};
+
+#if FATAL_CPLUSPLUS < 201703L
+template <
+  template <std::size_t, typename...> class Lookup,
+  typename Filter,
+  std::size_t Begin,
+  typename... Nodes
+>
+constexpr k<typename J<Lookup, Filter, Begin, Nodes...>::slot> const J<
+  Lookup, Filter, Begin, Nodes...
+>::table;
+
+template <
+  template <std::size_t, typename...> class Lookup,
+  typename Filter,
+  std::size_t Begin,
+  typename... Nodes
+>
+template <
+  typename Policy,
+  typename NeedleBegin,
+  typename Visitor,
+  typename... VArgs
+>
+constexpr typename J<Lookup, Filter, Begin, Nodes...>::template T<
+  Policy, NeedleBegin, Visitor, VArgs...
+>::type const J<Lookup, Filter, Begin, Nodes...>::T<
+  Policy, NeedleBegin, Visitor, VArgs...
+>::data[sizeof...(Nodes) + 1];
+
+template <template <typename V, V...> class Variadic, typename T, T... Values>
+constexpr T const a<Variadic<T, Values...>>::data[sizeof...(Values) + 1];
+
+template <
+  typename Filter,
+  typename Comparer,
+  template <typename...> class Variadic,
+  typename T,
+  typename... Args
+>
+constexpr typename H<true, Filter, Comparer, Variadic<T, Args...>>::value_type
+  const *const H<true, Filter, Comparer, Variadic<T, Args...>>::key[
+    sizeof...(Args) + 1
+  ];
+
+template <
+  typename Filter,
+  typename Comparer,
+  template <typename...> class Variadic,
+  typename T,
+  typename... Args
+>
+constexpr std::size_t const H<true, Filter, Comparer, Variadic<T, Args...>>
+  ::size[sizeof...(Args) + 1];
+
+template <
+  typename Filter,
+  typename Comparer,
+  template <typename...> class Variadic,
+  typename T,
+  typename... Args
+>
+constexpr O<sizeof...(Args) + 1> const H<
+  true, Filter, Comparer, Variadic<T, Args...>
+>::order;
+
+template <typename Filter, typename... T, typename... Next>
+constexpr std::size_t const s<Filter, list<T...>, list<Next...>>::size[
+  sizeof...(T)
+];
+
+template <typename Filter, typename... T, typename... Next>
+constexpr std::size_t const s<Filter, list<T...>, list<Next...>>::lcp[
+  sizeof...(T)
+];
+
+template <typename Filter, typename... Entries>
+constexpr o const y<Filter, list<Entries...>>::node[sizeof...(Entries)];
+
+template <typename Filter, typename... Entries>
+constexpr char const y<Filter, list<Entries...>>::head[sizeof...(Entries)];
+
+template <typename Filter, typename... Entries>
+template <typename Visitor, typename... VArgs>
+constexpr typename y<Filter, list<Entries...>>::template V<
+  Visitor, VArgs...
+>::type const y<Filter, list<Entries...>>::V<
+  Visitor, VArgs...
+>::data[sizeof...(Entries)];
+#endif
+
+// flattens a trie given its lookup implementation: the root is always the
+// first node and has an empty edge, being a synthetic node unless the trie
+// already has a single top level node with an empty edge //
+template <typename> struct X;
+
+// top level node with an empty edge //
+template <
+  typename Filter,
+  typename Haystack,
+  bool IsTerminal,
+  typename... Children
+>
+struct X<l<0, Filter, n<Haystack, IsTerminal, 0, 0, Children...>>> {
+  using type = y<
+    Filter,
+    cat<
+      list<
+        x<n<Haystack, IsTerminal, 0, 0, Children...>, 1, sizeof...(Children)>
+      >,
+      typename b<1, list<Children...>>::type
+    >
+  >;
+};
+
+template <typename Filter, typename... Nodes>
+struct X<l<0, Filter, Nodes...>> {
+  using type = y<
+    Filter,
+    cat<
+      list<x<void, 1, sizeof...(Nodes)>>,
+      typename b<1, list<Nodes...>>::type
+    >
+  >;
+};
+
+// streaming lookup over a flat trie: the position in the trie is kept in
+// `node` and `offset` (how much of the node's edge has been matched) so that
+// the input can be given in pieces //
+template <typename Table>
+struct M {
+  // no string in the trie can match the input anymore //
+  using dead = std::integral_constant<std::size_t, ~std::size_t(0)>;
+
+  template <typename Iterator>
+  static void f(
+    std::size_t &node,
+    std::size_t &offset,
+    Iterator begin,
+    Iterator const end
+  ) {
+    while (node != dead::value && begin != end) {
+      auto const &current = Table::node[node];
+
+      if (offset < current.length) {
+        auto const size = std::min(
+          current.length - offset,
+          static_cast<std::size_t>(std::distance(begin, end))
+        );
+        auto const edge = current.edge + offset;
+
+        if (!std::equal(edge, edge + size, begin)) {
+          node = dead::value;
+          return;
+        }
+
+        offset += size;
+        std::advance(begin, size);
+        continue;
+      }
+
+      auto const first = Table::head + current.first;
+      auto const last = first + current.count;
+      auto const child = std::lower_bound(first, last, *begin);
+
+      if (child == last || *child != *begin) {
+        node = dead::value;
+        return;
+      }
+
+      node = static_cast<std::size_t>(child - Table::head);
+      offset = 0;
+      ++begin;
+    }
+  }
+
+  template <typename Visitor, typename... VArgs>
+  static bool d(
+    std::size_t node,
+    std::size_t offset,
+    Visitor &visitor,
+    VArgs &...args
+  ) {
+    if (
+      node == dead::value
+        || offset != Table::node[node].length
+        || !Table::node[node].terminal
+    ) {
+      return false;
+    }
+
+    Table::template V<Visitor, VArgs...>::data[node](visitor, args...);
+    return true;
+  }
+};
+
 } // namespace i_t {
 } // namespace fatal {
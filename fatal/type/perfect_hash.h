@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+#pragma once
+
+#include <fatal/functional/no_op.h>
+#include <fatal/type/compare.h>
+#include <fatal/type/identity.h>
+
+#include <fatal/type/impl/perfect_hash.h>
+
+#include <iterator>
+
+#include <cassert>
+
+namespace fatal {
+
+/**
+ * Looks up the string `[begin, end)` in the list of compile-time strings `T`
+ * using a minimal perfect hash built at compile time. When found, calls
+ * `visitor(tag<String>(), args...)` for the matching `String` and returns
+ * `true`. Returns `false` otherwise.
+ *
+ * This takes the same arguments as `trie_find`. The lookup costs one hash of
+ * the needle, one table probe and one comparison against the candidate,
+ * regardless of how the strings in `T` are distributed.
+ *
+ * `Filter` is applied to each element of `T` to obtain the string to match.
+ *
+ * `Comparer` is accepted so that this can stand in for `trie_find`, whose
+ * comparer only orders the keys of the trie and never changes which strings
+ * match. The perfect hash doesn't order its keys, so it's unused.
+ *
+ * Strings are hashed as sequences of `char`. The strings in `T` must be
+ * unique.
+ *
+ * Example:
+ *
+ *  FATAL_S(hello, "hello");
+ *  FATAL_S(world, "world");
+ *
+ *  std::string s("world");
+ *
+ *  // returns `true` and calls `visitor(tag<world>())`
+ *  perfect_hash_find<list<hello, world>>(s.begin(), s.end(), visitor);
+ */
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Comparer = less,
+  typename Begin,
+  typename End,
+  typename Visitor,
+  typename... VArgs
+>
+static inline bool perfect_hash_find(
+  Begin &&begin,
+  End &&end,
+  Visitor &&visitor,
+  VArgs &&...args
+) {
+  assert(begin <= end);
+  return i_ph::f<T, Filter>::F(
+    static_cast<std::size_t>(std::distance(begin, end)),
+    begin,
+    static_cast<Visitor &&>(visitor),
+    static_cast<VArgs &&>(args)...
+  );
+}
+
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Comparer = less,
+  typename Begin,
+  typename End
+>
+static inline bool perfect_hash_find(Begin &&begin, End &&end) {
+  return perfect_hash_find<T, Filter, Comparer>(
+    static_cast<Begin &&>(begin),
+    static_cast<End &&>(end),
+    fn::no_op()
+  );
+}
+
+/**
+ * Exposes `perfect_hash_find` as a lookup backend for interfaces that let
+ * the caller choose one, like `enum_traits::parse`.
+ *
+ * It matches the same strings as `trie_finder`, for any `Comparer` the
+ * latter is given.
+ *
+ * See also `trie_finder`.
+ *
+ * Example:
+ *
+ *  // parses using a perfect hash rather than a trie
+ *  auto e = enum_traits<my_enum>::parse<perfect_hash_finder>(s);
+ */
+struct perfect_hash_finder {
+  template <typename T, typename Filter = get_identity, typename... Args>
+  static inline bool find(Args &&...args) {
+    return perfect_hash_find<T, Filter>(static_cast<Args &&>(args)...);
+  }
+};
+
+} // namespace fatal {
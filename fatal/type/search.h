@@ -54,50 +54,145 @@ static inline constexpr bool sorted_search(Needle &&needle) {
   );
 }
 
+/**
+ * Same as `sorted_search` with the default `value_comparer`, for lists sorted
+ * by the value of `Filter::apply<T>`, but rather than expanding into nested
+ * comparisons, the values are laid out in a static array in Eytzinger
+ * (breadth first) order and searched with a branchless loop. The visitor is
+ * still called with `indexed<T, Index>`, `Index` being the position in `T`.
+ *
+ * This keeps code size and branch mispredictions down for large lists.
+ */
 template <
   typename T,
   typename Filter = get_identity,
-  typename Comparer = value_comparer,
   typename Needle,
   typename Visitor,
   typename... Args
 >
-static inline constexpr bool scalar_search(
+static inline bool eytzinger_search(
   Needle &&needle,
   Visitor &&visitor,
   Args &&...args
 ) {
-  return sorted_search<sort<T, Comparer, Filter>, Filter, Comparer>(
+  return i_S::e<T, Filter>::S(
     static_cast<Needle &&>(needle),
     static_cast<Visitor &&>(visitor),
     static_cast<Args &&>(args)...
   );
 }
 
+template <typename T, typename Filter = get_identity, typename Needle>
+static inline bool eytzinger_search(Needle &&needle) {
+  return eytzinger_search<T, Filter>(
+    static_cast<Needle &&>(needle),
+    fn::no_op()
+  );
+}
+
+/**
+ * Tunes how `scalar_search` and `index_search` look up values at runtime.
+ *
+ * `DensityPercent`: when the values fill at least this percentage of the
+ * range between the smallest and the largest of them, the needle's offset
+ * from the smallest value indexes a jump table of visitor calls, so that the
+ * lookup takes a single bounds check regardless of the number of values.
+ * This is typically the case of enums and of `index_search`. Zero disables
+ * jump tables altogether.
+ *
+ * `EytzingerSize`: lists at least this large that don't use a jump table are
+ * looked up with `eytzinger_search`.
+ *
+ * `LinearSize`: lists up to this large that don't use a jump table, and whose
+ * values fit in 64 bytes, are looked up by comparing the needle against every
+ * value at once, using SIMD instructions when available. Zero disables linear
+ * scans.
+ *
+ * All of the above only apply to integral or enum values compared with the default
+ * `value_comparer`. Other lists are always looked up with nested comparisons.
+ *
+ * Example:
+ *
+ *  // never uses jump tables
+ *  scalar_search<my_list, get_identity, value_comparer, search_policy<0>>(
+ *    needle, visitor
+ *  );
+ */
+template <
+  std::size_t DensityPercent = 50,
+  std::size_t EytzingerSize = 256,
+  std::size_t LinearSize = 32
+>
+struct search_policy {
+  using density_percent = std::integral_constant<std::size_t, DensityPercent>;
+  using eytzinger_size = std::integral_constant<std::size_t, EytzingerSize>;
+  using linear_size = std::integral_constant<std::size_t, LinearSize>;
+};
+
+/**
+ * Same as `sorted_search`, for lists in any order: the visitor is given the
+ * position of the match in the sorted list. See `search_policy` for how the
+ * lookup is carried out.
+ */
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Comparer = value_comparer,
+  typename Policy = search_policy<>,
+  typename Needle,
+  typename Visitor,
+  typename... Args
+>
+static inline constexpr bool scalar_search(
+  Needle &&needle,
+  Visitor &&visitor,
+  Args &&...args
+) {
+  using sorted = sort<T, Comparer, Filter>;
+  return i_S::d<i_S::u<sorted, Filter, Comparer, Policy>::value>
+    ::template S<sorted, Comparer, Filter>(
+      static_cast<Needle &&>(needle),
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
+}
+
 template <
   typename T,
   typename Filter = get_identity,
   typename Comparer = value_comparer,
+  typename Policy = search_policy<>,
   typename Needle
 >
 static inline constexpr bool scalar_search(Needle &&needle) {
-  return scalar_search<T, Filter, Comparer>(
+  return scalar_search<T, Filter, Comparer, Policy>(
     static_cast<Needle &&>(needle),
     fn::no_op()
   );
 }
 
-template <typename T, typename Visitor, typename... Args>
+/**
+ * Looks up the element at position `needle` of `T`, calling the visitor with
+ * `indexed<Element, Index>` when found. Unless disabled by the policy, this
+ * is a single bounds check followed by a jump table lookup.
+ */
+template <
+  typename T,
+  typename Policy = search_policy<>,
+  typename Visitor,
+  typename... Args
+>
 static inline constexpr bool index_search(
   std::size_t needle,
   Visitor &&visitor,
   Args &&...args
 ) {
-  return sorted_search<T, index<T>>(
-    needle,
-    static_cast<Visitor &&>(visitor),
-    static_cast<Args &&>(args)...
-  );
+  return i_S::x<(Policy::density_percent::value && size<T>::value)>
+    ::template S<T>(
+      needle,
+      static_cast<Visitor &&>(visitor),
+      static_cast<Args &&>(args)...
+    );
 }
 
 } // namespace fatal {
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/aho_corasick.h>
+
+#include <fatal/type/array.h>
+#include <fatal/type/convert.h>
+#include <fatal/type/get_type.h>
+#include <fatal/type/list.h>
+#include <fatal/type/sequence.h>
+#include <fatal/type/transform.h>
+
+#include <fatal/test/driver.h>
+#include <fatal/test/words.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fatal {
+
+FATAL_S(he, "he");
+FATAL_S(she, "she");
+FATAL_S(his, "his");
+FATAL_S(hers, "hers");
+
+FATAL_S(a, "a");
+FATAL_S(aa, "aa");
+FATAL_S(aaa, "aaa");
+FATAL_S(ab, "ab");
+FATAL_S(bab, "bab");
+
+template <typename T>
+struct wrapper {
+  using value = T;
+};
+
+using occurrences = std::vector<std::pair<std::string, std::size_t>>;
+
+template <typename Filter>
+struct scan_visitor {
+  template <typename Match>
+  void operator ()(tag<Match>, std::size_t offset, occurrences &out) const {
+    out.emplace_back(
+      to_instance<std::string, typename Filter::template apply<Match>>(),
+      offset
+    );
+  }
+};
+
+// every occurrence of `strings` in `input`, ordered by where they end, then
+// from the longest to the shortest //
+occurrences naive_scan(
+  std::vector<std::string> const &strings,
+  std::string const &input
+) {
+  occurrences result;
+
+  for (std::size_t end = 1; end <= input.size(); ++end) {
+    occurrences here;
+
+    for (auto const &s: strings) {
+      if (
+        s.size() <= end && !input.compare(end - s.size(), s.size(), s)
+      ) {
+        here.emplace_back(s, end - s.size());
+      }
+    }
+
+    std::sort(here.begin(), here.end(), [](
+      std::pair<std::string, std::size_t> const &lhs,
+      std::pair<std::string, std::size_t> const &rhs
+    ) {
+      return lhs.second < rhs.second;
+    });
+
+    result.insert(result.end(), here.begin(), here.end());
+  }
+
+  return result;
+}
+
+template <typename T, typename Filter = get_identity>
+void check_aho_corasick_scan(std::string const &input) {
+  using strings = z_array<transform<T, Filter>, char const *>;
+
+  occurrences const expected = naive_scan(
+    std::vector<std::string>(
+      strings::data,
+      strings::data + strings::size::value
+    ),
+    input
+  );
+
+  occurrences actual;
+  auto const matches = aho_corasick_scan<T, Filter>(
+    input.begin(), input.end(), scan_visitor<Filter>(), actual
+  );
+
+  FATAL_EXPECT_EQ(expected.size(), matches);
+  FATAL_EXPECT_EQ(expected, actual);
+
+  FATAL_EXPECT_EQ(
+    matches,
+    (aho_corasick_scan<T, Filter>(input.data(), input.data() + input.size()))
+  );
+}
+
+FATAL_TEST(aho_corasick_scan, empty) {
+  occurrences actual;
+  std::string const input("ushers");
+  FATAL_EXPECT_EQ(
+    0,
+    (aho_corasick_scan<list<>>(
+      input.begin(), input.end(), scan_visitor<get_identity>(), actual
+    ))
+  );
+  FATAL_EXPECT_TRUE(actual.empty());
+}
+
+FATAL_TEST(aho_corasick_scan, scan) {
+  using hs = list<he, she, his, hers>;
+
+  {
+    occurrences actual;
+    std::string const input("ushers");
+    FATAL_EXPECT_EQ(
+      3,
+      (aho_corasick_scan<hs>(
+        input.begin(), input.end(), scan_visitor<get_identity>(), actual
+      ))
+    );
+
+    occurrences const expected{{"she", 1}, {"he", 2}, {"hers", 2}};
+    FATAL_EXPECT_EQ(expected, actual);
+  }
+
+  check_aho_corasick_scan<hs>("");
+  check_aho_corasick_scan<hs>("x");
+  check_aho_corasick_scan<hs>("ushers");
+  check_aho_corasick_scan<hs>("hishershe");
+  check_aho_corasick_scan<hs>("shshehishershishe");
+  check_aho_corasick_scan<hs>("h e s h e r s");
+
+  using as = list<a, aa, aaa, ab, bab>;
+  check_aho_corasick_scan<as>("aaaa");
+  check_aho_corasick_scan<as>("ababab");
+  check_aho_corasick_scan<as>("aababbabaaab");
+  check_aho_corasick_scan<as>("xaxaax");
+
+  check_aho_corasick_scan<transform<hs, applier<wrapper>>, get_type::value>(
+    "shshehishershishe"
+  );
+}
+
+FATAL_TEST(aho_corasick_scan, words) {
+  using words = random_250_words<list, sequence>;
+  using array = z_array<words, char const *>;
+
+  std::string input;
+  for (std::size_t i = 0; i < array::size::value; i += 7) {
+    input.append(array::data[i]);
+    input.append(array::data[(i * 13) % array::size::value]);
+    input.push_back(' ');
+  }
+
+  check_aho_corasick_scan<words>(input);
+}
+
+} // namespace fatal {
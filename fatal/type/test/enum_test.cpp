@@ -8,9 +8,13 @@
  */
 
 #include <fatal/type/enum.h>
+#include <fatal/type/perfect_hash.h>
 
+#include <fatal/string/rope.h>
 #include <fatal/test/driver.h>
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -92,6 +96,20 @@ FATAL_RICH_ENUM_CLASS(
   enum_field_95, enum_field_96, enum_field_97, enum_field_98, enum_field_99
 );
 
+FATAL_RICH_ENUM_CLASS_WITH_FINDER(
+  hashed_enum,
+  ::fatal::perfect_hash_finder,
+  hashed0,
+  (hashed1, 10),
+  hashed2
+);
+
+enum class signed_enum: signed char { a = -2, b, c, d };
+FATAL_EXPORT_RICH_ENUM(signed_enum, c, a, d, b);
+
+enum class unsigned_enum: unsigned { a = 0xfffffffd, b, c };
+FATAL_EXPORT_RICH_ENUM(unsigned_enum, b, c, a);
+
 /* TODO: FIX SUPPORT FOR EMPTY ENUMS
 FATAL_RICH_ENUM_CLASS(empty_enum);
 /*/
@@ -455,6 +473,57 @@ FATAL_TEST(enums, to_string) {
   }
 }
 
+FATAL_TEST(enums, to_string_contiguous) {
+  {
+    using traits = enum_traits<signed_enum>;
+    using e = signed_enum;
+
+    FATAL_EXPECT_EQ("a", traits::to_string(e::a));
+    FATAL_EXPECT_EQ("b", traits::to_string(e::b));
+    FATAL_EXPECT_EQ("c", traits::to_string(e::c));
+    FATAL_EXPECT_EQ("d", traits::to_string(e::d));
+
+    for (auto i: {-128, -3, 2, 3, 127}) {
+      FATAL_EXPECT_EQ(nullptr, traits::to_string(static_cast<e>(i)));
+      FATAL_EXPECT_EQ("", traits::to_string(static_cast<e>(i), ""));
+      FATAL_EXPECT_FALSE(traits::is_valid(static_cast<e>(i)));
+    }
+
+    FATAL_EXPECT_TRUE(traits::is_valid(e::a));
+    FATAL_EXPECT_TRUE(traits::is_valid(e::d));
+  }
+
+  {
+    using traits = enum_traits<unsigned_enum>;
+    using e = unsigned_enum;
+
+    FATAL_EXPECT_EQ("a", traits::to_string(e::a));
+    FATAL_EXPECT_EQ("b", traits::to_string(e::b));
+    FATAL_EXPECT_EQ("c", traits::to_string(e::c));
+
+    for (auto i: {0u, 1u, 0x7fffffffu, 0xfffffffcu}) {
+      FATAL_EXPECT_EQ(nullptr, traits::to_string(static_cast<e>(i)));
+      FATAL_EXPECT_FALSE(traits::is_valid(static_cast<e>(i)));
+    }
+
+    FATAL_EXPECT_TRUE(traits::is_valid(e::a));
+    FATAL_EXPECT_TRUE(traits::is_valid(e::c));
+  }
+
+  {
+    using traits = enum_traits<big_enum>;
+    using names = enum_names_array<big_enum>;
+    using values = enum_values_array<big_enum>;
+
+    for (std::size_t i = 0; i < values::size::value; ++i) {
+      FATAL_EXPECT_EQ(names::data[i], traits::to_string(values::data[i]));
+    }
+
+    FATAL_EXPECT_EQ(nullptr, traits::to_string(static_cast<big_enum>(100)));
+    FATAL_EXPECT_EQ(nullptr, traits::to_string(static_cast<big_enum>(-1)));
+  }
+}
+
 FATAL_TEST(enums, enum_to_string) {
   FATAL_EXPECT_EQ(nullptr, enum_to_string(static_cast<test_enum>(-1), nullptr));
   FATAL_EXPECT_EQ("state0", enum_to_string(test_enum::state0, nullptr));
@@ -638,4 +707,443 @@ FATAL_TEST(enums, parse) {
   }
 }
 
+FATAL_TEST(enums, parse_perfect_hash) {
+# define CREATE_TEST(e, x) \
+  do { \
+    std::string const s(FATAL_TO_STR(x)); \
+    FATAL_EXPECT_EQ(e::x, enum_traits<e>::parse<perfect_hash_finder>(s)); \
+    FATAL_EXPECT_EQ( \
+      e::x, \
+      enum_traits<e>::parse<perfect_hash_finder>(s.begin(), s.end()) \
+    ); \
+    FATAL_EXPECT_THROW(std::invalid_argument) { \
+      enum_traits<e>::parse<perfect_hash_finder>(s.begin(), s.begin()); \
+    }; \
+    FATAL_EXPECT_THROW(std::invalid_argument) { \
+      enum_traits<e>::parse<perfect_hash_finder>( \
+        std::next(s.begin()), s.end() \
+      ); \
+    }; \
+    FATAL_EXPECT_THROW(std::invalid_argument) { \
+      enum_traits<e>::parse<perfect_hash_finder>(s + "invalid"); \
+    }; \
+    \
+    e out = static_cast<e>(-1); \
+    FATAL_EXPECT_TRUE( \
+      enum_traits<e>::try_parse<perfect_hash_finder>(out, s) \
+    ); \
+    FATAL_EXPECT_EQ(e::x, out); \
+    \
+    out = static_cast<e>(-1); \
+    FATAL_EXPECT_FALSE( \
+      enum_traits<e>::try_parse<perfect_hash_finder>( \
+        out, s.begin(), s.begin() \
+      ) \
+    ); \
+    FATAL_EXPECT_EQ(static_cast<e>(-1), out); \
+  } while (false)
+
+  CREATE_TEST(test_enum, state0);
+  CREATE_TEST(test_enum, state1);
+  CREATE_TEST(test_enum, state2);
+  CREATE_TEST(test_enum, state3);
+
+  CREATE_TEST(custom_enum, field);
+  CREATE_TEST(custom_enum, field10);
+  CREATE_TEST(custom_enum, field2);
+
+# undef CREATE_TEST
+}
+
+FATAL_TEST(enums, max_name_size) {
+  FATAL_EXPECT_EQ(6, enum_traits<test_enum>::max_name_size::value);
+  FATAL_EXPECT_EQ(7, enum_traits<custom_enum>::max_name_size::value);
+  FATAL_EXPECT_EQ(13, enum_traits<big_enum>::max_name_size::value);
+  FATAL_EXPECT_EQ(0, enum_traits<empty_enum>::max_name_size::value);
+}
+
+FATAL_TEST(enums, parse_many) {
+  std::vector<std::string> const column{
+    "state2", "state0", "", "state1", "state", "state3", "state0x", "state2"
+  };
+  std::vector<test_enum> const expected{
+    test_enum::state2, test_enum::state0, static_cast<test_enum>(-1),
+    test_enum::state1, static_cast<test_enum>(-1), test_enum::state3,
+    static_cast<test_enum>(-1), test_enum::state2
+  };
+
+  std::vector<test_enum> out(column.size(), static_cast<test_enum>(-1));
+  std::unique_ptr<bool[]> parsed(new bool[column.size()]);
+
+  FATAL_EXPECT_EQ(
+    5,
+    enum_traits<test_enum>::parse_many(
+      column.begin(), column.end(), out.data(), parsed.get()
+    )
+  );
+  FATAL_EXPECT_EQ(expected, out);
+
+  for (std::size_t i = 0; i < column.size(); ++i) {
+    FATAL_EXPECT_EQ(expected[i] != static_cast<test_enum>(-1), parsed[i]);
+  }
+
+  std::vector<string_view> const views(column.begin(), column.end());
+  std::vector<test_enum> hashed(views.size(), static_cast<test_enum>(-1));
+  FATAL_EXPECT_EQ(
+    5,
+    enum_traits<test_enum>::parse_many<perfect_hash_finder>(
+      views.begin(), views.end(), hashed.data(), parsed.get()
+    )
+  );
+  FATAL_EXPECT_EQ(expected, hashed);
+
+  FATAL_EXPECT_EQ(
+    0,
+    enum_traits<test_enum>::parse_many(
+      column.begin(), column.begin(), out.data(), parsed.get()
+    )
+  );
+}
+
+FATAL_TEST(enums, parse_many_big) {
+  using traits = enum_traits<big_enum>;
+
+  std::vector<std::string> column;
+  std::vector<big_enum> expected;
+
+  for (auto i = 100; i--; ) {
+    auto const value = static_cast<big_enum>(i);
+    column.emplace_back(traits::to_string(value));
+    expected.push_back(value);
+  }
+
+  for (auto s: {"enum_field_100", "enum_field_", "enum_field_0x", "0"}) {
+    column.emplace_back(s);
+    expected.push_back(static_cast<big_enum>(-1));
+  }
+
+  std::vector<big_enum> out(column.size(), static_cast<big_enum>(-1));
+  std::unique_ptr<bool[]> parsed(new bool[column.size()]);
+
+  FATAL_EXPECT_EQ(
+    100,
+    traits::parse_many(column.begin(), column.end(), out.data(), parsed.get())
+  );
+  FATAL_EXPECT_EQ(expected, out);
+
+  for (std::size_t i = 0; i < column.size(); ++i) {
+    FATAL_EXPECT_EQ(i < 100, parsed[i]);
+  }
+}
+
+// also accepts names prefixed with `+` //
+struct prefixed_finder {
+  template <
+    typename T,
+    typename Filter,
+    typename Begin,
+    typename End,
+    typename... Args
+  >
+  static bool find(Begin begin, End end, Args &&...args) {
+    if (begin != end && *begin == '+') {
+      ++begin;
+    }
+
+    return trie_finder<>::find<T, Filter>(
+      begin, end, static_cast<Args &&>(args)...
+    );
+  }
+};
+
+FATAL_TEST(enums, parse_many_finder) {
+  std::vector<string_view> const column{"+state1", "state3", "+", "-state0"};
+  std::vector<test_enum> const expected{
+    test_enum::state1, test_enum::state3,
+    static_cast<test_enum>(-1), static_cast<test_enum>(-1)
+  };
+
+  std::vector<test_enum> out(column.size(), static_cast<test_enum>(-1));
+  bool parsed[4];
+
+  FATAL_EXPECT_EQ(
+    2,
+    enum_traits<test_enum>::parse_many<prefixed_finder>(
+      column.begin(), column.end(), out.data(), parsed
+    )
+  );
+  FATAL_EXPECT_EQ(expected, out);
+  FATAL_EXPECT_TRUE(parsed[0]);
+  FATAL_EXPECT_TRUE(parsed[1]);
+  FATAL_EXPECT_FALSE(parsed[2]);
+  FATAL_EXPECT_FALSE(parsed[3]);
+}
+
+template <typename Enum>
+std::string to_string_many(
+  std::vector<Enum> const &values,
+  char separator,
+  string_view fallback = string_view()
+) {
+  using traits = enum_traits<Enum>;
+
+  auto const longest = std::max(
+    traits::max_name_size::value,
+    fallback.size()
+  );
+  std::string buffer(values.size() * (longest + 1) + 1, '*');
+  auto const last = traits::to_string_many(
+    values.begin(), values.end(), &buffer[0], separator, fallback
+  );
+
+  // nothing is written past the returned pointer //
+  FATAL_EXPECT_EQ('*', *last);
+  return std::string(&buffer[0], last);
+}
+
+FATAL_TEST(enums, to_string_many) {
+  FATAL_EXPECT_EQ(
+    "state2,state0,,state3,state1,",
+    to_string_many(
+      std::vector<test_enum>{
+        test_enum::state2, test_enum::state0, static_cast<test_enum>(-1),
+        test_enum::state3, test_enum::state1
+      },
+      ','
+    )
+  );
+
+  FATAL_EXPECT_EQ(
+    "field10\nfield\n?\nfield2\n",
+    to_string_many(
+      std::vector<custom_enum>{
+        custom_enum::field10, custom_enum::field, static_cast<custom_enum>(1),
+        custom_enum::field2
+      },
+      '\n',
+      "?"
+    )
+  );
+
+  FATAL_EXPECT_EQ(
+    "d c b a - ",
+    to_string_many(
+      std::vector<signed_enum>{
+        signed_enum::d, signed_enum::c, signed_enum::b, signed_enum::a,
+        static_cast<signed_enum>(2)
+      },
+      ' ',
+      "-"
+    )
+  );
+
+  FATAL_EXPECT_EQ(
+    ",state1,,",
+    to_string_many(
+      std::vector<test_enum>{
+        static_cast<test_enum>(-1), test_enum::state1,
+        static_cast<test_enum>(99)
+      },
+      ',',
+      string_view()
+    )
+  );
+
+  FATAL_EXPECT_EQ("", to_string_many(std::vector<test_enum>{}, ','));
+  FATAL_EXPECT_EQ(
+    "?;?;",
+    to_string_many(
+      std::vector<empty_enum>{empty_enum(), empty_enum()}, ';', "?"
+    )
+  );
+}
+
+FATAL_TEST(enums, names_view) {
+  {
+    using traits = enum_traits<test_enum>;
+
+    FATAL_EXPECT_EQ(
+      string_view("state0"),
+      traits::names_view(test_enum::state0)
+    );
+    FATAL_EXPECT_EQ(
+      string_view("state1"),
+      traits::names_view(test_enum::state1)
+    );
+    FATAL_EXPECT_EQ(
+      string_view("state2"),
+      traits::names_view(test_enum::state2)
+    );
+    FATAL_EXPECT_EQ(
+      string_view("state3"),
+      traits::names_view(test_enum::state3)
+    );
+    FATAL_EXPECT_TRUE(traits::names_view(static_cast<test_enum>(1)).empty());
+    FATAL_EXPECT_EQ(
+      string_view("?"),
+      traits::names_view(static_cast<test_enum>(1), "?")
+    );
+  }
+
+  {
+    using traits = enum_traits<custom_enum>;
+    auto const field10 = traits::names_view(custom_enum::field10);
+    FATAL_EXPECT_EQ(string_view("field10"), field10);
+
+    // the name is null terminated //
+    FATAL_EXPECT_EQ('\0', field10.data()[field10.size()]);
+    FATAL_EXPECT_EQ(
+      traits::to_string(custom_enum::field10),
+      field10.data()
+    );
+  }
+
+  FATAL_EXPECT_EQ(
+    string_view("c"),
+    enum_traits<signed_enum>::names_view(signed_enum::c)
+  );
+  FATAL_EXPECT_EQ(
+    string_view("-"),
+    enum_traits<empty_enum>::names_view(empty_enum(), "-")
+  );
+
+  using names = enum_names_array<big_enum>;
+  using values = enum_values_array<big_enum>;
+  for (std::size_t i = 0; i < values::size::value; ++i) {
+    FATAL_EXPECT_EQ(
+      names::data[i],
+      enum_traits<big_enum>::names_view(values::data[i])
+    );
+  }
+}
+
+FATAL_TEST(enums, append_to) {
+  {
+    using traits = enum_traits<custom_enum>;
+    std::string out("x=");
+    FATAL_EXPECT_EQ(&out, &traits::append_to(out, custom_enum::field10));
+    FATAL_EXPECT_EQ("x=field10", out);
+    traits::append_to(out, static_cast<custom_enum>(1));
+    FATAL_EXPECT_EQ("x=field10", out);
+    traits::append_to(out, static_cast<custom_enum>(1), "?");
+    FATAL_EXPECT_EQ("x=field10?", out);
+    traits::append_to(out, custom_enum::field);
+    FATAL_EXPECT_EQ("x=field10?field", out);
+  }
+
+  {
+    using traits = enum_traits<test_enum>;
+    rope<> out;
+    traits::append_to(out, test_enum::state3);
+    out.push_back(',');
+    traits::append_to(out, static_cast<test_enum>(-1), "none");
+    out.push_back(',');
+    traits::append_to(out, test_enum::state0);
+    FATAL_EXPECT_EQ("state3,none,state0", out.to_string());
+
+    // the names are referenced, not copied //
+    FATAL_EXPECT_TRUE(
+      traits::names_view(test_enum::state3).data() == out.piece(0).data()
+    );
+  }
+
+  std::string empty;
+  enum_traits<empty_enum>::append_to(empty, empty_enum(), "-");
+  FATAL_EXPECT_EQ("-", empty);
+}
+
+FATAL_TEST(enums, append_to_buffer) {
+  using traits = enum_traits<custom_enum>;
+
+  // the name is copied as a whole `max_name_size`, so only what's before
+  // the returned pointer is meaningful //
+  std::string buffer(3 * traits::max_name_size::value + 1, '*');
+  auto out = &buffer[0];
+  out = traits::append_to(out, custom_enum::field);
+  out = traits::append_to(out, static_cast<custom_enum>(1), "?");
+  out = traits::append_to(out, custom_enum::field10);
+  out = traits::append_to(out, static_cast<custom_enum>(1));
+  FATAL_EXPECT_EQ("field?field10", std::string(&buffer[0], out));
+  FATAL_EXPECT_EQ('*', buffer.back());
+
+  char array[enum_traits<signed_enum>::max_name_size::value];
+  auto const last = enum_traits<signed_enum>::append_to(array, signed_enum::d);
+  FATAL_EXPECT_EQ("d", std::string(array, last));
+
+  using names = enum_names_array<big_enum>;
+  using values = enum_values_array<big_enum>;
+  std::string big(enum_traits<big_enum>::max_name_size::value, '\0');
+  for (std::size_t i = 0; i < values::size::value; ++i) {
+    auto const end = enum_traits<big_enum>::append_to(
+      &big[0], values::data[i]
+    );
+    FATAL_EXPECT_EQ(names::data[i], std::string(&big[0], end));
+  }
+
+  char none = '*';
+  FATAL_EXPECT_TRUE(
+    &none == enum_traits<empty_enum>::append_to(&none, empty_enum())
+  );
+  FATAL_EXPECT_EQ('*', none);
+}
+
+FATAL_TEST(enums, names_blob) {
+  {
+    using traits = enum_traits<test_enum>;
+    char const expected[] = "state0\0state2\0state3\0state1";
+    FATAL_EXPECT_EQ(
+      string_view(expected, sizeof(expected)),
+      traits::names_blob()
+    );
+
+    auto const offsets = traits::names_offsets();
+    std::vector<std::size_t> const actual(offsets, offsets + 5);
+    FATAL_EXPECT_EQ((std::vector<std::size_t>{0, 7, 14, 21, 28}), actual);
+  }
+
+  {
+    using traits = enum_traits<custom_enum>;
+    char const expected[] = "field\0field2\0field10";
+    FATAL_EXPECT_EQ(
+      string_view(expected, sizeof(expected)),
+      traits::names_blob()
+    );
+  }
+
+  FATAL_EXPECT_TRUE(enum_traits<empty_enum>::names_blob().empty());
+  FATAL_EXPECT_EQ(0, enum_traits<empty_enum>::names_offsets()[0]);
+}
+
+FATAL_TEST(enums, finder) {
+  FATAL_EXPECT_SAME<trie_finder<>, enum_traits<test_enum>::finder>();
+  FATAL_EXPECT_SAME<trie_finder<>, enum_traits<custom_enum>::finder>();
+  FATAL_EXPECT_SAME<
+    perfect_hash_finder,
+    enum_traits<hashed_enum>::finder
+  >();
+
+  using traits = enum_traits<hashed_enum>;
+  using e = hashed_enum;
+
+  FATAL_EXPECT_EQ(e::hashed0, traits::parse(std::string("hashed0")));
+  FATAL_EXPECT_EQ(e::hashed1, traits::parse(std::string("hashed1")));
+  FATAL_EXPECT_EQ(e::hashed2, traits::parse(std::string("hashed2")));
+  FATAL_EXPECT_EQ(
+    e::hashed1,
+    traits::parse<trie_finder<>>(std::string("hashed1"))
+  );
+  FATAL_EXPECT_THROW(std::invalid_argument) {
+    traits::parse(std::string("hashed"));
+  };
+
+  e out = e::hashed0;
+  FATAL_EXPECT_TRUE(traits::try_parse(out, std::string("hashed2")));
+  FATAL_EXPECT_EQ(e::hashed2, out);
+  FATAL_EXPECT_FALSE(traits::try_parse(out, std::string("hashed3")));
+  FATAL_EXPECT_EQ(e::hashed2, out);
+
+  FATAL_EXPECT_EQ("hashed1", traits::to_string(e::hashed1));
+  FATAL_EXPECT_EQ(nullptr, traits::to_string(static_cast<e>(2)));
+}
+
 } // namespace fatal {
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2016, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/perfect_hash.h>
+
+#include <fatal/type/array.h>
+#include <fatal/type/convert.h>
+#include <fatal/type/get_type.h>
+#include <fatal/type/list.h>
+#include <fatal/type/sequence.h>
+#include <fatal/type/transform.h>
+#include <fatal/type/trie.h>
+
+#include <fatal/test/driver.h>
+#include <fatal/test/words.h>
+
+#include <string>
+
+namespace fatal {
+
+FATAL_S(h, "h");
+FATAL_S(ha, "ha");
+FATAL_S(hat, "hat");
+FATAL_S(hi, "hi");
+FATAL_S(hit, "hit");
+FATAL_S(hint, "hint");
+FATAL_S(ho, "ho");
+FATAL_S(hot, "hot");
+FATAL_S(nil, "");
+FATAL_S(content_type, "content-type");
+FATAL_S(content_length, "content-length");
+
+using hs = list<h, ha, hat, hi, hint, hit, ho, hot, nil>;
+
+template <typename T>
+struct wrapper {
+  using value = T;
+};
+
+template <typename Filter>
+struct check_visitor {
+  template <typename Match>
+  void operator ()(
+    tag<Match>,
+    std::string const &needle,
+    std::size_t &matches
+  ) const {
+    using actual = typename Filter::template apply<Match>;
+    FATAL_EXPECT_EQ((to_instance<std::string, actual>()), needle);
+    ++matches;
+  }
+};
+
+template <typename T, typename Filter = get_identity>
+void check_perfect_hash_find(bool expected, std::string const &needle) {
+  std::size_t matches = 0;
+  FATAL_EXPECT_EQ(
+    expected,
+    (perfect_hash_find<T, Filter>(
+      needle.begin(), needle.end(), check_visitor<Filter>(), needle, matches
+    ))
+  );
+  FATAL_EXPECT_EQ(expected, matches);
+
+  matches = 0;
+  FATAL_EXPECT_EQ(
+    expected,
+    (perfect_hash_find<T, Filter>(
+      needle.data(),
+      needle.data() + needle.size(),
+      check_visitor<Filter>(),
+      needle,
+      matches
+    ))
+  );
+  FATAL_EXPECT_EQ(expected, matches);
+}
+
+FATAL_TEST(perfect_hash_find, empty) {
+  check_perfect_hash_find<list<>>(false, "");
+  check_perfect_hash_find<list<>>(false, "h");
+}
+
+FATAL_TEST(perfect_hash_find, find) {
+  check_perfect_hash_find<hs>(true, "");
+  check_perfect_hash_find<hs>(true, "h");
+  check_perfect_hash_find<hs>(true, "ha");
+  check_perfect_hash_find<hs>(true, "hat");
+  check_perfect_hash_find<hs>(true, "hi");
+  check_perfect_hash_find<hs>(true, "hint");
+  check_perfect_hash_find<hs>(true, "hit");
+  check_perfect_hash_find<hs>(true, "ho");
+  check_perfect_hash_find<hs>(true, "hot");
+  check_perfect_hash_find<hs>(false, "H");
+  check_perfect_hash_find<hs>(false, "hA");
+  check_perfect_hash_find<hs>(false, "hut");
+  check_perfect_hash_find<hs>(false, "hints");
+  check_perfect_hash_find<hs>(false, "content-type");
+
+  using headers = list<content_type, content_length>;
+  check_perfect_hash_find<headers>(true, "content-type");
+  check_perfect_hash_find<headers>(true, "content-length");
+  check_perfect_hash_find<headers>(false, "content-lengtx");
+  check_perfect_hash_find<headers>(false, "content-typ");
+  check_perfect_hash_find<headers>(false, "");
+}
+
+FATAL_TEST(perfect_hash_find, filter) {
+  using wrapped = transform<hs, applier<wrapper>>;
+  check_perfect_hash_find<wrapped, get_type::value>(true, "hat");
+  check_perfect_hash_find<wrapped, get_type::value>(true, "");
+  check_perfect_hash_find<wrapped, get_type::value>(false, "hut");
+}
+
+FATAL_TEST(perfect_hash_find, comparer) {
+  for (auto const needle: {"", "h", "hat", "hint", "hot", "H", "hut", "hin"}) {
+    std::string const s(needle);
+    auto const expected = trie_find<hs, get_identity, greater>(
+      s.begin(), s.end()
+    );
+
+    FATAL_EXPECT_EQ(
+      expected,
+      (perfect_hash_find<hs, get_identity, greater>(s.begin(), s.end()))
+    );
+    FATAL_EXPECT_EQ(expected, perfect_hash_find<hs>(s.begin(), s.end()));
+  }
+}
+
+struct words_visitor {
+  template <typename Match>
+  void operator ()(tag<Match>, std::size_t &matches) const { ++matches; }
+};
+
+FATAL_TEST(perfect_hash_find, words) {
+  using words = random_250_words<list, sequence>;
+  using array = z_array<words, char const *>;
+
+  std::size_t matches = 0;
+  for (auto const word: array::data) {
+    std::string const s(word);
+    FATAL_EXPECT_TRUE(
+      perfect_hash_find<words>(s.begin(), s.end(), words_visitor(), matches)
+    );
+    FATAL_EXPECT_TRUE(
+      perfect_hash_find<words>(
+        word, word + s.size(), words_visitor(), matches
+      )
+    );
+
+    auto const upper = s + "!";
+    FATAL_EXPECT_FALSE(
+      perfect_hash_find<words>(
+        upper.begin(), upper.end(), words_visitor(), matches
+      )
+    );
+  }
+
+  FATAL_EXPECT_EQ(2 * size<words>::value, matches);
+}
+
+} // namespace fatal {
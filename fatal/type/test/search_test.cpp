@@ -1,6 +1,8 @@
 #include <fatal/type/search.h>
 
 #include <fatal/type/list.h>
+#include <fatal/type/reverse.h>
+#include <fatal/type/sequence.h>
 
 #include <fatal/test/driver.h>
 
@@ -38,6 +40,85 @@ FATAL_TEST(sorted_search, list) {
   FATAL_EXPECT_FALSE(sorted_search<h>(60, value_search_visitor<60, 5>()));
 }
 
+FATAL_TEST(eytzinger_search, empty) {
+  using h = index_list<>;
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(10, value_search_visitor<10, 0>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(20, value_search_visitor<20, 1>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(30, value_search_visitor<30, 2>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(40, value_search_visitor<40, 3>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(50, value_search_visitor<50, 4>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(60, value_search_visitor<60, 5>()));
+}
+
+FATAL_TEST(eytzinger_search, list) {
+  using h = index_list<10, 20, 30, 40, 50>;
+  FATAL_EXPECT_TRUE(eytzinger_search<h>(10, value_search_visitor<10, 0>()));
+  FATAL_EXPECT_TRUE(eytzinger_search<h>(20, value_search_visitor<20, 1>()));
+  FATAL_EXPECT_TRUE(eytzinger_search<h>(30, value_search_visitor<30, 2>()));
+  FATAL_EXPECT_TRUE(eytzinger_search<h>(40, value_search_visitor<40, 3>()));
+  FATAL_EXPECT_TRUE(eytzinger_search<h>(50, value_search_visitor<50, 4>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(60, value_search_visitor<60, 5>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(5, value_search_visitor<5, 0>()));
+  FATAL_EXPECT_FALSE(eytzinger_search<h>(25, value_search_visitor<25, 2>()));
+}
+
+template <typename> struct odd_values;
+
+template <std::size_t... Values>
+struct odd_values<index_sequence<Values...>> {
+  using type = list<size_constant<Values * 2 + 1>...>;
+};
+
+struct large_search_visitor {
+  template <std::size_t Value, std::size_t Index>
+  void operator ()(
+    indexed<size_constant<Value>, Index>,
+    std::size_t &out
+  ) const {
+    FATAL_EXPECT_EQ(Value, Index * 2 + 1);
+    out = Value;
+  }
+};
+
+template <typename T, typename Policy = search_policy<>>
+void check_large_search() {
+  for (std::size_t needle = 0; needle <= size<T>::value * 2 + 1; ++needle) {
+    std::size_t out = 0;
+    bool const odd = needle & 1 && needle < size<T>::value * 2;
+    FATAL_EXPECT_EQ(
+      odd,
+      (scalar_search<T, get_identity, value_comparer, Policy>(
+        needle, large_search_visitor(), out
+      ))
+    );
+    FATAL_EXPECT_EQ(odd ? needle : 0, out);
+
+    if (odd) {
+      out = 0;
+      FATAL_EXPECT_TRUE(
+        eytzinger_search<sort<T>>(needle, large_search_visitor(), out)
+      );
+      FATAL_EXPECT_EQ(needle, out);
+    }
+  }
+}
+
+FATAL_TEST(eytzinger_search, large) {
+  using h = odd_values<make_index_sequence<300>>::type;
+  check_large_search<h>();
+  check_large_search<reverse<h>>();
+  check_large_search<odd_values<make_index_sequence<257>>::type>();
+
+  // no jump tables: the odd values are dense enough for one //
+  check_large_search<h, search_policy<0>>();
+  check_large_search<reverse<h>, search_policy<0>>();
+
+  // linear scans over a whole cache line, or ending with a partial chunk //
+  using p = search_policy<0>;
+  check_large_search<odd_values<make_index_sequence<8>>::type, p>();
+  check_large_search<odd_values<make_index_sequence<5>>::type, p>();
+}
+
 FATAL_TEST(scalar_search, empty) {
   using h = index_list<>;
   FATAL_EXPECT_FALSE(scalar_search<h>(10, value_search_visitor<10, 0>()));
@@ -58,6 +139,149 @@ FATAL_TEST(scalar_search, list) {
   FATAL_EXPECT_FALSE(scalar_search<h>(60, value_search_visitor<60, 5>()));
 }
 
+template <int Value, std::size_t Index>
+using int_search_visitor = search_visitor<
+  std::integral_constant<int, Value>, Index
+>;
+
+template <int... Values>
+using int_list = list<std::integral_constant<int, Values>...>;
+
+FATAL_TEST(scalar_search, dense) {
+  using h = int_list<2, -1, 0, -3, 1, 4>;
+  FATAL_EXPECT_FALSE(scalar_search<h>(-4, int_search_visitor<-4, 0>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(-3, int_search_visitor<-3, 0>()));
+  FATAL_EXPECT_FALSE(scalar_search<h>(-2, int_search_visitor<-2, 1>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(-1, int_search_visitor<-1, 1>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(0, int_search_visitor<0, 2>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(1, int_search_visitor<1, 3>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(2, int_search_visitor<2, 4>()));
+  FATAL_EXPECT_FALSE(scalar_search<h>(3, int_search_visitor<3, 5>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(4, int_search_visitor<4, 5>()));
+  FATAL_EXPECT_FALSE(scalar_search<h>(5, int_search_visitor<5, 6>()));
+
+  using m = value_comparer;
+  using p = search_policy<100, 256, 0>;
+  FATAL_EXPECT_TRUE((scalar_search<h, get_identity, m, p>(-3)));
+  FATAL_EXPECT_FALSE((scalar_search<h, get_identity, m, p>(-2)));
+  FATAL_EXPECT_TRUE((scalar_search<h, get_identity, m, p>(4)));
+  FATAL_EXPECT_FALSE((scalar_search<h, get_identity, m, p>(5)));
+
+  // jump table rather than a linear scan //
+  using j = search_policy<50, 256, 0>;
+  FATAL_EXPECT_TRUE((
+    scalar_search<h, get_identity, m, j>(-3, int_search_visitor<-3, 0>())
+  ));
+  FATAL_EXPECT_FALSE((
+    scalar_search<h, get_identity, m, j>(-2, int_search_visitor<-2, 1>())
+  ));
+  FATAL_EXPECT_TRUE((
+    scalar_search<h, get_identity, m, j>(1, int_search_visitor<1, 3>())
+  ));
+  FATAL_EXPECT_TRUE((
+    scalar_search<h, get_identity, m, j>(4, int_search_visitor<4, 5>())
+  ));
+  FATAL_EXPECT_FALSE((
+    scalar_search<h, get_identity, m, j>(5, int_search_visitor<5, 6>())
+  ));
+}
+
+template <typename T, T... Values>
+using typed_list = list<std::integral_constant<T, Values>...>;
+
+// odd values of type `T`, out of order //
+template <typename T, typename Policy>
+void check_linear_search() {
+  using h = typed_list<T, 9, 7, 5, 3, 1>;
+  using m = value_comparer;
+
+  for (int needle = 0; needle <= 10; ++needle) {
+    std::size_t out = ~std::size_t(0);
+    bool const odd = needle & 1;
+    FATAL_EXPECT_EQ(
+      odd,
+      (scalar_search<h, get_identity, m, Policy>(
+        static_cast<T>(needle),
+        [&out](auto indexed, std::size_t &result) {
+          using type = decltype(indexed);
+          FATAL_EXPECT_EQ(
+            type::value * 2 + 1,
+            static_cast<std::size_t>(type::type::value)
+          );
+          FATAL_EXPECT_SAME<T, typename type::type::value_type>();
+          result = type::value;
+        },
+        out
+      ))
+    );
+    FATAL_EXPECT_EQ(odd ? std::size_t(needle / 2) : ~std::size_t(0), out);
+  }
+}
+
+FATAL_TEST(scalar_search, linear) {
+  // the values are dense enough for a jump table //
+  using p = search_policy<0>;
+  check_linear_search<std::int8_t, p>();
+  check_linear_search<std::uint8_t, p>();
+  check_linear_search<std::int16_t, p>();
+  check_linear_search<std::uint16_t, p>();
+  check_linear_search<std::int32_t, p>();
+  check_linear_search<std::uint32_t, p>();
+  check_linear_search<std::int64_t, p>();
+  check_linear_search<std::uint64_t, p>();
+
+  // not a linear scan //
+  check_linear_search<std::uint32_t, search_policy<0, 256, 0>>();
+
+  using h = int_list<-1000000, -1, 0, 1, 1000000>;
+  using m = value_comparer;
+  FATAL_EXPECT_TRUE(
+    scalar_search<h>(-1000000, int_search_visitor<-1000000, 0>())
+  );
+  FATAL_EXPECT_TRUE(scalar_search<h>(-1, int_search_visitor<-1, 1>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(0, int_search_visitor<0, 2>()));
+  FATAL_EXPECT_TRUE(
+    scalar_search<h>(1000000, int_search_visitor<1000000, 4>())
+  );
+  FATAL_EXPECT_FALSE(scalar_search<h>(-2, int_search_visitor<-2, 0>()));
+  FATAL_EXPECT_TRUE(
+    (scalar_search<h, get_identity, m, search_policy<0, 256, 4>>(-1))
+  );
+}
+
+enum class search_enum: unsigned char { a = 3, b, c, d = 255 };
+
+template <search_enum Value, std::size_t Index>
+using enum_search_visitor = search_visitor<
+  std::integral_constant<search_enum, Value>, Index
+>;
+
+FATAL_TEST(scalar_search, dense_enum) {
+  using e = search_enum;
+  using h = list<
+    std::integral_constant<e, e::c>,
+    std::integral_constant<e, e::a>,
+    std::integral_constant<e, e::b>
+  >;
+  FATAL_EXPECT_TRUE(scalar_search<h>(e::a, enum_search_visitor<e::a, 0>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(e::b, enum_search_visitor<e::b, 1>()));
+  FATAL_EXPECT_TRUE(scalar_search<h>(e::c, enum_search_visitor<e::c, 2>()));
+  FATAL_EXPECT_FALSE(scalar_search<h>(e::d, enum_search_visitor<e::d, 3>()));
+  FATAL_EXPECT_FALSE(scalar_search<h>(e(0), enum_search_visitor<e(0), 0>()));
+  FATAL_EXPECT_FALSE(scalar_search<h>(e(6), enum_search_visitor<e(6), 0>()));
+
+  // not dense enough: 4 values over a range of 253 //
+  using s = list<
+    std::integral_constant<e, e::d>,
+    std::integral_constant<e, e::a>,
+    std::integral_constant<e, e::c>,
+    std::integral_constant<e, e::b>
+  >;
+  FATAL_EXPECT_TRUE(scalar_search<s>(e::a, enum_search_visitor<e::a, 0>()));
+  FATAL_EXPECT_TRUE(scalar_search<s>(e::d, enum_search_visitor<e::d, 3>()));
+  FATAL_EXPECT_FALSE(scalar_search<s>(e(6), enum_search_visitor<e(6), 0>()));
+}
+
 FATAL_TEST(index_search, empty) {
   using h = list<>;
   FATAL_EXPECT_FALSE(index_search<h>(0, search_visitor<void, 0>()));
@@ -78,4 +302,13 @@ FATAL_TEST(index_search, list) {
   FATAL_EXPECT_FALSE(index_search<h>(5, search_visitor<void *, 5>()));
 }
 
+FATAL_TEST(index_search, no_jump_table) {
+  using h = list<void, bool, double, int, unsigned>;
+  using p = search_policy<0>;
+  FATAL_EXPECT_TRUE((index_search<h, p>(0, search_visitor<void, 0>())));
+  FATAL_EXPECT_TRUE((index_search<h, p>(2, search_visitor<double, 2>())));
+  FATAL_EXPECT_TRUE((index_search<h, p>(4, search_visitor<unsigned, 4>())));
+  FATAL_EXPECT_FALSE((index_search<h, p>(5, search_visitor<void *, 5>())));
+}
+
 } // namespace fatal {
@@ -16,8 +16,11 @@
 #include <fatal/type/trie.h>
 
 #include <fatal/test/driver.h>
+#include <fatal/test/words.h>
 
+#include <string>
 #include <type_traits>
+#include <vector>
 
 namespace fatal {
 
@@ -318,4 +321,436 @@ FATAL_TEST(trie, find) {
   TEST_TRIE_FIND(false, lst::notfound, fld_tree);
 }
 
+FATAL_S(long_a, "content-type");
+FATAL_S(long_b, "content-length");
+FATAL_S(long_c, "content-encoding");
+FATAL_S(long_d, "x-forwarded-for-client-address");
+
+using long_tree = list<long_a, long_b, long_c, long_d>;
+
+template <typename Policy>
+void check_trie_find_long_edges() {
+  auto const check = [](bool expected, std::string const &needle) {
+    bool const actual = trie_find<long_tree, get_identity, less, Policy>(
+      needle.data(), needle.data() + needle.size()
+    );
+    FATAL_EXPECT_EQ(expected, actual);
+
+    // non-pointer iterators always compare one character at a time
+    FATAL_EXPECT_EQ(
+      expected,
+      (trie_find<long_tree, get_identity, less, Policy>(
+        needle.begin(), needle.end()
+      ))
+    );
+  };
+
+  check(true, "content-type");
+  check(true, "content-length");
+  check(true, "content-encoding");
+  check(true, "x-forwarded-for-client-address");
+
+  check(false, "");
+  check(false, "content-");
+  check(false, "content-typ");
+  check(false, "content-typE");
+  check(false, "content-lengtx");
+  check(false, "content-encodinG");
+  check(false, "Content-encoding");
+  check(false, "content-encoding-");
+  check(false, "x-forwarded-for-client-addresx");
+  check(false, "x-forwarded-for-cliEnt-address");
+  check(false, "X-forwarded-for-client-address");
+  check(false, "x-forwarded-for-client-addres");
+
+  // the needle ends exactly where a word read would have overrun it
+  std::string const buffer("x-forwarded-for-client-address");
+  for (auto i = buffer.size(); i--; ) {
+    FATAL_EXPECT_FALSE(
+      (trie_find<long_tree, get_identity, less, Policy>(
+        buffer.data(), buffer.data() + i
+      ))
+    );
+  }
+}
+
+FATAL_TEST(trie, find_long_edges) {
+  check_trie_find_long_edges<trie_policy<true>>();
+  check_trie_find_long_edges<trie_policy<false>>();
+}
+
+template <typename Filter>
+struct trie_find_longest_prefix_visitor {
+  template <typename Match>
+  void operator ()(
+    tag<Match>,
+    std::size_t consumed,
+    std::string &out,
+    std::size_t &out_consumed
+  ) const {
+    using actual = typename Filter::template apply<Match>;
+    FATAL_EXPECT_EQ(size<actual>::value, consumed);
+    FATAL_EXPECT_TRUE(out.empty());
+    out = to_instance<std::string, actual>();
+    out_consumed = consumed;
+  }
+};
+
+template <typename Tree, typename Filter = get_identity>
+void check_trie_find_longest_prefix(
+  std::string const &needle,
+  char const *expected
+) {
+  trie_find_longest_prefix_visitor<Filter> visitor;
+
+  for (auto pointer: {false, true}) {
+    std::string actual;
+    std::size_t consumed = 0;
+    bool const result = pointer
+      ? trie_find_longest_prefix<Tree, Filter>(
+        needle.data(), needle.data() + needle.size(), visitor, actual, consumed
+      )
+      : trie_find_longest_prefix<Tree, Filter>(
+        needle.begin(), needle.end(), visitor, actual, consumed
+      );
+
+    FATAL_EXPECT_EQ(expected != nullptr, result);
+    FATAL_EXPECT_EQ(expected ? expected : "", actual);
+    FATAL_EXPECT_EQ(actual.size(), consumed);
+  }
+}
+
+FATAL_TEST(trie, find_longest_prefix) {
+  check_trie_find_longest_prefix<list<>>("", nullptr);
+  check_trie_find_longest_prefix<list<>>("fat", nullptr);
+
+  check_trie_find_longest_prefix<list<seq::empty>>("", "");
+  check_trie_find_longest_prefix<list<seq::empty>>("fat", "");
+
+  check_trie_find_longest_prefix<list<seq::fat>>("", nullptr);
+  check_trie_find_longest_prefix<list<seq::fat>>("fa", nullptr);
+  check_trie_find_longest_prefix<list<seq::fat>>("fat", "fat");
+  check_trie_find_longest_prefix<list<seq::fat>>("fatal", "fat");
+  check_trie_find_longest_prefix<list<seq::fat>>("fit", nullptr);
+
+  using with_empty = list<seq::empty, seq::fat, seq::x>;
+  check_trie_find_longest_prefix<with_empty>("", "");
+  check_trie_find_longest_prefix<with_empty>("fa", "");
+  check_trie_find_longest_prefix<with_empty>("fatal", "fat");
+  check_trie_find_longest_prefix<with_empty>("xfat", "x");
+
+  check_trie_find_longest_prefix<hs_tree>("", nullptr);
+  check_trie_find_longest_prefix<hs_tree>("x", nullptr);
+  check_trie_find_longest_prefix<hs_tree>("h", "h");
+  check_trie_find_longest_prefix<hs_tree>("hx", "h");
+  check_trie_find_longest_prefix<hs_tree>("hin", "hi");
+  check_trie_find_longest_prefix<hs_tree>("hint", "hint");
+  check_trie_find_longest_prefix<hs_tree>("hinting", "hint");
+  check_trie_find_longest_prefix<hs_tree>("hits", "hit");
+  check_trie_find_longest_prefix<hs_tree>("hot dog", "hot");
+
+  check_trie_find_longest_prefix<fld_tree>("field", "field");
+  check_trie_find_longest_prefix<fld_tree>("field1", "field");
+  check_trie_find_longest_prefix<fld_tree>("field10", "field10");
+  check_trie_find_longest_prefix<fld_tree>("field100", "field10");
+  check_trie_find_longest_prefix<fld_tree>("field20", "field2");
+  check_trie_find_longest_prefix<fld_tree>("fiel", nullptr);
+
+  check_trie_find_longest_prefix<seq::shuffled>("fartherest", "farther");
+  check_trie_find_longest_prefix<seq::shuffled>("farthest", "fart");
+  check_trie_find_longest_prefix<seq::shuffled>("fastes", "fast");
+  check_trie_find_longest_prefix<seq::shuffled>("fastest!", "fastest");
+  check_trie_find_longest_prefix<seq::shuffled>("grooves", "groove");
+  check_trie_find_longest_prefix<seq::shuffled>("gro", nullptr);
+  check_trie_find_longest_prefix<
+    transform<seq::shuffled, applier<wrapper>>,
+    get_type::value
+  >("fartherest", "farther");
+
+  check_trie_find_longest_prefix<long_tree>(
+    "content-type: text/html", "content-type"
+  );
+  check_trie_find_longest_prefix<long_tree>("content-typ", nullptr);
+  check_trie_find_longest_prefix<long_tree>(
+    "x-forwarded-for-client-address: ::1", "x-forwarded-for-client-address"
+  );
+}
+
+template <typename Filter>
+struct trie_find_batch_visitor {
+  template <typename Match>
+  void operator ()(tag<Match>, std::string &out) const {
+    out = to_instance<std::string, typename Filter::template apply<Match>>();
+  }
+
+  template <typename Match>
+  void operator ()(
+    tag<Match>,
+    std::size_t index,
+    std::vector<std::string> &out
+  ) const {
+    FATAL_EXPECT_TRUE(out[index].empty());
+    out[index] = to_instance<
+      std::string,
+      typename Filter::template apply<Match>
+    >();
+  }
+};
+
+template <
+  typename Tree,
+  typename Filter,
+  typename Policy,
+  typename Comparer = less
+>
+void check_trie_find_batch(std::vector<std::string> const &needles) {
+  trie_find_batch_visitor<Filter> visitor;
+
+  std::vector<std::string> expected(needles.size());
+  std::size_t expected_matches = 0;
+  for (std::size_t i = 0; i < needles.size(); ++i) {
+    expected_matches += trie_find<Tree, Filter, Comparer>(
+      needles[i].begin(), needles[i].end(), visitor, expected[i]
+    );
+  }
+
+  std::vector<std::string> actual(needles.size());
+  auto const matches = trie_find_batch<Tree, Filter, Comparer, Policy>(
+    needles.begin(), needles.end(), visitor, actual
+  );
+
+  FATAL_EXPECT_EQ(expected_matches, matches);
+  FATAL_EXPECT_EQ(expected, actual);
+  FATAL_EXPECT_EQ(
+    matches,
+    (trie_find_batch<Tree, Filter, Comparer, Policy>(
+      needles.begin(), needles.end()
+    ))
+  );
+}
+
+template <typename Policy>
+void check_trie_find_batch_policy() {
+  std::vector<std::string> const needles{
+    "h", "ha", "hat", "hi", "hit", "hint", "ho", "hot",
+    "field", "field10", "field2",
+    "content-type", "content-length", "content-encoding",
+    "x-forwarded-for-client-address",
+    "gooey", "fast", "granite", "fastest", "fart", "far", "good", "great",
+    "grok", "faster", "green", "gold", "farther", "groove", "fat", "fist",
+    "", "x", "notfound", "hin", "hx", "fiel", "field1", "field100",
+    "content-", "content-typ", "content-types", "fa", "gr", "fistt", "h"
+  };
+
+  check_trie_find_batch<list<>, get_identity, Policy>(needles);
+  check_trie_find_batch<list<seq::empty>, get_identity, Policy>(needles);
+  check_trie_find_batch<list<seq::fat>, get_identity, Policy>(needles);
+  check_trie_find_batch<list<seq::far, seq::x>, get_identity, Policy>(needles);
+  check_trie_find_batch<
+    list<seq::empty, seq::fat, seq::x>, get_identity, Policy
+  >(needles);
+  check_trie_find_batch<hs_tree, get_identity, Policy>(needles);
+  check_trie_find_batch<fld_tree, get_identity, Policy>(needles);
+  check_trie_find_batch<long_tree, get_identity, Policy>(needles);
+  check_trie_find_batch<seq::shuffled, get_identity, Policy>(needles);
+  check_trie_find_batch<
+    transform<seq::shuffled, applier<wrapper>>,
+    get_type::value,
+    Policy
+  >(needles);
+  check_trie_find_batch<hs_tree, get_identity, Policy>({});
+  check_trie_find_batch<hs_tree, get_identity, Policy>({"hint"});
+  check_trie_find_batch<hs_tree, get_identity, Policy, greater>(needles);
+  check_trie_find_batch<seq::shuffled, get_identity, Policy, greater>(needles);
+}
+
+FATAL_TEST(trie, find_batch) {
+  check_trie_find_batch_policy<trie_policy<>>();
+  check_trie_find_batch_policy<trie_policy<true, 0>>();
+  check_trie_find_batch_policy<trie_policy<true, 1>>();
+  check_trie_find_batch_policy<trie_policy<true, 64>>();
+  check_trie_find_batch_policy<trie_policy<true, 8, 2>>();
+}
+
+template <typename Tree, typename Filter, typename Policy>
+void check_trie_jump_table(std::vector<std::string> const &needles) {
+  for (auto const &needle: needles) {
+    trie_find_batch_visitor<Filter> visitor;
+
+    std::string expected;
+    bool const found = trie_find<Tree, Filter>(
+      needle.begin(), needle.end(), visitor, expected
+    );
+
+    for (auto pointer: {false, true}) {
+      std::string actual;
+      FATAL_EXPECT_EQ(
+        found,
+        pointer
+          ? trie_find<Tree, Filter, less, Policy>(
+            needle.data(), needle.data() + needle.size(), visitor, actual
+          )
+          : trie_find<Tree, Filter, less, Policy>(
+            needle.begin(), needle.end(), visitor, actual
+          )
+      );
+      FATAL_EXPECT_EQ(expected, actual);
+    }
+
+    trie_find_longest_prefix_visitor<Filter> prefix_visitor;
+
+    std::string expected_prefix;
+    std::size_t expected_consumed = 0;
+    bool const prefixed = trie_find_longest_prefix<Tree, Filter>(
+      needle.begin(), needle.end(),
+      prefix_visitor, expected_prefix, expected_consumed
+    );
+
+    std::string actual_prefix;
+    std::size_t actual_consumed = 0;
+    FATAL_EXPECT_EQ(
+      prefixed,
+      (trie_find_longest_prefix<Tree, Filter, less, Policy>(
+        needle.data(), needle.data() + needle.size(),
+        prefix_visitor, actual_prefix, actual_consumed
+      ))
+    );
+    FATAL_EXPECT_EQ(expected_prefix, actual_prefix);
+    FATAL_EXPECT_EQ(expected_consumed, actual_consumed);
+  }
+}
+
+FATAL_TEST(trie, jump_table) {
+  using words = random_250_words<list, sequence>;
+  using array = z_array<words, char const *>;
+
+  std::vector<std::string> needles{
+    "", "x", "h", "hi", "hin", "hint", "hinting", "hx", "hot dog",
+    "fa", "fat", "fatal", "farther", "fartherest", "groove", "gro", "\xff"
+  };
+  for (std::size_t i = 0; i < array::size::value; ++i) {
+    std::string const word(array::data[i]);
+    needles.push_back(word);
+    needles.push_back(word + "s");
+    needles.push_back(word.substr(0, word.size() - 1));
+    needles.push_back(word.substr(0, word.size() - 1) + '~');
+  }
+
+  using wide = trie_policy<true, 8, 2>;
+  check_trie_jump_table<list<>, get_identity, wide>(needles);
+  check_trie_jump_table<list<seq::empty, seq::fat, seq::x>, get_identity, wide>(
+    needles
+  );
+  check_trie_jump_table<hs_tree, get_identity, wide>(needles);
+  check_trie_jump_table<seq::shuffled, get_identity, wide>(needles);
+  check_trie_jump_table<
+    transform<seq::shuffled, applier<wrapper>>,
+    get_type::value,
+    wide
+  >(needles);
+  check_trie_jump_table<words, get_identity, wide>(needles);
+  check_trie_jump_table<words, get_identity, trie_policy<false, 8, 16>>(
+    needles
+  );
+}
+
+// mimics the piece interface of `rope` //
+struct test_pieces {
+  std::size_t pieces() const { return data.size(); }
+  std::string const &piece(std::size_t i) const { return data[i]; }
+
+  std::vector<std::string> data;
+};
+
+template <typename Tree, typename Filter = get_identity>
+void check_trie_matcher(std::vector<std::string> const &needles) {
+  trie_find_batch_visitor<Filter> visitor;
+
+  for (auto const &needle: needles) {
+    std::string expected;
+    bool const found = trie_find<Tree, Filter>(
+      needle.begin(), needle.end(), visitor, expected
+    );
+
+    auto const check = [&](trie_matcher<Tree, Filter> const &matcher) {
+      std::string actual;
+      FATAL_EXPECT_EQ(found, matcher.finish(visitor, actual));
+      FATAL_EXPECT_EQ(expected, actual);
+      FATAL_EXPECT_EQ(found, matcher.finish());
+      if (found) {
+        FATAL_EXPECT_TRUE(matcher.alive());
+      }
+    };
+
+    // every way of splitting the needle in up to three pieces
+    for (std::size_t i = 0; i <= needle.size(); ++i) {
+      for (std::size_t j = i; j <= needle.size(); ++j) {
+        trie_matcher<Tree, Filter> matcher;
+        matcher.feed(needle.data(), needle.data() + i);
+        matcher.feed(needle.substr(i, j - i));
+        matcher.feed(needle.begin() + j, needle.end());
+        check(matcher);
+
+        test_pieces const pieces{{
+          needle.substr(0, i), needle.substr(i, j - i), needle.substr(j)
+        }};
+        matcher.reset();
+        auto const alive = matcher.feed_pieces(pieces);
+        FATAL_EXPECT_EQ(alive, matcher.alive());
+        check(matcher);
+      }
+    }
+
+    trie_matcher<Tree, Filter> matcher;
+    for (auto c: needle) {
+      matcher.feed(&c, &c + 1);
+    }
+    check(matcher);
+  }
+}
+
+FATAL_TEST(trie, matcher) {
+  std::vector<std::string> const needles{
+    "h", "ha", "hat", "hi", "hit", "hint", "ho", "hot",
+    "field", "field10", "field2",
+    "content-type", "content-length", "content-encoding",
+    "x-forwarded-for-client-address",
+    "gooey", "fast", "granite", "fastest", "fart", "far", "good", "great",
+    "grok", "faster", "green", "gold", "farther", "groove", "fat", "fist",
+    "", "x", "notfound", "hin", "hx", "fiel", "field1", "field100",
+    "content-", "content-typ", "content-types", "fa", "gr", "fistt"
+  };
+
+  check_trie_matcher<list<>>(needles);
+  check_trie_matcher<list<seq::empty>>(needles);
+  check_trie_matcher<list<seq::fat>>(needles);
+  check_trie_matcher<list<seq::far, seq::x>>(needles);
+  check_trie_matcher<list<seq::empty, seq::fat, seq::x>>(needles);
+  check_trie_matcher<hs_tree>(needles);
+  check_trie_matcher<fld_tree>(needles);
+  check_trie_matcher<long_tree>(needles);
+  check_trie_matcher<seq::shuffled>(needles);
+  check_trie_matcher<
+    transform<seq::shuffled, applier<wrapper>>,
+    get_type::value
+  >(needles);
+
+  trie_matcher<hs_tree> matcher;
+  FATAL_EXPECT_TRUE(matcher.alive());
+  FATAL_EXPECT_TRUE(matcher.feed(std::string("hi")));
+  FATAL_EXPECT_TRUE(matcher.finish());
+  FATAL_EXPECT_TRUE(matcher.feed(std::string("n")));
+  FATAL_EXPECT_FALSE(matcher.finish());
+  FATAL_EXPECT_TRUE(matcher.feed(std::string("t")));
+  FATAL_EXPECT_TRUE(matcher.finish());
+  FATAL_EXPECT_FALSE(matcher.feed(std::string("s")));
+  FATAL_EXPECT_FALSE(matcher.alive());
+  FATAL_EXPECT_FALSE(matcher.feed(std::string("t")));
+  FATAL_EXPECT_FALSE(matcher.finish());
+  matcher.reset();
+  FATAL_EXPECT_TRUE(matcher.alive());
+  FATAL_EXPECT_TRUE(matcher.feed(std::string("hot")));
+  FATAL_EXPECT_TRUE(matcher.finish());
+}
+
 } // namespace fatal {
@@ -9,18 +9,60 @@
 #pragma once
 
 #include <fatal/functional/no_op.h>
+#include <fatal/portability.h>
 #include <fatal/type/identity.h>
-#include <fatal/type/sort.h>
 
 #include <fatal/type/impl/trie.h>
 
+#include <iterator>
+#include <memory>
+
 namespace fatal {
 
+/**
+ * Tunes how `trie_find` evaluates the trie at runtime.
+ *
+ * `WordCompare`: when `true`, edges of at least 4 characters are compared
+ * a machine word at a time instead of one character at a time. This only
+ * applies to needles given as pointers to single byte characters, and never
+ * reads past the end of the needle. Other needles are always compared one
+ * character at a time.
+ *
+ * `JumpTableFanout`: nodes with at least this many children pick the child
+ * to descend into with a 256 entry jump table indexed by the next character,
+ * rather than with a binary search over the children. This only applies to
+ * single byte characters. Zero disables jump tables altogether.
+ *
+ * Binary searches inline into the lookup and do well on narrow nodes, while
+ * wide nodes, like the root of a large set of keywords, take several
+ * unpredictable branches before resolving a single character.
+ *
+ * Example:
+ *
+ *  // compares edges one character at a time
+ *  trie_find<my_strings, get_identity, less, trie_policy<false>>(
+ *    s.data(), s.data() + s.size()
+ *  );
+ */
+template <
+  bool WordCompare = true,
+  std::size_t BatchLookahead = 8,
+  std::size_t JumpTableFanout = 16
+>
+struct trie_policy {
+  using word_compare = std::integral_constant<bool, WordCompare>;
+  using batch_lookahead = std::integral_constant<std::size_t, BatchLookahead>;
+  using jump_table_fanout = std::integral_constant<
+    std::size_t, JumpTableFanout
+  >;
+};
+
 // TODO: INVERT COMPARER AND FILTER
 template <
   typename T,
   typename Filter = get_identity,
   typename Comparer = less,
+  typename Policy = trie_policy<>,
   typename Begin,
   typename End,
   typename Visitor,
@@ -33,7 +75,8 @@ static inline bool trie_find(
   VArgs &&...args
 ) {
   assert(begin <= end);
-  return i_t::e<Filter, sort<T, sequence_compare<Comparer>, Filter>>::type::f(
+  return i_t::e<Filter, typename i_t::Y<Filter, Comparer, T>::type>::type
+    ::template f<Policy>(
     static_cast<std::size_t>(std::distance(begin, end)),
     static_cast<Begin &&>(begin),
     static_cast<Visitor &&>(visitor),
@@ -45,15 +88,282 @@ template <
   typename T,
   typename Filter = get_identity,
   typename Comparer = less,
+  typename Policy = trie_policy<>,
   typename Begin,
   typename End
 >
 static inline bool trie_find(Begin &&begin, End &&end) {
-  return trie_find<T, Filter, Comparer>(
+  return trie_find<T, Filter, Comparer, Policy>(
     static_cast<Begin &&>(begin),
     static_cast<End &&>(end),
     fn::no_op()
   );
 }
 
+/**
+ * Looks up the longest string in the list of compile-time strings `T` that
+ * is a prefix of `[begin, end)`, walking the trie once. When found, calls
+ * `visitor(tag<String>(), consumed, args...)`, where `consumed` is the size
+ * of the matching string `String`, and returns `true`. Returns `false` when
+ * no string in `T` prefixes the input.
+ *
+ * This allows tokenizing input that hasn't been split at delimiters yet.
+ *
+ * Example:
+ *
+ *  FATAL_S(get, "GET");
+ *  FATAL_S(get_all, "GETALL");
+ *
+ *  std::string s("GET /index.html");
+ *
+ *  // returns `true` after calling `visitor(tag<get>(), 3)`
+ *  trie_find_longest_prefix<list<get, get_all>>(s.begin(), s.end(), visitor);
+ */
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Comparer = less,
+  typename Policy = trie_policy<>,
+  typename Begin,
+  typename End,
+  typename Visitor,
+  typename... VArgs
+>
+static inline bool trie_find_longest_prefix(
+  Begin &&begin,
+  End &&end,
+  Visitor &&visitor,
+  VArgs &&...args
+) {
+  assert(begin <= end);
+  return i_t::p<
+    typename i_t::e<Filter, typename i_t::Y<Filter, Comparer, T>::type>::type
+  >::type::template f<Policy>(
+    static_cast<std::size_t>(std::distance(begin, end)),
+    static_cast<Begin &&>(begin),
+    static_cast<Visitor &&>(visitor),
+    static_cast<VArgs &&>(args)...
+  );
+}
+
+/**
+ * Looks up every needle in the range `[begin, end)` in the list of
+ * compile-time strings `T`, in order. While looking up a needle, the one
+ * `Policy::batch_lookahead` positions ahead of it is prefetched so that, for
+ * large batches, the lookups don't stall waiting on the needles' memory.
+ *
+ * Each needle must be a contiguous range, like `std::string` or a string
+ * view. For every needle found, calls `visitor(tag<String>(), index, args...)`
+ * where `String` is the matching element of `T` and `index` is the position
+ * of the needle in the batch.
+ *
+ * Returns the number of needles found.
+ *
+ * Example:
+ *
+ *  FATAL_S(hello, "hello");
+ *  FATAL_S(world, "world");
+ *
+ *  std::vector<std::string> tokens{"world", "foo", "hello", "world"};
+ *
+ *  // returns `3` after calling `visitor(tag<world>(), 0)`,
+ *  // `visitor(tag<hello>(), 2)` and `visitor(tag<world>(), 3)`
+ *  trie_find_batch<list<hello, world>>(
+ *    tokens.begin(), tokens.end(), visitor
+ *  );
+ */
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Comparer = less,
+  typename Policy = trie_policy<>,
+  typename Iterator,
+  typename Visitor,
+  typename... VArgs
+>
+static inline std::size_t trie_find_batch(
+  Iterator begin,
+  Iterator const end,
+  Visitor &&visitor,
+  VArgs &&...args
+) {
+  auto ahead = begin;
+  for (
+    auto lookahead = Policy::batch_lookahead::value;
+    lookahead && ahead != end;
+    --lookahead
+  ) {
+    ++ahead;
+  }
+
+  std::size_t matches = 0;
+
+  for (std::size_t index = 0; begin != end; ++begin, ++index) {
+    if (ahead != end) {
+      if (std::begin(*ahead) != std::end(*ahead)) {
+        FATAL_PREFETCH(std::addressof(*std::begin(*ahead)));
+      }
+      ++ahead;
+    }
+
+    matches += trie_find<T, Filter, Comparer, Policy>(
+      std::begin(*begin),
+      std::end(*begin),
+      visitor,
+      index,
+      args...
+    );
+  }
+
+  return matches;
+}
+
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Comparer = less,
+  typename Policy = trie_policy<>,
+  typename Iterator
+>
+static inline std::size_t trie_find_batch(Iterator begin, Iterator end) {
+  return trie_find_batch<T, Filter, Comparer, Policy>(
+    std::move(begin),
+    std::move(end),
+    fn::no_op()
+  );
+}
+
+/**
+ * A resumable trie lookup, for input that comes in pieces.
+ *
+ * The input is given through successive calls to `feed()`, which keeps the
+ * position in the trie between calls, so that the pieces don't need to be
+ * joined into a contiguous buffer first. Calling `finish()` then tells
+ * whether the whole input is one of the strings in `T`.
+ *
+ * `T`, `Filter` and `Comparer` are the same as in `trie_find`. The input is
+ * matched as a sequence of `char`.
+ *
+ * Example:
+ *
+ *  FATAL_S(hello, "hello");
+ *  FATAL_S(world, "world");
+ *
+ *  trie_matcher<list<hello, world>> matcher;
+ *
+ *  matcher.feed(std::string("wor"));
+ *  matcher.feed(std::string("ld"));
+ *
+ *  // returns `true` after calling `visitor(tag<world>())`
+ *  matcher.finish(visitor);
+ */
+template <
+  typename T,
+  typename Filter = get_identity,
+  typename Comparer = less
+>
+class trie_matcher {
+  using impl = i_t::M<
+    typename i_t::X<
+      typename i_t::e<
+        Filter,
+        typename i_t::Y<Filter, Comparer, T>::type
+      >::type
+    >::type
+  >;
+
+public:
+  /**
+   * Consumes the piece of input `[begin, end)`.
+   *
+   * Returns `true` if the input so far is the prefix of some string in `T`,
+   * or `false` if no string can match anymore, in which case further input
+   * is ignored.
+   */
+  template <typename Iterator>
+  bool feed(Iterator begin, Iterator end) {
+    impl::f(node_, offset_, std::move(begin), std::move(end));
+    return alive();
+  }
+
+  /**
+   * Consumes the piece of input `range`, which can be anything accepted by
+   * `std::begin()` and `std::end()`, like a `std::string` or a string view.
+   */
+  template <typename Range>
+  bool feed(Range const &range) {
+    return feed(std::begin(range), std::end(range));
+  }
+
+  /**
+   * Consumes every piece of `pieces`, in order. This works with anything
+   * exposing the same piece interface as `rope`: `pieces()` and `piece(i)`.
+   *
+   * Example:
+   *
+   *  rope<> r("wor", std::string("ld"));
+   *
+   *  matcher.feed_pieces(r);
+   */
+  template <typename Pieces>
+  bool feed_pieces(Pieces const &pieces) {
+    for (decltype(pieces.pieces()) i = 0; alive() && i < pieces.pieces(); ++i) {
+      feed(pieces.piece(i));
+    }
+
+    return alive();
+  }
+
+  /**
+   * Tells whether the input consumed so far is the prefix of some string in
+   * `T`.
+   */
+  bool alive() const { return node_ != impl::dead::value; }
+
+  /**
+   * When the input consumed so far is one of the strings in `T`, calls
+   * `visitor(tag<String>(), args...)` for the matching `String` and returns
+   * `true`. Returns `false` otherwise.
+   *
+   * The matcher is left untouched, so more input can still be given.
+   */
+  template <typename Visitor, typename... VArgs>
+  bool finish(Visitor &&visitor, VArgs &&...args) const {
+    return impl::d(node_, offset_, visitor, args...);
+  }
+
+  /**
+   * Tells whether the input consumed so far is one of the strings in `T`.
+   */
+  bool finish() const { return finish(fn::no_op()); }
+
+  /**
+   * Discards the input consumed so far, so that the matcher can be reused.
+   */
+  void reset() {
+    node_ = 0;
+    offset_ = 0;
+  }
+
+private:
+  std::size_t node_ = 0;
+  std::size_t offset_ = 0;
+};
+
+/**
+ * Exposes `trie_find` as a lookup backend for interfaces that let the
+ * caller choose one, like `enum_traits::parse`.
+ *
+ * See also `perfect_hash_finder`.
+ */
+template <typename Comparer = less, typename Policy = trie_policy<>>
+struct trie_finder {
+  template <typename T, typename Filter = get_identity, typename... Args>
+  static inline bool find(Args &&...args) {
+    return trie_find<T, Filter, Comparer, Policy>(
+      static_cast<Args &&>(args)...
+    );
+  }
+};
+
 } // namespace fatal {